@@ -0,0 +1,793 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+/*
+ * Benchmark of the Shape and Label representations.
+ *
+ * Scenes are built programmatically, one per case, with a 3D view and an
+ * axial slice view. Representations are updated through UpdateFromMRML on
+ * renderers of window-less OpenGL render windows; nothing is rendered.
+ *
+ * Usage : ExtraMarkupsBenchmark [output.json] [repetitions] [Shape|Label|Storage|Scene]
+ *         ExtraMarkupsBenchmark --compare before.json after.json
+ *
+ * For each case and phase, the median wall time, the number of heap
+ * allocations of the median run and the number of output cells are written
+ * as JSON, for comparison with a baseline. Storage cases also report the
+ * file size in bytes. The scene import case loads a scene of shapes through
+ * the Shape module logic, the label creation cases compare the creation of
+ * labels one by one with AddLabels, and the label table cases export labels
+ * to CSV and TSV and import them back. The allocation count relies on the
+ * replacement of the global operator new below; it covers the shared
+ * libraries on Linux and macOS only.
+ *
+ * The last argument runs the cases of one group only. A change is measured
+ * by running its group on builds of the revisions before and after it, and
+ * comparing the entries of the same name : --compare prints, for each entry
+ * of both files, the wall times and allocations and their relative change.
+ */
+
+// Shape includes
+#include <vtkMRMLMarkupsShapeJsonStorageNode.h>
+#include <vtkMRMLMarkupsShapeNode.h>
+#include <vtkSlicerShapeLogic.h>
+#include <vtkSlicerShapeWidget.h>
+
+// Label includes
+#include <vtkMRMLMarkupsLabelNode.h>
+#include <vtkSlicerLabelLogic.h>
+#include <vtkSlicerLabelWidget.h>
+
+// Markups includes
+#include <vtkSlicerMarkupsLogic.h>
+
+// MRML includes
+#include <vtkMRMLAbstractWidgetRepresentation.h>
+#include <vtkMRMLApplicationLogic.h>
+#include <vtkMRMLMarkupsDisplayNode.h>
+#include <vtkMRMLMeasurement.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkActor2D.h>
+#include <vtkCommand.h>
+#include <vtkDataSet.h>
+#include <vtkGenericOpenGLRenderWindow.h>
+#include <vtkMapper.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper2D.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkVector.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+static std::atomic<unsigned long long> AllocationCount(0);
+
+void* operator new(std::size_t size)
+{
+  AllocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void * memory = std::malloc(size ? size : 1))
+  {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+namespace
+{
+
+struct BenchmarkResult
+{
+  std::string Name;
+  double WallTime = 0.0; // Milliseconds, median of the repetitions.
+  unsigned long long Allocations = 0;
+  vtkIdType Cells = 0;
+  unsigned long Bytes = 0; // File size of the storage cases.
+};
+
+//----------------------------------------------------------------------------
+// A scene with one 3D view and one axial slice view, and the widgets of its markups.
+class BenchmarkScene
+{
+public:
+  BenchmarkScene()
+  {
+    this->Scene->AddNode(this->ViewNode);
+    this->SliceNode->SetName("Red");
+    this->SliceNode->SetLayoutName("Red");
+    this->Scene->AddNode(this->SliceNode);
+    this->SliceNode->SetOrientationToAxial();
+    this->SliceNode->SetDimensions(512, 512, 1);
+    this->SliceNode->SetFieldOfView(250.0, 250.0, 1.0);
+    this->SliceNode->UpdateMatrices();
+
+    this->RenderWindow3D->SetSize(512, 512);
+    this->RenderWindow3D->AddRenderer(this->Renderer3D);
+    this->RenderWindow2D->SetSize(512, 512);
+    this->RenderWindow2D->AddRenderer(this->Renderer2D);
+  }
+
+  vtkMRMLScene * GetScene() { return this->Scene; }
+  vtkMRMLSliceNode * GetSliceNode() { return this->SliceNode; }
+
+  // Add the node with a display node and create its 3D and 2D representations.
+  void AddMarkups(vtkMRMLMarkupsNode * node, vtkSlicerMarkupsWidget * widget3D, vtkSlicerMarkupsWidget * widget2D)
+  {
+    vtkNew<vtkMRMLMarkupsDisplayNode> displayNode;
+    this->Scene->AddNode(displayNode);
+    node->SetAndObserveDisplayNodeID(displayNode->GetID());
+    widget3D->CreateDefaultRepresentation(displayNode, this->ViewNode, this->Renderer3D);
+    widget2D->CreateDefaultRepresentation(displayNode, this->SliceNode, this->Renderer2D);
+    this->Nodes.push_back(node);
+    this->Widgets3D.push_back(widget3D);
+    this->Widgets2D.push_back(widget2D);
+  }
+
+  // Move the first control point of each node a little, so that the next update regenerates.
+  void Perturb()
+  {
+    this->Perturbation = -this->Perturbation;
+    for (vtkMRMLMarkupsNode * node : this->Nodes)
+    {
+      double position[3] = { 0.0 };
+      node->GetNthControlPointPosition(0, position);
+      position[0] += this->Perturbation;
+      node->SetNthControlPointPosition(0, position[0], position[1], position[2]);
+    }
+  }
+
+  vtkIdType Update(bool is3D)
+  {
+    vtkIdType cells = 0;
+    for (size_t i = 0; i < this->Nodes.size(); i++)
+    {
+      vtkMRMLAbstractWidgetRepresentation * representation
+        = (is3D ? this->Widgets3D[i] : this->Widgets2D[i])->GetRepresentation();
+      representation->UpdateFromMRML(this->Nodes[i], vtkCommand::ModifiedEvent);
+      cells += BenchmarkScene::CountCells(representation);
+    }
+    return cells;
+  }
+
+  // Update all 2D representations at each of 'steps' slice offsets.
+  vtkIdType ScrollSlice(int steps)
+  {
+    vtkIdType cells = 0;
+    for (int step = 0; step < steps; step++)
+    {
+      this->SliceNode->SetSliceOffset(-50.0 + 100.0 * step / std::max(steps - 1, 1));
+      for (vtkSlicerMarkupsWidget * widget : this->Widgets2D)
+      {
+        vtkMRMLAbstractWidgetRepresentation * representation = widget->GetRepresentation();
+        representation->UpdateFromMRML(this->SliceNode, vtkCommand::ModifiedEvent);
+        cells += BenchmarkScene::CountCells(representation);
+      }
+    }
+    return cells;
+  }
+
+  vtkIdType UpdateMeasurements()
+  {
+    vtkIdType measurements = 0;
+    for (vtkMRMLMarkupsNode * node : this->Nodes)
+    {
+      for (int i = 0; i < node->GetNumberOfMeasurements(); i++)
+      {
+        node->GetNthMeasurement(i)->SetEnabled(true);
+      }
+      node->UpdateAllMeasurements();
+      measurements += node->GetNumberOfMeasurements();
+    }
+    return measurements;
+  }
+
+  // Cells of the visible actors of a representation.
+  static vtkIdType CountCells(vtkMRMLAbstractWidgetRepresentation * representation)
+  {
+    vtkNew<vtkPropCollection> props;
+    representation->GetActors(props);
+    vtkIdType cells = 0;
+    props->InitTraversal();
+    while (vtkProp * prop = props->GetNextProp())
+    {
+      if (!prop->GetVisibility())
+      {
+        continue;
+      }
+      vtkActor * actor = vtkActor::SafeDownCast(prop);
+      vtkActor2D * actor2D = vtkActor2D::SafeDownCast(prop);
+      vtkDataSet * data = nullptr;
+      if (actor && actor->GetMapper())
+      {
+        data = actor->GetMapper()->GetInput();
+      }
+      else if (actor2D && vtkPolyDataMapper2D::SafeDownCast(actor2D->GetMapper()))
+      {
+        data = vtkPolyDataMapper2D::SafeDownCast(actor2D->GetMapper())->GetInput();
+      }
+      cells += data ? data->GetNumberOfCells() : 0;
+    }
+    return cells;
+  }
+
+private:
+  vtkNew<vtkMRMLScene> Scene;
+  vtkNew<vtkMRMLViewNode> ViewNode;
+  vtkNew<vtkMRMLSliceNode> SliceNode;
+  vtkNew<vtkGenericOpenGLRenderWindow> RenderWindow3D;
+  vtkNew<vtkRenderer> Renderer3D;
+  vtkNew<vtkGenericOpenGLRenderWindow> RenderWindow2D;
+  vtkNew<vtkRenderer> Renderer2D;
+
+  std::vector<vtkSmartPointer<vtkMRMLMarkupsNode>> Nodes;
+  std::vector<vtkSmartPointer<vtkSlicerMarkupsWidget>> Widgets3D;
+  std::vector<vtkSmartPointer<vtkSlicerMarkupsWidget>> Widgets2D;
+  double Perturbation = 0.01;
+};
+
+//----------------------------------------------------------------------------
+BenchmarkResult Run(const std::string& name, int repetitions, const std::function<vtkIdType()>& body)
+{
+  std::vector<std::pair<double, unsigned long long>> runs;
+  vtkIdType cells = 0;
+  for (int i = 0; i < repetitions; i++)
+  {
+    const unsigned long long allocations = AllocationCount.load();
+    const auto start = std::chrono::steady_clock::now();
+    cells = body();
+    const auto end = std::chrono::steady_clock::now();
+    runs.emplace_back(std::chrono::duration<double, std::milli>(end - start).count(),
+                      AllocationCount.load() - allocations);
+  }
+  std::sort(runs.begin(), runs.end());
+  BenchmarkResult result;
+  result.Name = name;
+  result.WallTime = runs[runs.size() / 2].first;
+  result.Allocations = runs[runs.size() / 2].second;
+  result.Cells = cells;
+  std::cerr << name << " : " << result.WallTime << " ms" << std::endl;
+  return result;
+}
+
+//----------------------------------------------------------------------------
+// Run the update, slice scrolling and, for shapes, measurement phases of a scene.
+void RunPhases(BenchmarkScene& scene, const std::string& name, int repetitions,
+               bool measure, std::vector<BenchmarkResult>& results)
+{
+  results.push_back(Run(name + "/Update3D", repetitions,
+    [&scene]() { scene.Perturb(); return scene.Update(true); }));
+  results.push_back(Run(name + "/Update2D", repetitions,
+    [&scene]() { scene.Perturb(); return scene.Update(false); }));
+  results.push_back(Run(name + "/SliceScroll", repetitions,
+    [&scene]() { return scene.ScrollSlice(20); }));
+  if (measure)
+  {
+    results.push_back(Run(name + "/Measurement", repetitions,
+      [&scene]() { scene.Perturb(); return scene.UpdateMeasurements(); }));
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkMRMLMarkupsShapeNode> AddShape(BenchmarkScene& scene, int shapeName, double resolution)
+{
+  vtkSmartPointer<vtkMRMLMarkupsShapeNode> shapeNode = vtkSmartPointer<vtkMRMLMarkupsShapeNode>::New();
+  scene.GetScene()->AddNode(shapeNode);
+  shapeNode->SetShapeName(shapeName);
+  shapeNode->SetResolution(resolution);
+  return shapeNode;
+}
+
+//----------------------------------------------------------------------------
+// Pairs of points across a helical tube of varying radius.
+void BenchmarkTube(int numberOfControlPoints, int repetitions, std::vector<BenchmarkResult>& results)
+{
+  BenchmarkScene scene;
+  vtkSmartPointer<vtkMRMLMarkupsShapeNode> shapeNode = AddShape(scene, vtkMRMLMarkupsShapeNode::Tube, 20.0);
+  for (int pair = 0; pair < numberOfControlPoints / 2; pair++)
+  {
+    const double angle = 0.1 * pair;
+    const double radius = 3.0 + std::sin(0.5 * pair);
+    const double center[3] = { 50.0 * std::cos(angle), 50.0 * std::sin(angle), 0.5 * pair - 25.0 };
+    const double direction[3] = { std::cos(angle), std::sin(angle), 0.0 };
+    shapeNode->AddControlPoint(vtkVector3d(center[0] - radius * direction[0], center[1] - radius * direction[1], center[2]));
+    shapeNode->AddControlPoint(vtkVector3d(center[0] + radius * direction[0], center[1] + radius * direction[1], center[2]));
+  }
+  scene.AddMarkups(shapeNode, vtkNew<vtkSlicerShapeWidget>(), vtkNew<vtkSlicerShapeWidget>());
+  RunPhases(scene, "Shape/Tube/" + std::to_string(numberOfControlPoints), repetitions, true, results);
+}
+
+//----------------------------------------------------------------------------
+void BenchmarkShape(int shapeName, double resolution, int repetitions, std::vector<BenchmarkResult>& results)
+{
+  // Enough non-degenerate points for all shapes; parametric shapes use 4.
+  const double points[4][3] = { { 0.0, 0.0, 0.0 }, { 20.0, 0.0, 5.0 }, { 0.0, 15.0, 0.0 }, { 0.0, 0.0, 10.0 } };
+  BenchmarkScene scene;
+  vtkSmartPointer<vtkMRMLMarkupsShapeNode> shapeNode = AddShape(scene, shapeName, resolution);
+  const int numberOfControlPoints = shapeNode->GetRequiredNumberOfControlPoints();
+  for (int i = 0; i < numberOfControlPoints && i < 4; i++)
+  {
+    shapeNode->AddControlPoint(vtkVector3d(points[i][0], points[i][1], points[i][2]));
+  }
+  scene.AddMarkups(shapeNode, vtkNew<vtkSlicerShapeWidget>(), vtkNew<vtkSlicerShapeWidget>());
+  std::ostringstream name;
+  name << "Shape/" << vtkMRMLMarkupsShapeNode::GetShapeNameAsString(shapeName) << "/" << resolution;
+  RunPhases(scene, name.str(), repetitions, true, results);
+}
+
+//----------------------------------------------------------------------------
+// Write and read back a Tube through the JSON storage node, in the given control point encoding.
+void BenchmarkStorage(int numberOfControlPoints, bool compact, bool compress, int repetitions,
+                      std::vector<BenchmarkResult>& results)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsShapeNode> shapeNode;
+  scene->AddNode(shapeNode);
+  shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Tube);
+  for (int pair = 0; pair < numberOfControlPoints / 2; pair++)
+  {
+    const double angle = 0.01 * pair;
+    const double radius = 3.0 + std::sin(0.05 * pair);
+    const double center[3] = { 50.0 * std::cos(angle), 50.0 * std::sin(angle), 0.05 * pair - 125.0 };
+    shapeNode->AddControlPoint(vtkVector3d(center[0] - radius * std::cos(angle), center[1] - radius * std::sin(angle), center[2]));
+    shapeNode->AddControlPoint(vtkVector3d(center[0] + radius * std::cos(angle), center[1] + radius * std::sin(angle), center[2]));
+  }
+  const std::string encoding = compact ? (compress ? "CompactZlib" : "Compact") : "Verbose";
+  const std::string fileName = "ExtraMarkupsBenchmark-" + encoding + ".mrk.json";
+  vtkNew<vtkMRMLMarkupsShapeJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetCompactControlPoints(compact);
+  storageNode->SetCompressControlPoints(compress);
+
+  const std::string name = "Storage/Tube/" + std::to_string(numberOfControlPoints) + "/" + encoding;
+  BenchmarkResult writeResult = Run(name + "/Write", repetitions,
+    [&storageNode, &shapeNode]() { return storageNode->WriteData(shapeNode) ? shapeNode->GetNumberOfControlPoints() : 0; });
+  writeResult.Bytes = vtksys::SystemTools::FileLength(fileName);
+  results.push_back(writeResult);
+  BenchmarkResult readResult = Run(name + "/Read", repetitions,
+    [&storageNode, &scene]()
+    {
+      vtkNew<vtkMRMLMarkupsShapeNode> readNode;
+      scene->AddNode(readNode);
+      const vtkIdType numberOfReadControlPoints = storageNode->ReadData(readNode) ? readNode->GetNumberOfControlPoints() : 0;
+      scene->RemoveNode(readNode);
+      return numberOfReadControlPoints;
+    });
+  readResult.Bytes = writeResult.Bytes;
+  results.push_back(readResult);
+  vtksys::SystemTools::RemoveFile(fileName);
+}
+
+//----------------------------------------------------------------------------
+// A scene managed by the Markups module logic and the logic of an extension module.
+class LogicScene
+{
+public:
+  LogicScene(const char * moduleName, vtkSlicerMarkupsLogic * moduleLogic)
+  {
+    this->ApplicationLogic->SetMRMLScene(this->Scene);
+    this->AddLogic("Markups", this->MarkupsLogic);
+    this->AddLogic(moduleName, moduleLogic);
+  }
+
+  vtkMRMLScene * GetScene() { return this->Scene; }
+
+private:
+  void AddLogic(const char * moduleName, vtkSlicerMarkupsLogic * logic)
+  {
+    logic->SetMRMLApplicationLogic(this->ApplicationLogic);
+    this->ApplicationLogic->SetModuleLogic(moduleName, logic);
+    logic->SetMRMLScene(this->Scene);
+  }
+
+  vtkNew<vtkMRMLScene> Scene;
+  vtkNew<vtkMRMLApplicationLogic> ApplicationLogic;
+  vtkNew<vtkSlicerMarkupsLogic> MarkupsLogic;
+};
+
+//----------------------------------------------------------------------------
+// Import a scene of shapes of all kinds, each in its own JSON file, with the Shape module logic.
+void BenchmarkSceneImport(int numberOfShapes, int repetitions, std::vector<BenchmarkResult>& results)
+{
+  const std::string directory = vtksys::SystemTools::CollapseFullPath("ExtraMarkupsBenchmark-Scene");
+  const std::string sceneFileName = directory + "/Scene.mrml";
+  vtksys::SystemTools::MakeDirectory(directory);
+  {
+    const double points[4][3] = { { 0.0, 0.0, 0.0 }, { 20.0, 0.0, 5.0 }, { 0.0, 15.0, 0.0 }, { 0.0, 0.0, 10.0 } };
+    const int numberOfShapeNames = vtkMRMLMarkupsShapeNode::ShapeName_Last - vtkMRMLMarkupsShapeNode::Sphere;
+    vtkNew<vtkMRMLScene> scene;
+    scene->SetRootDirectory(directory.c_str());
+    scene->SetURL(sceneFileName.c_str());
+    for (int i = 0; i < numberOfShapes; i++)
+    {
+      vtkNew<vtkMRMLMarkupsShapeNode> shapeNode;
+      scene->AddNode(shapeNode);
+      shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Sphere + i % numberOfShapeNames);
+      const int numberOfControlPoints = shapeNode->GetRequiredNumberOfControlPoints();
+      for (int j = 0; j < numberOfControlPoints && j < 4; j++)
+      {
+        shapeNode->AddControlPoint(vtkVector3d(points[j][0] + i, points[j][1], points[j][2]));
+      }
+      vtkNew<vtkMRMLMarkupsDisplayNode> displayNode;
+      scene->AddNode(displayNode);
+      shapeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+      vtkNew<vtkMRMLMarkupsShapeJsonStorageNode> storageNode;
+      scene->AddNode(storageNode);
+      const std::string fileName = directory + "/Shape_" + std::to_string(i) + ".mrk.json";
+      storageNode->SetFileName(fileName.c_str());
+      storageNode->WriteData(shapeNode);
+      shapeNode->SetAndObserveStorageNodeID(storageNode->GetID());
+    }
+    scene->Commit();
+  }
+
+  vtkNew<vtkSlicerShapeLogic> shapeLogic;
+  LogicScene logicScene("Shape", shapeLogic);
+  vtkMRMLScene * scene = logicScene.GetScene();
+  results.push_back(Run("Scene/Import/" + std::to_string(numberOfShapes), repetitions,
+    [scene, &sceneFileName]()
+    {
+      scene->Clear(false);
+      scene->SetURL(sceneFileName.c_str());
+      scene->Import();
+      return static_cast<vtkIdType>(scene->GetNumberOfNodesByClass("vtkMRMLMarkupsShapeNode"));
+    }));
+  scene->Clear(false);
+  vtksys::SystemTools::RemoveADirectory(directory);
+}
+
+//----------------------------------------------------------------------------
+// Texts around a circle, pointing outwards.
+void CircleOfLabels(int numberOfLabels, vtkPoints * positions, vtkPoints * targetPositions)
+{
+  for (int i = 0; i < numberOfLabels; i++)
+  {
+    const double angle = 2.0 * vtkMath::Pi() * i / numberOfLabels;
+    positions->InsertNextPoint(40.0 * std::cos(angle), 40.0 * std::sin(angle), (i % 20) - 10.0);
+    targetPositions->InsertNextPoint(60.0 * std::cos(angle), 60.0 * std::sin(angle), (i % 20) - 10.0);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Create labels with default texts one by one, as interactively, or with a single AddLabels call.
+void BenchmarkLabelCreation(int numberOfLabels, bool bulk, int repetitions, std::vector<BenchmarkResult>& results)
+{
+  vtkNew<vtkSlicerLabelLogic> labelLogic;
+  LogicScene logicScene("Label", labelLogic);
+  vtkMRMLScene * scene = logicScene.GetScene();
+  vtkNew<vtkPoints> positions;
+  vtkNew<vtkPoints> targetPositions;
+  CircleOfLabels(numberOfLabels, positions, targetPositions);
+
+  const std::string name = "Label/Create/" + std::to_string(numberOfLabels) + (bulk ? "/Bulk" : "/Single");
+  results.push_back(Run(name, repetitions,
+    [&]()
+    {
+      scene->Clear(false);
+      if (bulk)
+      {
+        return static_cast<vtkIdType>(labelLogic->AddLabels(positions, targetPositions));
+      }
+      for (int i = 0; i < numberOfLabels; i++)
+      {
+        vtkNew<vtkMRMLMarkupsLabelNode> labelNode;
+        labelNode->AddControlPoint(vtkVector3d(positions->GetPoint(i)));
+        labelNode->AddControlPoint(vtkVector3d(targetPositions->GetPoint(i)));
+        labelNode->SetName(scene->GenerateUniqueName(labelNode->GetDefaultNodeNamePrefix()).c_str());
+        scene->AddNode(labelNode);
+        labelLogic->AddNewDisplayNodeForMarkupsNode(labelNode);
+      }
+      return static_cast<vtkIdType>(numberOfLabels);
+    }));
+  scene->Clear(false);
+}
+
+//----------------------------------------------------------------------------
+// Export labels to a CSV or TSV file and import them back, streamed or memory mapped.
+void BenchmarkLabelTable(int numberOfLabels, bool tabSeparated, int repetitions, std::vector<BenchmarkResult>& results)
+{
+  vtkNew<vtkSlicerLabelLogic> labelLogic;
+  LogicScene logicScene("Label", labelLogic);
+  vtkMRMLScene * scene = logicScene.GetScene();
+  vtkNew<vtkPoints> positions;
+  vtkNew<vtkPoints> targetPositions;
+  CircleOfLabels(numberOfLabels, positions, targetPositions);
+  vtkNew<vtkStringArray> texts;
+  for (int i = 0; i < numberOfLabels; i++)
+  {
+    texts->InsertNextValue("Nodule " + std::to_string(i) + (i % 10 ? "" : ", \"second\" line\nof text"));
+  }
+  labelLogic->AddLabels(positions, targetPositions, texts);
+
+  const std::string format = tabSeparated ? "TSV" : "CSV";
+  const std::string fileName = "ExtraMarkupsBenchmark-Labels." + format;
+  const std::string name = "Label/Table/" + std::to_string(numberOfLabels) + "/" + format;
+  BenchmarkResult writeResult = Run(name + "/Export", repetitions,
+    [&]() { return labelLogic->ExportLabels(fileName.c_str()) ? static_cast<vtkIdType>(numberOfLabels) : 0; });
+  writeResult.Bytes = vtksys::SystemTools::FileLength(fileName);
+  results.push_back(writeResult);
+  for (bool memoryMapped : { false, true })
+  {
+    BenchmarkResult readResult = Run(name + (memoryMapped ? "/ImportMapped" : "/Import"), repetitions,
+      [&]()
+      {
+        scene->Clear(false);
+        return static_cast<vtkIdType>(labelLogic->ImportLabels(fileName.c_str(), memoryMapped));
+      });
+    std::cerr << readResult.Name << " : " << labelLogic->GetLastImportRate() << " labels/s" << std::endl;
+    readResult.Bytes = writeResult.Bytes;
+    results.push_back(readResult);
+  }
+  scene->Clear(false);
+  vtksys::SystemTools::RemoveFile(fileName);
+}
+
+//----------------------------------------------------------------------------
+void BenchmarkLabels(int numberOfLabels, int repetitions, std::vector<BenchmarkResult>& results)
+{
+  BenchmarkScene scene;
+  for (int i = 0; i < numberOfLabels; i++)
+  {
+    vtkNew<vtkMRMLMarkupsLabelNode> labelNode;
+    scene.GetScene()->AddNode(labelNode);
+    const double angle = 2.0 * vtkMath::Pi() * i / numberOfLabels;
+    const double tip[3] = { 40.0 * std::cos(angle), 40.0 * std::sin(angle), (i % 20) - 10.0 };
+    labelNode->AddControlPoint(vtkVector3d(tip[0], tip[1], tip[2]));
+    labelNode->AddControlPoint(vtkVector3d(1.5 * tip[0], 1.5 * tip[1], tip[2]));
+    labelNode->SetLabel(("Label " + std::to_string(i)).c_str());
+    scene.AddMarkups(labelNode, vtkNew<vtkSlicerLabelWidget>(), vtkNew<vtkSlicerLabelWidget>());
+  }
+  RunPhases(scene, "Label/" + std::to_string(numberOfLabels), repetitions, false, results);
+}
+
+//----------------------------------------------------------------------------
+void WriteResults(std::ostream& stream, const std::vector<BenchmarkResult>& results)
+{
+  stream << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const BenchmarkResult& result = results[i];
+    stream << "    {\"name\": \"" << result.Name << "\", \"wallTimeMs\": " << result.WallTime
+           << ", \"allocations\": " << result.Allocations << ", \"cells\": " << result.Cells;
+    if (result.Bytes)
+    {
+      stream << ", \"bytes\": " << result.Bytes;
+    }
+    stream << "}"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  stream << "  ]\n}\n";
+}
+
+//----------------------------------------------------------------------------
+// The value following '"key": ' in 'line', if any.
+bool ReadField(const std::string& line, const std::string& key, std::string& value)
+{
+  const std::string prefix = "\"" + key + "\": ";
+  size_t begin = line.find(prefix);
+  if (begin == std::string::npos)
+  {
+    return false;
+  }
+  begin += prefix.size();
+  if (line[begin] == '"')
+  {
+    const size_t end = line.find('"', begin + 1);
+    value = line.substr(begin + 1, end == std::string::npos ? std::string::npos : end - begin - 1);
+    return end != std::string::npos;
+  }
+  value = line.substr(begin, line.find_first_of(",}", begin) - begin);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Results by name, from a file written by WriteResults() : one entry per line.
+bool ReadResults(const std::string& fileName, std::map<std::string, BenchmarkResult>& results)
+{
+  std::ifstream file(fileName.c_str());
+  if (!file.is_open())
+  {
+    std::cerr << "Cannot read " << fileName << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line))
+  {
+    BenchmarkResult result;
+    std::string wallTime;
+    std::string allocations;
+    if (!ReadField(line, "name", result.Name) || !ReadField(line, "wallTimeMs", wallTime)
+      || !ReadField(line, "allocations", allocations))
+    {
+      continue;
+    }
+    result.WallTime = std::atof(wallTime.c_str());
+    result.Allocations = std::strtoull(allocations.c_str(), nullptr, 10);
+    results[result.Name] = result;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Relative change from 'before' to 'after', in percent.
+std::string FormatChange(double before, double after)
+{
+  if (before == 0.0)
+  {
+    return "-";
+  }
+  std::ostringstream change;
+  change << std::showpos << std::fixed << std::setprecision(1) << (after - before) * 100.0 / before << "%";
+  return change.str();
+}
+
+//----------------------------------------------------------------------------
+// Print the entries found in both files, tab separated.
+int CompareResults(const std::string& beforeFile, const std::string& afterFile)
+{
+  std::map<std::string, BenchmarkResult> before;
+  std::map<std::string, BenchmarkResult> after;
+  if (!ReadResults(beforeFile, before) || !ReadResults(afterFile, after))
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "name\tbeforeMs\tafterMs\twallTime\tbeforeAllocations\tafterAllocations\tallocations\n";
+  int numberOfEntries = 0;
+  for (const auto& entry : before)
+  {
+    auto found = after.find(entry.first);
+    if (found == after.end())
+    {
+      continue;
+    }
+    const BenchmarkResult& b = entry.second;
+    const BenchmarkResult& a = found->second;
+    std::cout << b.Name << "\t" << b.WallTime << "\t" << a.WallTime << "\t" << FormatChange(b.WallTime, a.WallTime)
+              << "\t" << b.Allocations << "\t" << a.Allocations
+              << "\t" << FormatChange(static_cast<double>(b.Allocations), static_cast<double>(a.Allocations)) << "\n";
+    numberOfEntries++;
+  }
+  if (numberOfEntries == 0)
+  {
+    std::cerr << "No common entries in " << beforeFile << " and " << afterFile << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+  if (argc > 1 && std::string(argv[1]) == "--compare")
+  {
+    if (argc != 4)
+    {
+      std::cerr << "Usage : " << argv[0] << " --compare before.json after.json" << std::endl;
+      return EXIT_FAILURE;
+    }
+    return CompareResults(argv[2], argv[3]);
+  }
+  const std::string outputFile = argc > 1 ? argv[1] : "";
+  const int repetitions = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 5;
+  const std::string group = argc > 3 ? argv[3] : "";
+  auto selected = [&group](const char * name) { return group.empty() || group == name; };
+
+  std::vector<BenchmarkResult> results;
+  if (selected("Shape"))
+  {
+    for (int numberOfControlPoints : { 4, 40, 100, 400 })
+    {
+      BenchmarkTube(numberOfControlPoints, repetitions, results);
+    }
+    for (int shapeName = vtkMRMLMarkupsShapeNode::Sphere; shapeName < vtkMRMLMarkupsShapeNode::ShapeName_Last; shapeName++)
+    {
+      if (shapeName == vtkMRMLMarkupsShapeNode::Tube)
+      {
+        continue;
+      }
+      for (double resolution : { 16.0, 64.0, 256.0 })
+      {
+        BenchmarkShape(shapeName, resolution, repetitions, results);
+      }
+    }
+  }
+  if (selected("Label"))
+  {
+    for (int numberOfLabels : { 1, 10, 100, 1000 })
+    {
+      BenchmarkLabels(numberOfLabels, repetitions, results);
+    }
+    for (bool bulk : { false, true })
+    {
+      BenchmarkLabelCreation(5000, bulk, repetitions, results);
+    }
+    for (bool tabSeparated : { false, true })
+    {
+      BenchmarkLabelTable(20000, tabSeparated, repetitions, results);
+    }
+  }
+  if (selected("Storage"))
+  {
+    // Control points of a centreline sized Tube.
+    BenchmarkStorage(10000, false, false, repetitions, results);
+    BenchmarkStorage(10000, true, false, repetitions, results);
+    BenchmarkStorage(10000, true, true, repetitions, results);
+  }
+  if (selected("Scene"))
+  {
+    BenchmarkSceneImport(1000, repetitions, results);
+  }
+  if (results.empty())
+  {
+    std::cerr << "Unknown benchmark group " << group << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (outputFile.empty())
+  {
+    WriteResults(std::cout, results);
+    return EXIT_SUCCESS;
+  }
+  std::ofstream file(outputFile.c_str());
+  if (!file.is_open())
+  {
+    std::cerr << "Cannot write " << outputFile << std::endl;
+    return EXIT_FAILURE;
+  }
+  WriteResults(file, results);
+  return EXIT_SUCCESS;
+}
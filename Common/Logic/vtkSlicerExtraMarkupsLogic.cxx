@@ -0,0 +1,143 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerExtraMarkupsLogic.h"
+
+// ExtraMarkups MRML includes
+#include "vtkMRMLMarkupsProfiler.h"
+
+// VTK includes
+#include <vtkStringArray.h>
+
+//---------------------------------------------------------------------------
+vtkSlicerExtraMarkupsLogic::vtkSlicerExtraMarkupsLogic() = default;
+
+//---------------------------------------------------------------------------
+vtkSlicerExtraMarkupsLogic::~vtkSlicerExtraMarkupsLogic() = default;
+
+//---------------------------------------------------------------------------
+void vtkSlicerExtraMarkupsLogic::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Profiling: " << this->GetProfiling() << "\n";
+  os << indent << "ProfilingTrace: " << this->GetProfilingTrace() << "\n";
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerExtraMarkupsLogic::SetProfiling(bool enabled)
+{
+  if (vtkMRMLMarkupsProfiler::GetEnabled() == enabled)
+  {
+    return;
+  }
+  vtkMRMLMarkupsProfiler::SetEnabled(enabled);
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerExtraMarkupsLogic::GetProfiling() const
+{
+  return vtkMRMLMarkupsProfiler::GetEnabled();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerExtraMarkupsLogic::SetProfilingTrace(bool enabled)
+{
+  if (vtkMRMLMarkupsProfiler::GetTracing() == enabled)
+  {
+    return;
+  }
+  vtkMRMLMarkupsProfiler::SetTracing(enabled);
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerExtraMarkupsLogic::GetProfilingTrace() const
+{
+  return vtkMRMLMarkupsProfiler::GetTracing();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerExtraMarkupsLogic::GetProfiledNodeIDs(vtkStringArray * nodeIDs)
+{
+  if (!nodeIDs)
+  {
+    vtkErrorMacro("GetProfiledNodeIDs failed: invalid array");
+    return;
+  }
+  nodeIDs->Initialize();
+  for (const std::string& nodeID : vtkMRMLMarkupsProfiler::GetNodeIDs())
+  {
+    nodeIDs->InsertNextValue(nodeID);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerExtraMarkupsLogic::GetProfiledPhases(const char * nodeID, vtkStringArray * phases)
+{
+  if (!nodeID || !phases)
+  {
+    vtkErrorMacro("GetProfiledPhases failed: invalid node ID or array");
+    return;
+  }
+  phases->Initialize();
+  for (const std::string& phase : vtkMRMLMarkupsProfiler::GetPhases(nodeID))
+  {
+    phases->InsertNextValue(phase);
+  }
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerExtraMarkupsLogic::GetProfilingStatistics(const char * nodeID, const char * phase, double statistics[4])
+{
+  vtkMRMLMarkupsProfiler::Statistics phaseStatistics;
+  if (!nodeID || !phase || !vtkMRMLMarkupsProfiler::GetStatistics(nodeID, phase, phaseStatistics))
+  {
+    return false;
+  }
+  statistics[0] = static_cast<double>(phaseStatistics.Count);
+  statistics[1] = phaseStatistics.Total;
+  statistics[2] = phaseStatistics.Max;
+  statistics[3] = phaseStatistics.Last;
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerExtraMarkupsLogic::ResetProfiling()
+{
+  vtkMRMLMarkupsProfiler::Reset();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerExtraMarkupsLogic::WriteProfilingTrace(const char * fileName)
+{
+  if (!fileName || !vtkMRMLMarkupsProfiler::WriteChromeTrace(fileName))
+  {
+    vtkErrorMacro("WriteProfilingTrace failed: cannot write " << (fileName ? fileName : "(null)"));
+    return false;
+  }
+  const unsigned long droppedEvents = vtkMRMLMarkupsProfiler::GetNumberOfDroppedTraceEvents();
+  if (droppedEvents > 0)
+  {
+    vtkWarningMacro("WriteProfilingTrace: the trace was full, " << droppedEvents << " later events were dropped");
+  }
+  return true;
+}
+
@@ -0,0 +1,79 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkSlicerExtraMarkupslogic_h_
+#define __vtkSlicerExtraMarkupslogic_h_
+
+#include <vtkSlicerMarkupsLogic.h>
+
+#include "vtkSlicerExtraMarkupsModuleLogicExport.h"
+
+class vtkStringArray;
+
+/**
+ * @class   vtkSlicerExtraMarkupsLogic
+ * @brief   Base of the Label and Shape logics
+ *
+ * Exposes vtkMRMLMarkupsProfiler. There is a single profiler for both
+ * modules : enabling it from either logic times the nodes of both.
+*/
+class VTK_SLICER_EXTRAMARKUPS_MODULE_LOGIC_EXPORT vtkSlicerExtraMarkupsLogic:
+  public vtkSlicerMarkupsLogic
+{
+public:
+  vtkTypeMacro(vtkSlicerExtraMarkupsLogic, vtkSlicerMarkupsLogic);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /*
+   * Time the representation updates and measurements of each node, by phase.
+   * With tracing, each timed phase is also kept for WriteProfilingTrace().
+   * Both apply to all scenes; off by default.
+   */
+  void SetProfiling(bool enabled);
+  bool GetProfiling() const;
+  vtkBooleanMacro(Profiling, bool);
+  void SetProfilingTrace(bool enabled);
+  bool GetProfilingTrace() const;
+  vtkBooleanMacro(ProfilingTrace, bool);
+  // IDs of the profiled nodes, and the phases timed for one of them.
+  void GetProfiledNodeIDs(vtkStringArray * nodeIDs);
+  void GetProfiledPhases(const char * nodeID, vtkStringArray * phases);
+  /*
+   * Count, total, maximum and last duration in milliseconds of a phase of a node.
+   * Returns false if the phase has not been timed.
+   */
+  bool GetProfilingStatistics(const char * nodeID, const char * phase, double statistics[4]);
+  void ResetProfiling();
+  /*
+   * Write the traced phases as a Chrome trace (chrome://tracing, Perfetto).
+   * The trace keeps a bounded number of events; see vtkMRMLMarkupsProfiler.
+   */
+  bool WriteProfilingTrace(const char * fileName);
+
+protected:
+  vtkSlicerExtraMarkupsLogic();
+  ~vtkSlicerExtraMarkupsLogic() override;
+
+private:
+  vtkSlicerExtraMarkupsLogic(const vtkSlicerExtraMarkupsLogic&) = delete;
+  void operator=(const vtkSlicerExtraMarkupsLogic&) = delete;
+};
+
+#endif // __vtkSlicerExtraMarkupslogic_h_
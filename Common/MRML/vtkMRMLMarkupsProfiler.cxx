@@ -0,0 +1,220 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkMRMLMarkupsProfiler.h"
+
+// MRML includes
+#include <vtkMRMLNode.h>
+
+// STD includes
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+std::atomic<bool> vtkMRMLMarkupsProfiler::Enabled(false);
+std::atomic<bool> vtkMRMLMarkupsProfiler::Tracing(false);
+
+struct vtkMRMLMarkupsProfiler::State
+{
+  struct TraceEvent
+  {
+    std::string NodeID;
+    std::string Phase;
+    double Start = 0.0; // Microseconds since Origin.
+    double Duration = 0.0;
+    int ThreadID = 0;
+  };
+
+  std::mutex Mutex;
+  std::map<std::string, std::map<std::string, Statistics>> NodeStatistics;
+  std::vector<TraceEvent> TraceEvents;
+  unsigned long DroppedTraceEvents = 0;
+  // Small trace thread IDs, in order of appearance.
+  std::map<std::thread::id, int> ThreadIDs;
+  Clock::time_point Origin = Clock::now();
+};
+
+//------------------------------------------------------------------------------
+vtkMRMLMarkupsProfiler::State& vtkMRMLMarkupsProfiler::GetState()
+{
+  static State state;
+  return state;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLMarkupsProfiler::SetEnabled(bool enabled)
+{
+  vtkMRMLMarkupsProfiler::GetState(); // Not created concurrently by workers.
+  vtkMRMLMarkupsProfiler::Enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLMarkupsProfiler::SetTracing(bool tracing)
+{
+  vtkMRMLMarkupsProfiler::Tracing = tracing;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLMarkupsProfiler::Scope::Begin(vtkMRMLNode * node, const char * phase,
+                                          const char * detail)
+{
+  this->Active = true;
+  this->NodeID = (node && node->GetID()) ? node->GetID() : "";
+  this->Phase = phase ? phase : "";
+  if (detail)
+  {
+    this->Phase += std::string(":") + detail;
+  }
+  this->Start = Clock::now();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLMarkupsProfiler::Scope::End()
+{
+  vtkMRMLMarkupsProfiler::Record(this->NodeID, this->Phase, this->Start, Clock::now());
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLMarkupsProfiler::Record(const std::string& nodeID, const std::string& phase,
+                                    Clock::time_point start, Clock::time_point end)
+{
+  const double duration = std::chrono::duration<double, std::milli>(end - start).count();
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  Statistics& statistics = state.NodeStatistics[nodeID][phase];
+  statistics.Count++;
+  statistics.Total += duration;
+  statistics.Max = std::max(statistics.Max, duration);
+  statistics.Last = duration;
+  if (vtkMRMLMarkupsProfiler::GetTracing())
+  {
+    if (state.TraceEvents.size() >= MaximumNumberOfTraceEvents)
+    {
+      state.DroppedTraceEvents++;
+      return;
+    }
+    State::TraceEvent event;
+    event.NodeID = nodeID;
+    event.Phase = phase;
+    event.Start = std::chrono::duration<double, std::micro>(start - state.Origin).count();
+    event.Duration = duration * 1000.0;
+    auto threadID = state.ThreadIDs.emplace(std::this_thread::get_id(),
+                                            static_cast<int>(state.ThreadIDs.size()));
+    event.ThreadID = threadID.first->second;
+    state.TraceEvents.push_back(event);
+  }
+}
+
+//------------------------------------------------------------------------------
+unsigned long vtkMRMLMarkupsProfiler::GetNumberOfDroppedTraceEvents()
+{
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.DroppedTraceEvents;
+}
+
+//------------------------------------------------------------------------------
+std::vector<std::string> vtkMRMLMarkupsProfiler::GetNodeIDs()
+{
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  std::vector<std::string> nodeIDs;
+  for (const auto& nodeStatistics : state.NodeStatistics)
+  {
+    nodeIDs.push_back(nodeStatistics.first);
+  }
+  return nodeIDs;
+}
+
+//------------------------------------------------------------------------------
+std::vector<std::string> vtkMRMLMarkupsProfiler::GetPhases(const std::string& nodeID)
+{
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  std::vector<std::string> phases;
+  auto found = state.NodeStatistics.find(nodeID);
+  if (found != state.NodeStatistics.end())
+  {
+    for (const auto& phaseStatistics : found->second)
+    {
+      phases.push_back(phaseStatistics.first);
+    }
+  }
+  return phases;
+}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLMarkupsProfiler::GetStatistics(const std::string& nodeID, const std::string& phase,
+                                           Statistics& statistics)
+{
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  auto foundNode = state.NodeStatistics.find(nodeID);
+  if (foundNode == state.NodeStatistics.end())
+  {
+    return false;
+  }
+  auto foundPhase = foundNode->second.find(phase);
+  if (foundPhase == foundNode->second.end())
+  {
+    return false;
+  }
+  statistics = foundPhase->second;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLMarkupsProfiler::Reset()
+{
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.NodeStatistics.clear();
+  state.TraceEvents.clear();
+  state.DroppedTraceEvents = 0;
+  state.ThreadIDs.clear();
+}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLMarkupsProfiler::WriteChromeTrace(const std::string& fileName)
+{
+  std::ofstream file(fileName.c_str());
+  if (!file.is_open())
+  {
+    return false;
+  }
+  State& state = vtkMRMLMarkupsProfiler::GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  // Node IDs and phase names are plain identifiers; no escaping is needed.
+  file << "{\"traceEvents\": [\n";
+  for (size_t i = 0; i < state.TraceEvents.size(); i++)
+  {
+    const State::TraceEvent& event = state.TraceEvents[i];
+    file << "  {\"name\": \"" << event.Phase << "\", \"cat\": \"" << event.NodeID
+         << "\", \"ph\": \"X\", \"ts\": " << event.Start << ", \"dur\": " << event.Duration
+         << ", \"pid\": 1, \"tid\": " << event.ThreadID
+         << ", \"args\": {\"node\": \"" << event.NodeID << "\"}}"
+         << (i + 1 < state.TraceEvents.size() ? ",\n" : "\n");
+  }
+  file << "], \"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedEvents\": "
+       << state.DroppedTraceEvents << "}}\n";
+  return file.good();
+}
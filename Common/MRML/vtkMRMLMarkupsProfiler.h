@@ -0,0 +1,119 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkmrmlmarkupsprofiler_h_
+#define __vtkmrmlmarkupsprofiler_h_
+
+#include "vtkSlicerExtraMarkupsModuleMRMLExport.h"
+
+// STD includes
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+class vtkMRMLNode;
+
+/**
+ * @class   vtkMRMLMarkupsProfiler
+ * @brief   Aggregates the duration of timed phases by node
+ *
+ * A Scope times the block it is declared in. Durations are aggregated by
+ * node ID and phase name : count, total, maximum and last, in milliseconds.
+ * Scopes may end in worker threads. With tracing on, each scope is also kept
+ * as an event of a Chrome trace (chrome://tracing, Perfetto), up to
+ * MaximumNumberOfTraceEvents; later events are counted but dropped.
+ *
+ * Profiling is global, shared by the Label and Shape modules, and off by
+ * default; a Scope then only tests a flag. See vtkSlicerExtraMarkupsLogic.
+*/
+class VTK_SLICER_EXTRAMARKUPS_MODULE_MRML_EXPORT vtkMRMLMarkupsProfiler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Statistics
+  {
+    unsigned long Count = 0;
+    double Total = 0.0;
+    double Max = 0.0;
+    double Last = 0.0;
+  };
+
+  class VTK_SLICER_EXTRAMARKUPS_MODULE_MRML_EXPORT Scope
+  {
+  public:
+    // 'detail' is appended to the phase name, e.g. a measurement name.
+    Scope(vtkMRMLNode * node, const char * phase, const char * detail = nullptr)
+    {
+      if (vtkMRMLMarkupsProfiler::GetEnabled())
+      {
+        this->Begin(node, phase, detail);
+      }
+    }
+    ~Scope()
+    {
+      if (this->Active)
+      {
+        this->End();
+      }
+    }
+    Scope(const Scope&) = delete;
+    void operator=(const Scope&) = delete;
+
+  private:
+    void Begin(vtkMRMLNode * node, const char * phase, const char * detail);
+    void End();
+
+    bool Active = false;
+    std::string NodeID;
+    std::string Phase;
+    Clock::time_point Start;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled() { return Enabled.load(std::memory_order_relaxed); }
+  static void SetTracing(bool tracing);
+  static bool GetTracing() { return Tracing.load(std::memory_order_relaxed); }
+
+  // About 100 bytes each, once their strings are counted.
+  static constexpr size_t MaximumNumberOfTraceEvents = 1000000;
+  // Trace events dropped since the last Reset() because the trace was full.
+  static unsigned long GetNumberOfDroppedTraceEvents();
+
+  static std::vector<std::string> GetNodeIDs();
+  static std::vector<std::string> GetPhases(const std::string& nodeID);
+  static bool GetStatistics(const std::string& nodeID, const std::string& phase,
+                            Statistics& statistics);
+  // Forget all statistics and trace events.
+  static void Reset();
+  static bool WriteChromeTrace(const std::string& fileName);
+
+private:
+  static void Record(const std::string& nodeID, const std::string& phase,
+                     Clock::time_point start, Clock::time_point end);
+
+  struct State;
+  static State& GetState();
+  static std::atomic<bool> Enabled;
+  static std::atomic<bool> Tracing;
+};
+
+#endif // __vtkmrmlmarkupsprofiler_h_
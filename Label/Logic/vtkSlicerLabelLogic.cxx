@@ -26,8 +26,11 @@
 
 // Label VTKWidgets includes
 #include "vtkSlicerLabelWidget.h"
+#include "vtkSlicerLabelArrowInstancer.h"
+#include "vtkSlicerLabelHierarchyRenderer.h"
 
 // MRML includes
+#include <vtkMRMLAbstractViewNode.h>
 #include <vtkMRMLScene.h>
 
 // Markups logic includes
@@ -37,8 +40,388 @@
 #include <vtkMRMLMarkupsDisplayNode.h>
 
 // VTK includes
+#include <vtkCollection.h>
+#include <vtkMath.h>
 #include <vtkObjectFactory.h>
 #include <vtkMRMLColorTableNode.h>
+#include <vtkPoints.h>
+#include <vtkStringArray.h>
+#include <vtkTimerLog.h>
+#include <vtkVector.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <unordered_set>
+
+// Memory mapping includes
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <vtksys/Encoding.hxx>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+const char * DefaultLabel = "Label"; // Set by the label node constructor.
+
+//----------------------------------------------------------------------------
+/*
+ * Unique names for many nodes at once. vtkMRMLScene::GenerateUniqueName
+ * searches the scene for each candidate name; here the names in use are
+ * collected once. Names are built like the scene does : base, base_1, ...
+ */
+class UniqueNameGenerator
+{
+public:
+  explicit UniqueNameGenerator(const std::string& baseName) : BaseName(baseName) {}
+
+  void AddUsedName(const char * name)
+  {
+    if (name)
+    {
+      this->UsedNames.insert(name);
+    }
+  }
+
+  std::string Generate()
+  {
+    std::string name;
+    do
+    {
+      name = this->NextIndex ? this->BaseName + "_" + std::to_string(this->NextIndex) : this->BaseName;
+      this->NextIndex++;
+    } while (this->UsedNames.count(name));
+    this->UsedNames.insert(name);
+    return name;
+  }
+
+private:
+  std::string BaseName;
+  std::unordered_set<std::string> UsedNames;
+  int NextIndex = 0;
+};
+
+//----------------------------------------------------------------------------
+// Seed the generators of label texts and, if given, node names with those of the scene.
+void InitializeNameGenerators(vtkMRMLScene * scene, UniqueNameGenerator& labels, UniqueNameGenerator * nodeNames)
+{
+  vtkCollection * nodes = scene->GetNodes();
+  vtkCollectionSimpleIterator it;
+  vtkObject * object = nullptr;
+  for (nodes->InitTraversal(it); (object = nodes->GetNextItemAsObject(it));)
+  {
+    vtkMRMLNode * node = vtkMRMLNode::SafeDownCast(object);
+    if (!node)
+    {
+      continue;
+    }
+    if (nodeNames)
+    {
+      nodeNames->AddUsedName(node->GetName());
+    }
+    vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(node);
+    if (labelNode && labelNode->GetLabel() && std::string(labelNode->GetLabel()) != DefaultLabel)
+    {
+      labels.AddUsedName(labelNode->GetLabel());
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/*
+ * Incremental parser of delimited text. Data is fed in chunks of any size;
+ * each complete record is passed to the handler, which returns false to stop.
+ * With quoting (CSV), fields may be enclosed in double quotes and then hold
+ * delimiters, newlines and doubled quotes. Carriage returns outside quotes
+ * are ignored.
+ */
+class TableParser
+{
+public:
+  using RecordHandler = std::function<bool(std::vector<std::string>&)>;
+
+  TableParser(char delimiter, bool quoting, RecordHandler handler)
+    : Delimiter(delimiter), Quoting(quoting), Handler(std::move(handler)) {}
+
+  bool IsStopped() const { return this->Stopped; }
+
+  void Parse(const char * data, size_t size)
+  {
+    for (size_t i = 0; i < size && !this->Stopped; i++)
+    {
+      const char c = data[i];
+      if (this->InQuotes)
+      {
+        if (c != '"')
+        {
+          this->Field += c;
+          continue;
+        }
+        this->InQuotes = false;
+        this->QuoteClosed = true;
+        continue;
+      }
+      if (this->QuoteClosed && c == '"')
+      {
+        // Doubled quote in a quoted field.
+        this->Field += c;
+        this->InQuotes = true;
+        this->QuoteClosed = false;
+        continue;
+      }
+      this->QuoteClosed = false;
+      if (c == this->Delimiter)
+      {
+        this->EndField();
+      }
+      else if (c == '\n')
+      {
+        this->EndRecord();
+      }
+      else if (c == '\r')
+      {
+        continue;
+      }
+      else if (c == '"' && this->Quoting && this->Field.empty())
+      {
+        this->InQuotes = true;
+      }
+      else
+      {
+        this->Field += c;
+      }
+    }
+  }
+
+  // Pass the last record if the data does not end with a newline.
+  void Finish()
+  {
+    if (!this->Stopped && (!this->Field.empty() || !this->Record.empty()))
+    {
+      this->EndRecord();
+    }
+  }
+
+private:
+  void EndField()
+  {
+    this->Record.push_back(this->Field);
+    this->Field.clear();
+  }
+
+  void EndRecord()
+  {
+    this->EndField();
+    // Skip blank lines.
+    if (this->Record.size() > 1 || !this->Record[0].empty())
+    {
+      this->Stopped = !this->Handler(this->Record);
+    }
+    this->Record.clear();
+  }
+
+  char Delimiter;
+  bool Quoting;
+  RecordHandler Handler;
+  std::string Field;
+  std::vector<std::string> Record;
+  bool InQuotes = false;
+  bool QuoteClosed = false;
+  bool Stopped = false;
+};
+
+//----------------------------------------------------------------------------
+// A read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& fileName)
+  {
+#ifdef _WIN32
+    this->File = CreateFileW(vtksys::Encoding::ToWide(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if (this->File == INVALID_HANDLE_VALUE || !GetFileSizeEx(this->File, &size) || size.QuadPart == 0)
+    {
+      return;
+    }
+    this->Mapping = CreateFileMappingW(this->File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!this->Mapping)
+    {
+      return;
+    }
+    this->Data = static_cast<const char*>(MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0));
+    this->Size = this->Data ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+    const int descriptor = open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+      return;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+      void * data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (data != MAP_FAILED)
+      {
+        this->Data = static_cast<const char*>(data);
+        this->Size = static_cast<size_t>(status.st_size);
+      }
+    }
+    close(descriptor);
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifdef _WIN32
+    if (this->Data)
+    {
+      UnmapViewOfFile(this->Data);
+    }
+    if (this->Mapping)
+    {
+      CloseHandle(this->Mapping);
+    }
+    if (this->File != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(this->File);
+    }
+#else
+    if (this->Data)
+    {
+      munmap(const_cast<char*>(this->Data), this->Size);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  void operator=(const MappedFile&) = delete;
+
+  const char * GetData() const { return this->Data; }
+  size_t GetSize() const { return this->Size; }
+
+private:
+#ifdef _WIN32
+  HANDLE File = INVALID_HANDLE_VALUE;
+  HANDLE Mapping = nullptr;
+#endif
+  const char * Data = nullptr;
+  size_t Size = 0;
+};
+
+//----------------------------------------------------------------------------
+bool IsTabSeparated(const std::string& fileName)
+{
+  const std::string extension = vtksys::SystemTools::LowerCase(
+    vtksys::SystemTools::GetFilenameLastExtension(fileName));
+  return extension == ".tsv" || extension == ".tab";
+}
+
+//----------------------------------------------------------------------------
+std::string EscapeField(const std::string& text, bool tabSeparated)
+{
+  std::string escaped;
+  if (tabSeparated)
+  {
+    for (char c : text)
+    {
+      switch (c)
+      {
+        case '\\': escaped += "\\\\"; break;
+        case '\t': escaped += "\\t"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        default: escaped += c;
+      }
+    }
+    return escaped;
+  }
+  if (text.find_first_of(",\"\n\r") == std::string::npos)
+  {
+    return text;
+  }
+  escaped = "\"";
+  for (char c : text)
+  {
+    escaped += c;
+    if (c == '"')
+    {
+      escaped += '"';
+    }
+  }
+  return escaped + "\"";
+}
+
+//----------------------------------------------------------------------------
+std::string UnescapeTabSeparatedField(const std::string& text)
+{
+  if (text.find('\\') == std::string::npos)
+  {
+    return text;
+  }
+  std::string unescaped;
+  for (size_t i = 0; i < text.size(); i++)
+  {
+    if (text[i] != '\\' || i + 1 == text.size())
+    {
+      unescaped += text[i];
+      continue;
+    }
+    switch (text[++i])
+    {
+      case 't': unescaped += '\t'; break;
+      case 'n': unescaped += '\n'; break;
+      case 'r': unescaped += '\r'; break;
+      default: unescaped += text[i];
+    }
+  }
+  return unescaped;
+}
+
+//----------------------------------------------------------------------------
+bool ParseNumber(const std::vector<std::string>& fields, int column, double& value)
+{
+  if (column < 0 || column >= static_cast<int>(fields.size()))
+  {
+    return false;
+  }
+  const char * text = fields[column].c_str();
+  char * end = nullptr;
+  value = std::strtod(text, &end);
+  while (end != text && (*end == ' ' || *end == '\t'))
+  {
+    end++;
+  }
+  return end != text && *end == '\0';
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+struct vtkSlicerLabelLogic::LabelBatch
+{
+  explicit LabelBatch(const std::string& nodeNamePrefix) : NodeNames(nodeNamePrefix), Labels(DefaultLabel) {}
+
+  UniqueNameGenerator NodeNames;
+  UniqueNameGenerator Labels;
+  vtkMRMLColorTableNode * ColorTable = nullptr;
+};
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerLabelLogic);
@@ -56,6 +439,427 @@ vtkSlicerLabelLogic::~vtkSlicerLabelLogic() = default;
 void vtkSlicerLabelLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LabelHierarchy: " << this->GetLabelHierarchy() << "\n";
+  os << indent << "ArrowInstancing: " << this->GetArrowInstancing() << "\n";
+  os << indent << "LevelOfDetailGlyphOnlySize: " << this->GetLevelOfDetailGlyphOnlySize() << "\n";
+  os << indent << "LevelOfDetailHiddenSize: " << this->GetLevelOfDetailHiddenSize() << "\n";
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLabelLogic::SetLabelHierarchy(bool enabled)
+{
+  if (vtkSlicerLabelHierarchyRenderer::GetEnabled() == enabled)
+  {
+    return;
+  }
+  vtkSlicerLabelHierarchyRenderer::SetEnabled(enabled);
+  this->Modified();
+  // Let the representations switch between their own text actor and the label hierarchy.
+  this->UpdateLabelDisplayNodes();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerLabelLogic::GetLabelHierarchy() const
+{
+  return vtkSlicerLabelHierarchyRenderer::GetEnabled();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLabelLogic::SetArrowInstancing(bool enabled)
+{
+  if (vtkSlicerLabelArrowInstancer::GetEnabled() == enabled)
+  {
+    return;
+  }
+  vtkSlicerLabelArrowInstancer::SetEnabled(enabled);
+  this->Modified();
+  // Let the representations switch between their own arrow actors and the instancer.
+  this->UpdateLabelDisplayNodes();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerLabelLogic::GetArrowInstancing() const
+{
+  return vtkSlicerLabelArrowInstancer::GetEnabled();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLabelLogic::SetLevelOfDetailThresholds(double glyphOnlySize, double hiddenSize,
+                                                     vtkMRMLAbstractViewNode * viewNode)
+{
+  glyphOnlySize = std::max(glyphOnlySize, 0.0);
+  hiddenSize = std::max(hiddenSize, 0.0);
+  if (viewNode)
+  {
+    vtkSlicerLabelWidget::SetLevelOfDetailThresholds(viewNode, glyphOnlySize, hiddenSize);
+  }
+  else
+  {
+    if (this->LevelOfDetailThresholds[0] != glyphOnlySize || this->LevelOfDetailThresholds[1] != hiddenSize)
+    {
+      this->LevelOfDetailThresholds[0] = glyphOnlySize;
+      this->LevelOfDetailThresholds[1] = hiddenSize;
+      this->Modified();
+    }
+    vtkMRMLScene * scene = this->GetMRMLScene();
+    if (scene)
+    {
+      std::vector<vtkMRMLNode*> viewNodes;
+      scene->GetNodesByClass("vtkMRMLAbstractViewNode", viewNodes);
+      for (vtkMRMLNode * node : viewNodes)
+      {
+        vtkSlicerLabelWidget::SetLevelOfDetailThresholds(vtkMRMLAbstractViewNode::SafeDownCast(node),
+                                                         glyphOnlySize, hiddenSize);
+      }
+    }
+  }
+  // Let the representations read the thresholds of their view and observe their camera.
+  this->UpdateLabelDisplayNodes();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLabelLogic::UpdateLabelDisplayNodes()
+{
+  vtkMRMLScene * scene = this->GetMRMLScene();
+  if (!scene)
+  {
+    return;
+  }
+  // The markups displayable manager of each view updates the widgets of a modified display node, and renders.
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass("vtkMRMLMarkupsLabelNode", nodes);
+  for (vtkMRMLNode * node : nodes)
+  {
+    vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(node);
+    for (int i = 0; labelNode && i < labelNode->GetNumberOfDisplayNodes(); i++)
+    {
+      vtkMRMLDisplayNode * displayNode = labelNode->GetNthDisplayNode(i);
+      if (displayNode)
+      {
+        displayNode->Modified();
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+double vtkSlicerLabelLogic::GetLevelOfDetailGlyphOnlySize(vtkMRMLAbstractViewNode * viewNode) const
+{
+  if (!viewNode)
+  {
+    return this->LevelOfDetailThresholds[0];
+  }
+  double thresholds[2];
+  vtkSlicerLabelWidget::GetLevelOfDetailThresholds(viewNode, thresholds);
+  return thresholds[0];
+}
+
+//---------------------------------------------------------------------------
+double vtkSlicerLabelLogic::GetLevelOfDetailHiddenSize(vtkMRMLAbstractViewNode * viewNode) const
+{
+  if (!viewNode)
+  {
+    return this->LevelOfDetailThresholds[1];
+  }
+  double thresholds[2];
+  vtkSlicerLabelWidget::GetLevelOfDetailThresholds(viewNode, thresholds);
+  return thresholds[1];
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLabelLogic::BeginAddLabels()
+{
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  if (!scene || this->Batch)
+  {
+    vtkErrorMacro("BeginAddLabels failed: invalid scene or labels already being added");
+    return;
+  }
+  vtkNew<vtkMRMLMarkupsLabelNode> prototype;
+  this->Batch.reset(new LabelBatch(prototype->GetDefaultNodeNamePrefix()));
+  InitializeNameGenerators(scene, this->Batch->Labels, &this->Batch->NodeNames);
+  this->Batch->ColorTable = vtkMRMLColorTableNode::SafeDownCast(
+    scene->GetNodeByID(prototype->GetUseAlternateColors().c_str()));
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+}
+
+//---------------------------------------------------------------------------
+vtkMRMLMarkupsLabelNode * vtkSlicerLabelLogic::AddLabel(const double position[3], const double * targetPosition,
+                                                        const char * text)
+{
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  if (!scene || !this->Batch)
+  {
+    vtkErrorMacro("AddLabel failed: invalid scene or BeginAddLabels not called");
+    return nullptr;
+  }
+  vtkNew<vtkMRMLMarkupsLabelNode> labelNode;
+  labelNode->SetName(this->Batch->NodeNames.Generate().c_str());
+  labelNode->SetLabel((text && text[0]) ? text : this->Batch->Labels.Generate().c_str());
+  labelNode->AddControlPoint(vtkVector3d(position[0], position[1], position[2]));
+  if (targetPosition && !vtkMath::IsNan(targetPosition[0])
+    && !vtkMath::IsNan(targetPosition[1]) && !vtkMath::IsNan(targetPosition[2]))
+  {
+    labelNode->AddControlPoint(vtkVector3d(targetPosition[0], targetPosition[1], targetPosition[2]));
+  }
+  scene->AddNode(labelNode);
+  this->AddNewDisplayNodeForMarkupsNode(labelNode);
+  if (this->Batch->ColorTable && labelNode->GetDisplayNode())
+  {
+    double selectedColour[3] = { 1.0, 0.5, 0.5};
+    this->GenerateUniqueColor(selectedColour, this->Batch->ColorTable);
+    double colour[3] = { 1.0 - selectedColour[0], 1.0 - selectedColour[1], 1.0 - selectedColour[2]};
+    labelNode->GetDisplayNode()->SetSelectedColor(selectedColour);
+    labelNode->GetDisplayNode()->SetColor(colour);
+  }
+  return labelNode;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLabelLogic::EndAddLabels()
+{
+  if (!this->Batch)
+  {
+    return;
+  }
+  this->Batch.reset();
+  if (this->GetMRMLScene())
+  {
+    this->GetMRMLScene()->EndState(vtkMRMLScene::BatchProcessState);
+  }
+}
+
+//---------------------------------------------------------------------------
+int vtkSlicerLabelLogic::AddLabels(vtkPoints * positions, vtkPoints * targetPositions,
+                                   vtkStringArray * texts, vtkStringArray * nodeIDs)
+{
+  if (!this->GetMRMLScene())
+  {
+    vtkErrorMacro("AddLabels failed: invalid scene");
+    return 0;
+  }
+  if (!positions
+    || (targetPositions && targetPositions->GetNumberOfPoints() != positions->GetNumberOfPoints()))
+  {
+    vtkErrorMacro("AddLabels failed: invalid or unpaired positions");
+    return 0;
+  }
+  const vtkIdType numberOfLabels = positions->GetNumberOfPoints();
+  if (numberOfLabels == 0)
+  {
+    return 0;
+  }
+
+  int numberOfAddedLabels = 0;
+  this->BeginAddLabels();
+  for (vtkIdType i = 0; i < numberOfLabels; i++)
+  {
+    double position[3] = { 0.0 };
+    double targetPosition[3] = { 0.0 };
+    positions->GetPoint(i, position);
+    if (targetPositions)
+    {
+      targetPositions->GetPoint(i, targetPosition);
+    }
+    const char * text = (texts && i < texts->GetNumberOfValues()) ? texts->GetValue(i).c_str() : nullptr;
+    vtkMRMLMarkupsLabelNode * labelNode = this->AddLabel(position, targetPositions ? targetPosition : nullptr, text);
+    if (!labelNode)
+    {
+      break;
+    }
+    numberOfAddedLabels++;
+    if (nodeIDs)
+    {
+      nodeIDs->InsertNextValue(labelNode->GetID());
+    }
+  }
+  this->EndAddLabels();
+  return numberOfAddedLabels;
+}
+
+//---------------------------------------------------------------------------
+int vtkSlicerLabelLogic::ImportLabels(const char * fileName, bool memoryMapped)
+{
+  this->LastImportRate = 0.0;
+  if (!this->GetMRMLScene() || !fileName)
+  {
+    vtkErrorMacro("ImportLabels failed: invalid scene or file name");
+    return 0;
+  }
+  const double startTime = vtkTimerLog::GetUniversalTime();
+  const bool tabSeparated = IsTabSeparated(fileName);
+
+  enum { X = 0, Y, Z, TargetX, TargetY, TargetZ, Text, Column_Last };
+  const char * columnNames[Column_Last] = { "x", "y", "z", "targetx", "targety", "targetz", "text" };
+  int columns[Column_Last] = { -1, -1, -1, -1, -1, -1, -1 };
+  bool headerRead = false;
+  bool invalidHeader = false;
+  int numberOfLabels = 0;
+  int numberOfSkippedRows = 0;
+
+  this->BeginAddLabels();
+  TableParser parser(tabSeparated ? '\t' : ',', !tabSeparated,
+    [&](std::vector<std::string>& fields)
+    {
+      if (tabSeparated)
+      {
+        for (std::string& field : fields)
+        {
+          field = UnescapeTabSeparatedField(field);
+        }
+      }
+      if (!headerRead)
+      {
+        headerRead = true;
+        // Skip a UTF-8 byte order mark.
+        if (fields[0].compare(0, 3, "\xEF\xBB\xBF") == 0)
+        {
+          fields[0].erase(0, 3);
+        }
+        for (int i = 0; i < static_cast<int>(fields.size()); i++)
+        {
+          const std::string name = vtksys::SystemTools::LowerCase(vtksys::SystemTools::TrimWhitespace(fields[i]));
+          for (int column = 0; column < Column_Last; column++)
+          {
+            if (name == columnNames[column])
+            {
+              columns[column] = i;
+            }
+          }
+        }
+        invalidHeader = columns[X] < 0 || columns[Y] < 0 || columns[Z] < 0;
+        return !invalidHeader;
+      }
+      double position[3] = { 0.0 };
+      if (!ParseNumber(fields, columns[X], position[0]) || !ParseNumber(fields, columns[Y], position[1])
+        || !ParseNumber(fields, columns[Z], position[2]))
+      {
+        numberOfSkippedRows++;
+        return true;
+      }
+      double targetPosition[3] = { 0.0 };
+      const bool hasTarget = ParseNumber(fields, columns[TargetX], targetPosition[0])
+        && ParseNumber(fields, columns[TargetY], targetPosition[1])
+        && ParseNumber(fields, columns[TargetZ], targetPosition[2]);
+      const bool hasText = columns[Text] >= 0 && columns[Text] < static_cast<int>(fields.size());
+      if (!this->AddLabel(position, hasTarget ? targetPosition : nullptr,
+                          hasText ? fields[columns[Text]].c_str() : nullptr))
+      {
+        return false;
+      }
+      numberOfLabels++;
+      return true;
+    });
+
+  bool readable = true;
+  if (memoryMapped)
+  {
+    MappedFile file(fileName);
+    readable = file.GetData() != nullptr;
+    if (readable)
+    {
+      parser.Parse(file.GetData(), file.GetSize());
+    }
+  }
+  else
+  {
+    std::ifstream file(fileName, std::ios::binary);
+    readable = file.is_open();
+    std::vector<char> chunk(1 << 20);
+    while (readable && !parser.IsStopped() && file)
+    {
+      file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      parser.Parse(chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+  }
+  parser.Finish();
+  this->EndAddLabels();
+
+  if (!readable)
+  {
+    vtkErrorMacro("ImportLabels failed: cannot read " << fileName);
+    return numberOfLabels;
+  }
+  if (!headerRead || invalidHeader)
+  {
+    vtkErrorMacro("ImportLabels failed: the header of " << fileName << " does not name the x, y and z columns");
+    return numberOfLabels;
+  }
+  if (numberOfSkippedRows)
+  {
+    vtkWarningMacro("ImportLabels: " << numberOfSkippedRows << " rows with invalid positions skipped in " << fileName);
+  }
+  const double elapsed = vtkTimerLog::GetUniversalTime() - startTime;
+  this->LastImportRate = elapsed > 0.0 ? numberOfLabels / elapsed : 0.0;
+  vtkDebugMacro("ImportLabels: " << numberOfLabels << " labels in " << elapsed << " s ("
+                << this->LastImportRate << " labels/s)");
+  return numberOfLabels;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerLabelLogic::ExportLabels(const char * fileName, vtkStringArray * nodeIDs)
+{
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  if (!scene || !fileName)
+  {
+    vtkErrorMacro("ExportLabels failed: invalid scene or file name");
+    return false;
+  }
+  std::vector<vtkMRMLNode*> nodes;
+  if (nodeIDs)
+  {
+    for (vtkIdType i = 0; i < nodeIDs->GetNumberOfValues(); i++)
+    {
+      nodes.push_back(scene->GetNodeByID(nodeIDs->GetValue(i).c_str()));
+    }
+  }
+  else
+  {
+    scene->GetNodesByClass("vtkMRMLMarkupsLabelNode", nodes);
+  }
+
+  std::ofstream file(fileName, std::ios::binary);
+  if (!file.is_open())
+  {
+    vtkErrorMacro("ExportLabels failed: cannot write " << fileName);
+    return false;
+  }
+  const bool tabSeparated = IsTabSeparated(fileName);
+  const char delimiter = tabSeparated ? '\t' : ',';
+  file << std::setprecision(std::numeric_limits<double>::max_digits10);
+  file << "x" << delimiter << "y" << delimiter << "z" << delimiter << "targetX" << delimiter
+    << "targetY" << delimiter << "targetZ" << delimiter << "text\n";
+  for (vtkMRMLNode * node : nodes)
+  {
+    vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(node);
+    if (!labelNode || labelNode->GetNumberOfControlPoints() == 0)
+    {
+      continue;
+    }
+    // The text is at the label location, the target is the other point.
+    const int numberOfControlPoints = labelNode->GetNumberOfControlPoints();
+    const int labelLocation = numberOfControlPoints > 1 ? labelNode->GetLabelLocation() : 0;
+    double position[3] = { 0.0 };
+    labelNode->GetNthControlPointPositionWorld(labelLocation, position);
+    file << position[0] << delimiter << position[1] << delimiter << position[2] << delimiter;
+    if (numberOfControlPoints > 1)
+    {
+      double targetPosition[3] = { 0.0 };
+      labelNode->GetNthControlPointPositionWorld(1 - labelLocation, targetPosition);
+      file << targetPosition[0] << delimiter << targetPosition[1] << delimiter << targetPosition[2] << delimiter;
+    }
+    else
+    {
+      file << delimiter << delimiter << delimiter;
+    }
+    file << EscapeField(labelNode->GetLabel() ? labelNode->GetLabel() : "", tabSeparated) << "\n";
+  }
+  if (!file.good())
+  {
+    vtkErrorMacro("ExportLabels failed: cannot write " << fileName);
+    return false;
+  }
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -95,6 +899,18 @@ void vtkSlicerLabelLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
     vtkErrorMacro("OnMRMLSceneNodeAdded failed: invalid scene");
     return;
   }
+  // New views follow the thresholds set for all views, unless they keep their own.
+  vtkMRMLAbstractViewNode * viewNode = vtkMRMLAbstractViewNode::SafeDownCast(node);
+  if (viewNode)
+  {
+    if ((this->LevelOfDetailThresholds[0] > 0.0 || this->LevelOfDetailThresholds[1] > 0.0)
+      && !viewNode->GetAttribute(vtkSlicerLabelWidget::GetLevelOfDetailGlyphOnlySizeAttributeName()))
+    {
+      vtkSlicerLabelWidget::SetLevelOfDetailThresholds(viewNode,
+        this->LevelOfDetailThresholds[0], this->LevelOfDetailThresholds[1]);
+    }
+    return;
+  }
   
   vtkSlicerMarkupsLogic* markupsLogic = vtkSlicerMarkupsLogic::SafeDownCast(this->GetModuleLogic("Markups"));
   if (!markupsLogic)
@@ -112,12 +928,21 @@ void vtkSlicerLabelLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
     vtkErrorMacro("OnMRMLSceneNodeAdded failed: invalid markups label node");
     return;
   }
+  if (this->Batch)
+  {
+    return;
+  }
+  // The label text and colours are read afterwards from the file.
+  if (scene->IsImporting())
+  {
+    this->ImportedLabelNodes.emplace_back(labelNode);
+    return;
+  }
   
   // Label.
-  const char * defaultConstructorLabel = "Label";
-  if (std::string(labelNode->GetLabel()) == std::string(defaultConstructorLabel)) // Default constructor value.
+  if (std::string(labelNode->GetLabel()) == std::string(DefaultLabel)) // Default constructor value.
   {
-    labelNode->SetLabel(scene->GenerateUniqueName(defaultConstructorLabel).c_str());
+    labelNode->SetLabel(scene->GenerateUniqueName(DefaultLabel).c_str());
   }
   
   const std::string colourNodeID = labelNode->GetUseAlternateColors();
@@ -130,23 +955,56 @@ void vtkSlicerLabelLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
     }
     double selectedColour[3] = { 1.0, 0.5, 0.5};
     this->GenerateUniqueColor(selectedColour, colourNodeID);
-    double colour[3] = { 1.0 - colour[0], 1.0 - colour[1], 1.0 - colour[2]};
+    double colour[3] = { 1.0 - selectedColour[0], 1.0 - selectedColour[1], 1.0 - selectedColour[2]};
     labelNode->GetDisplayNode()->SetSelectedColor(selectedColour);
     labelNode->GetDisplayNode()->SetColor(colour);
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkSlicerLabelLogic::OnMRMLSceneEndImport()
+{
+  this->Superclass::OnMRMLSceneEndImport();
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  std::vector<vtkWeakPointer<vtkMRMLMarkupsLabelNode>> labelNodes;
+  labelNodes.swap(this->ImportedLabelNodes);
+  if (!scene)
+  {
+    vtkErrorMacro("OnMRMLSceneEndImport failed: invalid scene");
+    return;
+  }
+  // Name the imported labels whose file has no text, with a single scan of the scene.
+  UniqueNameGenerator labels(DefaultLabel);
+  bool initialized = false;
+  for (vtkMRMLMarkupsLabelNode * labelNode : labelNodes)
+  {
+    if (!labelNode || std::string(labelNode->GetLabel()) != std::string(DefaultLabel))
+    {
+      continue;
+    }
+    if (!initialized)
+    {
+      InitializeNameGenerators(scene, labels, nullptr);
+      initialized = true;
+    }
+    labelNode->SetLabel(labels.Generate().c_str());
+  }
+}
+
 //------------------------------------------------------------------------------
 // Poked from vtkSlicerMarkupsLogic.cxx .
 void vtkSlicerLabelLogic::GenerateUniqueColor(double color[3], const std::string& colorNodeID)
 {
-  double rgba[4] = { 1.0, 0.5, 0.5, 1.0 };
-  vtkMRMLColorTableNode* colorTable = nullptr;
   vtkMRMLScene* scene = this->GetMRMLScene();
-  {
-    colorTable = vtkMRMLColorTableNode::SafeDownCast(
-      scene->GetNodeByID(colorNodeID.c_str()));
-  }
+  vtkMRMLColorTableNode* colorTable = scene ? vtkMRMLColorTableNode::SafeDownCast(
+    scene->GetNodeByID(colorNodeID.c_str())) : nullptr;
+  this->GenerateUniqueColor(color, colorTable);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelLogic::GenerateUniqueColor(double color[3], vtkMRMLColorTableNode * colorTable)
+{
+  double rgba[4] = { 1.0, 0.5, 0.5, 1.0 };
   if (colorTable)
   {
     colorTable->GetColor(this->NextColorIndex, rgba);
@@ -21,30 +21,125 @@
 #ifndef __vtkSlicerLabelMarkupslogic_h_
 #define __vtkSlicerLabelMarkupslogic_h_
 
-#include <vtkSlicerMarkupsLogic.h>
+#include <vtkSlicerExtraMarkupsLogic.h>
 
 #include "vtkSlicerLabelModuleLogicExport.h"
 
+// VTK includes
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <memory>
+#include <vector>
+
+class vtkMRMLAbstractViewNode;
+class vtkMRMLColorTableNode;
+class vtkMRMLMarkupsLabelNode;
+class vtkPoints;
+class vtkStringArray;
+
 class VTK_SLICER_LABEL_MODULE_LOGIC_EXPORT vtkSlicerLabelLogic:
-  public vtkSlicerMarkupsLogic
+  public vtkSlicerExtraMarkupsLogic
 {
 public:
   static vtkSlicerLabelLogic* New();
-  vtkTypeMacro(vtkSlicerLabelLogic, vtkSlicerMarkupsLogic);
+  vtkTypeMacro(vtkSlicerLabelLogic, vtkSlicerExtraMarkupsLogic);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  /*
+   * Add a label node for each position, in a single batch of scene
+   * insertions. The text is shown at the position; a target position, if
+   * given and without NaN coordinates, adds an arrow pointing to it.
+   * Missing or empty texts are replaced by unique names; names and colours
+   * are prepared once for the whole batch.
+   * The IDs of the new nodes are appended to nodeIDs if given.
+   * Returns the number of nodes added.
+   */
+  int AddLabels(vtkPoints * positions, vtkPoints * targetPositions = nullptr,
+                vtkStringArray * texts = nullptr, vtkStringArray * nodeIDs = nullptr);
+
+  /*
+   * Add the labels of a CSV file, or of a TSV file if its extension is .tsv
+   * or .tab. The header names the columns : x, y, z, and optionally targetX,
+   * targetY, targetZ and text, in any order. CSV fields may be quoted; in
+   * TSV, tabs, newlines and backslashes of texts are escaped with a
+   * backslash. The file is parsed in chunks, or mapped in memory, and the
+   * nodes are created as with AddLabels, in a single batch process state.
+   * Rows with invalid positions are skipped.
+   * Returns the number of labels added.
+   */
+  int ImportLabels(const char * fileName, bool memoryMapped = false);
+  // Labels per second of the last ImportLabels, parsing and node creation included.
+  vtkGetMacro(LastImportRate, double);
+  /*
+   * Write the world positions and texts of label nodes in the format read by
+   * ImportLabels. All label nodes of the scene are written if no IDs are given.
+   */
+  bool ExportLabels(const char * fileName, vtkStringArray * nodeIDs = nullptr);
+
+  /*
+   * Draw the texts of all labels of a 3D view with a single label mapper,
+   * placing only those that do not overlap, selected labels first, instead
+   * of one text actor each. This applies to all scenes; off by default.
+   */
+  void SetLabelHierarchy(bool enabled);
+  bool GetLabelHierarchy() const;
+  vtkBooleanMacro(LabelHierarchy, bool);
+
+  /*
+   * Draw the arrows of all labels of a 3D view with one line actor and one
+   * instanced cone mapper, coloured per label, instead of two actors each.
+   * This applies to all scenes; off by default.
+   */
+  void SetArrowInstancing(bool enabled);
+  bool GetArrowInstancing() const;
+  vtkBooleanMacro(ArrowInstancing, bool);
+
+  /*
+   * Labels whose arrow is shorter than glyphOnlySize pixels on screen show
+   * their control points only, and below hiddenSize nothing. Labels behind
+   * the camera of a 3D view are hidden. The thresholds are kept by each view
+   * node; without a view node, they apply to all views of the scene and to
+   * those added later. 0 for both disables it, the default.
+   */
+  void SetLevelOfDetailThresholds(double glyphOnlySize, double hiddenSize,
+                                  vtkMRMLAbstractViewNode * viewNode = nullptr);
+  // Thresholds of a view, or without a view node, of the views added later.
+  double GetLevelOfDetailGlyphOnlySize(vtkMRMLAbstractViewNode * viewNode = nullptr) const;
+  double GetLevelOfDetailHiddenSize(vtkMRMLAbstractViewNode * viewNode = nullptr) const;
+
 protected:
   vtkSlicerLabelLogic();
   ~vtkSlicerLabelLogic() override;
 
   void RegisterNodes() override;
   void OnMRMLSceneNodeAdded(vtkMRMLNode * node) override;
+  void OnMRMLSceneEndImport() override;
   void GenerateUniqueColor(double color[3], const std::string& colorNodeID);
+  void GenerateUniqueColor(double color[3], vtkMRMLColorTableNode * colorTable);
+  /*
+   * AddLabels in steps. BeginAddLabels starts a batch process state and
+   * prepares the names and colours; AddLabel inserts a node, targetPosition
+   * and text being optional.
+   */
+  void BeginAddLabels();
+  vtkMRMLMarkupsLabelNode * AddLabel(const double position[3], const double * targetPosition, const char * text);
+  void EndAddLabels();
+  // Let the displayable managers of all views update the label representations, e.g. for a drawing option.
+  void UpdateLabelDisplayNodes();
 
 private:
   vtkSlicerLabelLogic(const vtkSlicerLabelLogic&) = delete;
   void operator=(const vtkSlicerLabelLogic&) = delete;
   int NextColorIndex = 1;
+  // Unique names and colours of the nodes being added, between BeginAddLabels and EndAddLabels.
+  struct LabelBatch;
+  std::unique_ptr<LabelBatch> Batch;
+  double LastImportRate = 0.0;
+  // Label nodes added during an import, named in a single pass at its end.
+  std::vector<vtkWeakPointer<vtkMRMLMarkupsLabelNode>> ImportedLabelNodes;
+  // Level of detail thresholds of the views added later.
+  double LevelOfDetailThresholds[2] = { 0.0, 0.0 };
 };
 
 #endif // __vtkSlicerLabelMarkupslogic_h_
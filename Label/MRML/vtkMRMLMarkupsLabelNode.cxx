@@ -25,6 +25,9 @@
 #include <vtkObjectFactory.h>
 #include <vtkMRMLScene.h>
 
+// STD includes
+#include <cstring>
+
 //--------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsLabelNode);
 
@@ -41,7 +44,10 @@ vtkMRMLMarkupsLabelNode::vtkMRMLMarkupsLabelNode()
 }
 
 //--------------------------------------------------------------------------------
-vtkMRMLMarkupsLabelNode::~vtkMRMLMarkupsLabelNode()=default;
+vtkMRMLMarkupsLabelNode::~vtkMRMLMarkupsLabelNode()
+{
+  delete [] this->Label;
+}
 
 //----------------------------------------------------------------------------
 vtkMRMLStorageNode* vtkMRMLMarkupsLabelNode::CreateDefaultStorageNode()
@@ -131,6 +137,27 @@ void vtkMRMLMarkupsLabelNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=tr
   vtkMRMLCopyEndMacro();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsLabelNode::SetLabel(const char * label)
+{
+  if ((this->Label == nullptr && label == nullptr)
+    || (this->Label && label && strcmp(this->Label, label) == 0))
+  {
+    return;
+  }
+  delete [] this->Label;
+  this->Label = nullptr;
+  if (label)
+  {
+    this->Label = new char[strlen(label) + 1];
+    strcpy(this->Label, label);
+  }
+  this->StorableModifiedTime.Modified();
+  // Text observers first : the label widgets update their text only.
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent);
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsLabelNode::SetLabelLocation(int pointId)
 {
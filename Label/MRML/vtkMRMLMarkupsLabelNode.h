@@ -39,6 +39,11 @@ public:
     Fixed,
     TipDimensionMode3D_Last
   };
+  enum
+  {
+    // Invoked before ModifiedEvent when the label text changes.
+    LabelTextModifiedEvent = 19500
+  };
   static vtkMRMLMarkupsLabelNode* New();
   vtkTypeMacro(vtkMRMLMarkupsLabelNode, vtkMRMLMarkupsNode);
   void PrintSelf(ostream& os, vtkIndent indent) override;
@@ -70,7 +75,13 @@ public:
   vtkMRMLStorageNode* CreateDefaultStorageNode() override;
 
   vtkGetStringMacro(Label);
-  vtkSetStringMacro(Label);
+  /*
+   * The text is displayed as is, without geometry : a change invokes
+   * LabelTextModifiedEvent, so that representations can update their text
+   * only, then ModifiedEvent for all other observers. Bursts are coalesced
+   * by StartModify()/EndModify().
+   */
+  void SetLabel(const char * label);
 
   vtkSetClampMacro(TipDimensionMode3D, int, ViewScaleFactor, Fixed);
   vtkGetMacro(TipDimensionMode3D, int);
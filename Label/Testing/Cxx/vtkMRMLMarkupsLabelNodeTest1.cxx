@@ -0,0 +1,107 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+// Label includes
+#include "vtkMRMLMarkupsLabelNode.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <map>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Count the events of the observed node, by event ID.
+void CountEvent(vtkObject * vtkNotUsed(caller), unsigned long event,
+                void * clientData, void * vtkNotUsed(callData))
+{
+  (*reinterpret_cast<std::map<unsigned long, int>*>(clientData))[event]++;
+}
+
+//----------------------------------------------------------------------------
+// A text change invokes LabelTextModifiedEvent, then ModifiedEvent.
+int TestLabelTextModifiedEvent()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsLabelNode> labelNode;
+  scene->AddNode(labelNode);
+  labelNode->SetLabel("First");
+
+  std::map<unsigned long, int> events;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(CountEvent);
+  callback->SetClientData(&events);
+  labelNode->AddObserver(vtkCommand::AnyEvent, callback);
+
+  // The same text.
+  vtkMTimeType mtime = labelNode->GetMTime();
+  labelNode->SetLabel("First");
+  CHECK_INT(events[vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent], 0);
+  CHECK_INT(events[vtkCommand::ModifiedEvent], 0);
+  CHECK_BOOL(labelNode->GetMTime() == mtime, true);
+
+  // Another text.
+  labelNode->SetLabel("Second");
+  CHECK_STRING(labelNode->GetLabel(), "Second");
+  CHECK_INT(events[vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent], 1);
+  CHECK_INT(events[vtkCommand::ModifiedEvent], 1);
+  CHECK_BOOL(labelNode->GetMTime() > mtime, true);
+
+  // No text.
+  mtime = labelNode->GetMTime();
+  labelNode->SetLabel(nullptr);
+  CHECK_NULL(labelNode->GetLabel());
+  CHECK_INT(events[vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent], 2);
+  CHECK_INT(events[vtkCommand::ModifiedEvent], 2);
+  CHECK_BOOL(labelNode->GetMTime() > mtime, true);
+
+  // A burst is coalesced.
+  events.clear();
+  int wasModifying = labelNode->StartModify();
+  labelNode->SetLabel("Third");
+  labelNode->SetLabel("Fourth");
+  labelNode->SetLabel("Fifth");
+  CHECK_INT(events[vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent], 0);
+  CHECK_INT(events[vtkCommand::ModifiedEvent], 0);
+  labelNode->EndModify(wasModifying);
+  CHECK_INT(events[vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent], 1);
+  CHECK_INT(events[vtkCommand::ModifiedEvent], 1);
+  CHECK_STRING(labelNode->GetLabel(), "Fifth");
+
+  labelNode->RemoveObserver(callback);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsLabelNodeTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestLabelTextModifiedEvent());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,442 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerLabelArrowInstancer.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkConeSource.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkLineSource.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkRenderer.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Unit vector from start to end, or +x if they coincide.
+void GetArrowDirection(const double start[3], const double end[3], double direction[3])
+{
+  vtkMath::Subtract(end, start, direction);
+  if (vtkMath::Normalize(direction) == 0.0)
+  {
+    direction[0] = 1.0;
+    direction[1] = 0.0;
+    direction[2] = 0.0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Rotate +x to 'direction', scale by 'scale' in the rotated frame, then translate to 'origin'.
+void SetArrowMatrix(const double origin[3], const double direction[3], const double scale[3],
+                    vtkMatrix4x4 * matrix)
+{
+  double axes[3][3] = { { direction[0], direction[1], direction[2] } };
+  vtkMath::Perpendiculars(axes[0], axes[1], axes[2], 0.0);
+  matrix->Identity();
+  for (int row = 0; row < 3; row++)
+  {
+    for (int column = 0; column < 3; column++)
+    {
+      matrix->SetElement(row, column, axes[column][row] * scale[column]);
+    }
+    matrix->SetElement(row, 3, origin[row]);
+  }
+}
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLabelArrowInstancer);
+vtkInformationKeyMacro(vtkSlicerLabelArrowInstancer, INSTANCER, ObjectBase);
+
+bool vtkSlicerLabelArrowInstancer::Enabled = false;
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelArrowInstancer::vtkSlicerLabelArrowInstancer()
+{
+  this->Shafts = vtkSmartPointer<vtkPolyData>::New();
+  this->ShaftMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  this->ShaftMapper->SetInputData(this->Shafts);
+  this->ShaftMapper->ScalarVisibilityOn();
+  this->ShaftMapper->SetScalarModeToUseCellFieldData();
+  this->ShaftMapper->SelectColorArray("Colors");
+  this->ShaftMapper->SetColorModeToDirectScalars();
+  this->ShaftActor = vtkSmartPointer<vtkActor>::New();
+  this->ShaftActor->SetMapper(this->ShaftMapper);
+
+  this->ConeInstances = vtkSmartPointer<vtkPolyData>::New();
+  this->ConeMapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+  this->ConeMapper->SetSourceData(vtkSlicerLabelArrowInstancer::GetUnitCone());
+  this->ConeMapper->SetInputData(this->ConeInstances);
+  this->ConeMapper->ScalingOn();
+  this->ConeMapper->SetScaleModeToScaleByMagnitude();
+  this->ConeMapper->SetScaleArray("Radius");
+  this->ConeMapper->OrientOn();
+  this->ConeMapper->SetOrientationModeToDirection();
+  this->ConeMapper->SetOrientationArray("Direction");
+  this->ConeMapper->SetSelectionIdArray("InstanceIds");
+  this->ConeMapper->ScalarVisibilityOn();
+  this->ConeMapper->SetScalarModeToUsePointFieldData();
+  this->ConeMapper->SelectColorArray("Colors");
+  this->ConeMapper->SetColorModeToDirectScalars();
+  this->ConeActor = vtkSmartPointer<vtkActor>::New();
+  this->ConeActor->SetMapper(this->ConeMapper);
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelArrowInstancer::~vtkSlicerLabelArrowInstancer() = default;
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkSlicerLabelArrowInstancer::Enabled << "\n";
+  os << indent << "Number of instances: " << this->Instances.size() << "\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::SetEnabled(bool enabled)
+{
+  vtkSlicerLabelArrowInstancer::Enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelArrowInstancer::GetEnabled()
+{
+  return vtkSlicerLabelArrowInstancer::Enabled;
+}
+
+//------------------------------------------------------------------------------
+vtkPolyData * vtkSlicerLabelArrowInstancer::GetUnitShaft()
+{
+  static vtkSmartPointer<vtkPolyData> shaft;
+  if (!shaft)
+  {
+    vtkNew<vtkLineSource> lineSource;
+    lineSource->SetPoint1(0.0, 0.0, 0.0);
+    lineSource->SetPoint2(1.0, 0.0, 0.0);
+    lineSource->Update();
+    shaft = lineSource->GetOutput();
+  }
+  return shaft;
+}
+
+//------------------------------------------------------------------------------
+vtkPolyData * vtkSlicerLabelArrowInstancer::GetUnitCone()
+{
+  static vtkSmartPointer<vtkPolyData> cone;
+  if (!cone)
+  {
+    vtkNew<vtkConeSource> coneSource;
+    coneSource->SetRadius(1.0);
+    coneSource->SetHeight(3.0);
+    coneSource->SetResolution(45);
+    coneSource->SetDirection(1.0, 0.0, 0.0);
+    coneSource->SetCenter(0.0, 0.0, 0.0);
+    coneSource->Update();
+    cone = coneSource->GetOutput();
+  }
+  return cone;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::PlaceArrow(const double start[3], const double end[3], double coneRadius,
+                                              vtkMatrix4x4 * shaftMatrix, vtkMatrix4x4 * coneMatrix)
+{
+  double direction[3] = { 0.0 };
+  GetArrowDirection(start, end, direction);
+  if (shaftMatrix)
+  {
+    const double length = std::sqrt(vtkMath::Distance2BetweenPoints(start, end));
+    const double scale[3] = { length, 1.0, 1.0 };
+    SetArrowMatrix(start, direction, scale, shaftMatrix);
+  }
+  if (coneMatrix)
+  {
+    const double scale[3] = { coneRadius, coneRadius, coneRadius };
+    SetArrowMatrix(end, direction, scale, coneMatrix);
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelArrowInstancer * vtkSlicerLabelArrowInstancer::GetInstancer(vtkRenderer * renderer, bool create)
+{
+  vtkInformation * information = renderer ? renderer->GetInformation() : nullptr;
+  if (!information)
+  {
+    return nullptr;
+  }
+  vtkSlicerLabelArrowInstancer * instancer = vtkSlicerLabelArrowInstancer::SafeDownCast(
+    information->Get(vtkSlicerLabelArrowInstancer::INSTANCER()));
+  if (instancer || !create)
+  {
+    return instancer;
+  }
+  vtkNew<vtkSlicerLabelArrowInstancer> newInstancer;
+  newInstancer->Renderer = renderer;
+  information->Set(vtkSlicerLabelArrowInstancer::INSTANCER(), newInstancer);
+  return newInstancer;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::SetInstance(vtkObject * owner, const char * nodeID,
+                                               const double start[3], const double end[3], double coneRadius,
+                                               const double color[3], double opacity)
+{
+  if (!owner)
+  {
+    return;
+  }
+  auto found = this->InstanceIndices.find(owner);
+  if (found == this->InstanceIndices.end())
+  {
+    this->InstanceIndices[owner] = this->Instances.size();
+    this->Instances.emplace_back();
+    found = this->InstanceIndices.find(owner);
+  }
+  Instance& instance = this->Instances[found->second];
+  instance.Owner = owner;
+  instance.NodeID = nodeID ? nodeID : "";
+  for (int i = 0; i < 3; i++)
+  {
+    instance.Start[i] = start[i];
+    instance.End[i] = end[i];
+    instance.Color[i] = static_cast<unsigned char>(std::round(std::min(std::max(color[i], 0.0), 1.0) * 255.0));
+  }
+  instance.Color[3] = static_cast<unsigned char>(std::round(std::min(std::max(opacity, 0.0), 1.0) * 255.0));
+  instance.ConeRadius = coneRadius;
+  this->InstancesModified = true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::SetInstanceConeRadius(vtkObject * owner, double coneRadius)
+{
+  auto found = this->InstanceIndices.find(owner);
+  if (found == this->InstanceIndices.end())
+  {
+    return;
+  }
+  this->Instances[found->second].ConeRadius = coneRadius;
+  if (this->InstancesModified || !this->ConeRadii
+    || this->ConeRadii->GetNumberOfTuples() != static_cast<vtkIdType>(this->Instances.size()))
+  {
+    this->InstancesModified = true;
+    return;
+  }
+  // The other arrays are still valid.
+  this->ConeRadii->SetValue(static_cast<vtkIdType>(found->second), coneRadius);
+  this->ConeRadii->Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::SetInstanceVisibility(vtkObject * owner, bool visible)
+{
+  auto found = this->InstanceIndices.find(owner);
+  if (found == this->InstanceIndices.end() || this->Instances[found->second].Visible == visible)
+  {
+    return;
+  }
+  this->Instances[found->second].Visible = visible;
+  this->InstancesModified = true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::RemoveInstance(vtkObject * owner)
+{
+  auto found = this->InstanceIndices.find(owner);
+  if (found == this->InstanceIndices.end())
+  {
+    return;
+  }
+  // Move the last instance into the freed slot.
+  const size_t index = found->second;
+  this->InstanceIndices.erase(found);
+  if (index != this->Instances.size() - 1)
+  {
+    this->Instances[index] = this->Instances.back();
+    this->InstanceIndices[this->Instances[index].Owner] = index;
+  }
+  this->Instances.pop_back();
+  this->InstancesModified = true;
+
+  if (this->Instances.empty())
+  {
+    // The caller may hold this pointer; it is only valid until this returns.
+    vtkSmartPointer<vtkSlicerLabelArrowInstancer> keepAlive = this;
+    this->Renderer->GetInformation()->Remove(vtkSlicerLabelArrowInstancer::INSTANCER());
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelArrowInstancer::HasInstance(vtkObject * owner) const
+{
+  return this->InstanceIndices.find(owner) != this->InstanceIndices.end();
+}
+
+//------------------------------------------------------------------------------
+const char * vtkSlicerLabelArrowInstancer::GetInstanceNodeID(vtkIdType instanceId) const
+{
+  if (instanceId < 0 || instanceId >= static_cast<vtkIdType>(this->Instances.size()))
+  {
+    return nullptr;
+  }
+  return this->Instances[instanceId].NodeID.c_str();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelArrowInstancer::IsRenderingOwner(vtkObject * owner) const
+{
+  return !this->Instances.empty() && this->Instances.front().Owner == owner;
+}
+
+//------------------------------------------------------------------------------
+vtkActor * vtkSlicerLabelArrowInstancer::GetShaftActor()
+{
+  return this->ShaftActor;
+}
+
+//------------------------------------------------------------------------------
+vtkActor * vtkSlicerLabelArrowInstancer::GetConeActor()
+{
+  return this->ConeActor;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::UpdateInstances()
+{
+  if (!this->InstancesModified)
+  {
+    return;
+  }
+  // Hidden instances keep their index, which is their selection id.
+  const vtkIdType numberOfInstances = static_cast<vtkIdType>(std::count_if(this->Instances.begin(),
+    this->Instances.end(), [](const Instance& instance) { return instance.Visible; }));
+  // Shafts : one line cell per visible instance.
+  vtkNew<vtkPoints> shaftPoints;
+  shaftPoints->SetNumberOfPoints(2 * numberOfInstances);
+  vtkNew<vtkCellArray> shaftLines;
+  vtkNew<vtkUnsignedCharArray> shaftColors;
+  shaftColors->SetName("Colors");
+  shaftColors->SetNumberOfComponents(4);
+  shaftColors->SetNumberOfTuples(numberOfInstances);
+  // Cones : one glyph per visible instance, at the end of the shaft.
+  vtkNew<vtkPoints> coneCenters;
+  coneCenters->SetNumberOfPoints(numberOfInstances);
+  vtkNew<vtkDoubleArray> directions;
+  directions->SetName("Direction");
+  directions->SetNumberOfComponents(3);
+  directions->SetNumberOfTuples(numberOfInstances);
+  vtkNew<vtkDoubleArray> radii;
+  radii->SetName("Radius");
+  radii->SetNumberOfTuples(numberOfInstances);
+  vtkNew<vtkUnsignedCharArray> coneColors;
+  coneColors->SetName("Colors");
+  coneColors->SetNumberOfComponents(4);
+  coneColors->SetNumberOfTuples(numberOfInstances);
+  vtkNew<vtkIdTypeArray> instanceIds;
+  instanceIds->SetName("InstanceIds");
+  instanceIds->SetNumberOfTuples(numberOfInstances);
+  vtkIdType i = 0;
+  for (size_t index = 0; index < this->Instances.size(); index++)
+  {
+    const Instance& instance = this->Instances[index];
+    if (!instance.Visible)
+    {
+      continue;
+    }
+    shaftPoints->SetPoint(2 * i, instance.Start);
+    shaftPoints->SetPoint(2 * i + 1, instance.End);
+    const vtkIdType line[2] = { 2 * i, 2 * i + 1 };
+    shaftLines->InsertNextCell(2, line);
+    shaftColors->SetTypedTuple(i, instance.Color);
+
+    double direction[3] = { 0.0 };
+    GetArrowDirection(instance.Start, instance.End, direction);
+    coneCenters->SetPoint(i, instance.End);
+    directions->SetTuple(i, direction);
+    radii->SetValue(i, instance.ConeRadius);
+    coneColors->SetTypedTuple(i, instance.Color);
+    instanceIds->SetValue(i, static_cast<vtkIdType>(index));
+    i++;
+  }
+  this->Shafts->Initialize();
+  this->Shafts->SetPoints(shaftPoints);
+  this->Shafts->SetLines(shaftLines);
+  this->Shafts->GetCellData()->AddArray(shaftColors);
+  this->ConeInstances->Initialize();
+  this->ConeInstances->SetPoints(coneCenters);
+  this->ConeInstances->GetPointData()->AddArray(directions);
+  this->ConeInstances->GetPointData()->AddArray(radii);
+  this->ConeInstances->GetPointData()->AddArray(coneColors);
+  this->ConeInstances->GetPointData()->AddArray(instanceIds);
+  this->ConeRadii = radii;
+  this->InstancesModified = false;
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerLabelArrowInstancer::RenderOpaqueGeometry(vtkViewport * viewport)
+{
+  this->UpdateInstances();
+  return this->ShaftActor->RenderOpaqueGeometry(viewport)
+    + this->ConeActor->RenderOpaqueGeometry(viewport);
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerLabelArrowInstancer::RenderTranslucentPolygonalGeometry(vtkViewport * viewport)
+{
+  this->UpdateInstances();
+  return this->ShaftActor->RenderTranslucentPolygonalGeometry(viewport)
+    + this->ConeActor->RenderTranslucentPolygonalGeometry(viewport);
+}
+
+//------------------------------------------------------------------------------
+vtkTypeBool vtkSlicerLabelArrowInstancer::HasTranslucentPolygonalGeometry()
+{
+  this->UpdateInstances();
+  return this->ShaftActor->HasTranslucentPolygonalGeometry()
+    || this->ConeActor->HasTranslucentPolygonalGeometry();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelArrowInstancer::ReleaseGraphicsResources(vtkWindow * window)
+{
+  this->ShaftActor->ReleaseGraphicsResources(window);
+  this->ConeActor->ReleaseGraphicsResources(window);
+}
@@ -0,0 +1,153 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkslicerlabelarrowinstancer_h_
+#define __vtkslicerlabelarrowinstancer_h_
+
+#include "vtkSlicerLabelModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkActor;
+class vtkDoubleArray;
+class vtkGlyph3DMapper;
+class vtkInformationObjectBaseKey;
+class vtkMatrix4x4;
+class vtkPolyData;
+class vtkPolyDataMapper;
+class vtkRenderer;
+class vtkViewport;
+class vtkWindow;
+
+/**
+ * @class   vtkSlicerLabelArrowInstancer
+ * @brief   Draws all Label arrows of a renderer with one line and one glyph mapper
+ *
+ * An arrow is a shaft from the text position to the target, and a cone
+ * whose base is centred on the target. Both are drawn from cached unit
+ * meshes along +x : a line from the origin to (1, 0, 0), and a cone of
+ * radius 1 and height 3 centred on the origin. PlaceArrow computes the
+ * matrices that place them for one label.
+ *
+ * Representations may instead register their arrow as an instance with a
+ * colour, and hide their own actors. The shafts of a renderer are then
+ * drawn as one polydata, and the cones by one vtkGlyph3DMapper, in two
+ * actors that the first registered representation renders. Control points
+ * remain drawn and picked by each representation. The instancer is kept in
+ * the information of its renderer, so it lives and dies with that view.
+ *
+ * Instancing is global and off by default; see vtkSlicerLabelLogic.
+*/
+class VTK_SLICER_LABEL_MODULE_VTKWIDGETS_EXPORT vtkSlicerLabelArrowInstancer
+: public vtkObject
+{
+public:
+  static vtkSlicerLabelArrowInstancer* New();
+  vtkTypeMacro(vtkSlicerLabelArrowInstancer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+
+  // The unit meshes, built once.
+  static vtkPolyData * GetUnitShaft();
+  static vtkPolyData * GetUnitCone();
+  // Matrices placing the unit shaft from start to end, and the unit cone of 'coneRadius' at end.
+  static void PlaceArrow(const double start[3], const double end[3], double coneRadius,
+                         vtkMatrix4x4 * shaftMatrix, vtkMatrix4x4 * coneMatrix);
+
+  // The instancer shared by all representations of a renderer; created on request.
+  static vtkSlicerLabelArrowInstancer * GetInstancer(vtkRenderer * renderer, bool create = true);
+
+  // Add or update the instance of 'owner'.
+  void SetInstance(vtkObject * owner, const char * nodeID,
+                   const double start[3], const double end[3], double coneRadius,
+                   const double color[3], double opacity);
+  // Only resize the cone of the instance of 'owner', e.g. on camera changes.
+  void SetInstanceConeRadius(vtkObject * owner, double coneRadius);
+  // Hide the instance of 'owner' without removing it, e.g. by level of detail.
+  void SetInstanceVisibility(vtkObject * owner, bool visible);
+  // Forget the instance of 'owner', if any. The instancer may be deleted.
+  void RemoveInstance(vtkObject * owner);
+  bool HasInstance(vtkObject * owner) const;
+  int GetNumberOfInstances() const { return static_cast<int>(this->Instances.size()); }
+
+  // Node of an instance, e.g. from the selection id array of a hardware selection.
+  const char * GetInstanceNodeID(vtkIdType instanceId) const;
+
+  // Only the first registered representation renders the shared actors.
+  bool IsRenderingOwner(vtkObject * owner) const;
+  vtkActor * GetShaftActor();
+  vtkActor * GetConeActor();
+
+  int RenderOpaqueGeometry(vtkViewport * viewport);
+  int RenderTranslucentPolygonalGeometry(vtkViewport * viewport);
+  vtkTypeBool HasTranslucentPolygonalGeometry();
+  void ReleaseGraphicsResources(vtkWindow * window);
+
+protected:
+  vtkSlicerLabelArrowInstancer();
+  ~vtkSlicerLabelArrowInstancer() override;
+
+  // Rebuild the instance arrays if an instance changed.
+  void UpdateInstances();
+
+  struct Instance
+  {
+    vtkObject * Owner = nullptr;
+    std::string NodeID;
+    double Start[3] = { 0.0, 0.0, 0.0 };
+    double End[3] = { 0.0, 0.0, 0.0 };
+    double ConeRadius = 0.0;
+    unsigned char Color[4] = { 0, 0, 0, 255 };
+    bool Visible = true;
+  };
+  std::vector<Instance> Instances;
+  std::map<vtkObject*, size_t> InstanceIndices;
+  bool InstancesModified = false;
+
+  vtkSmartPointer<vtkPolyData> Shafts;
+  vtkSmartPointer<vtkPolyDataMapper> ShaftMapper;
+  vtkSmartPointer<vtkActor> ShaftActor;
+  vtkSmartPointer<vtkPolyData> ConeInstances;
+  vtkSmartPointer<vtkDoubleArray> ConeRadii;
+  vtkSmartPointer<vtkGlyph3DMapper> ConeMapper;
+  vtkSmartPointer<vtkActor> ConeActor;
+
+  // Holds this instancer in its information.
+  vtkRenderer * Renderer = nullptr;
+
+private:
+  // Key of the instancer in the information of its renderer.
+  static vtkInformationObjectBaseKey * INSTANCER();
+  static bool Enabled;
+
+  vtkSlicerLabelArrowInstancer(const vtkSlicerLabelArrowInstancer&) = delete;
+  void operator=(const vtkSlicerLabelArrowInstancer&) = delete;
+};
+
+#endif // __vtkslicerlabelarrowinstancer_h_
@@ -0,0 +1,353 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerLabelHierarchyRenderer.h"
+
+// VTK includes
+#include <vtkActor2D.h>
+#include <vtkDoubleArray.h>
+#include <vtkFreeTypeLabelRenderStrategy.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkLabelHierarchy.h>
+#include <vtkLabelPlacementMapper.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPointSetToLabelHierarchy.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRenderer.h>
+#include <vtkStringArray.h>
+#include <vtkTextProperty.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+// Ends the type that is prefixed to each text of the anchors.
+const char TypeSeparator = '\x1f';
+
+//------------------------------------------------------------------------------
+/*
+ * Draws each label with the text property of its type. The placement mapper
+ * passes one text property for all labels; the type travels in the text
+ * instead, and is stripped here before measuring and drawing.
+ */
+class vtkLabelTypeRenderStrategy : public vtkFreeTypeLabelRenderStrategy
+{
+public:
+  static vtkLabelTypeRenderStrategy * New();
+  vtkTypeMacro(vtkLabelTypeRenderStrategy, vtkFreeTypeLabelRenderStrategy);
+
+  // Text properties by type.
+  std::vector<vtkSmartPointer<vtkTextProperty>> TextProperties;
+
+  static std::string EncodeText(size_t type, const std::string& text)
+  {
+    return std::to_string(type) + TypeSeparator + text;
+  }
+
+  using Superclass::ComputeLabelBounds;
+  using Superclass::RenderLabel;
+
+  void ComputeLabelBounds(vtkTextProperty * tprop, vtkStdString label, double bds[4]) override
+  {
+    tprop = this->DecodeText(label, tprop);
+    this->Superclass::ComputeLabelBounds(tprop, label, bds);
+  }
+
+  void RenderLabel(int x[2], vtkTextProperty * tprop, vtkStdString label) override
+  {
+    tprop = this->DecodeText(label, tprop);
+    this->Superclass::RenderLabel(x, tprop, label);
+  }
+
+  void RenderLabel(int x[2], vtkTextProperty * tprop, vtkStdString label, int maxWidth) override
+  {
+    tprop = this->DecodeText(label, tprop);
+    this->Superclass::RenderLabel(x, tprop, label, maxWidth);
+  }
+
+protected:
+  vtkLabelTypeRenderStrategy() = default;
+  ~vtkLabelTypeRenderStrategy() override = default;
+
+  // Strip the type from 'label'; return its text property, else 'tprop'.
+  vtkTextProperty * DecodeText(vtkStdString& label, vtkTextProperty * tprop) const
+  {
+    const size_t separator = label.find(TypeSeparator);
+    if (separator == std::string::npos)
+    {
+      return tprop;
+    }
+    const size_t type = std::strtoul(label.c_str(), nullptr, 10);
+    label.erase(0, separator + 1);
+    if (type < this->TextProperties.size() && this->TextProperties[type])
+    {
+      return this->TextProperties[type];
+    }
+    return tprop;
+  }
+
+private:
+  vtkLabelTypeRenderStrategy(const vtkLabelTypeRenderStrategy&) = delete;
+  void operator=(const vtkLabelTypeRenderStrategy&) = delete;
+};
+
+vtkStandardNewMacro(vtkLabelTypeRenderStrategy);
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLabelHierarchyRenderer);
+vtkInformationKeyMacro(vtkSlicerLabelHierarchyRenderer, LABEL_RENDERER, ObjectBase);
+
+bool vtkSlicerLabelHierarchyRenderer::Enabled = false;
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelHierarchyRenderer::vtkSlicerLabelHierarchyRenderer()
+{
+  this->Anchors = vtkSmartPointer<vtkPolyData>::New();
+  this->TextProperty = vtkSmartPointer<vtkTextProperty>::New();
+  
+  this->Hierarchy = vtkSmartPointer<vtkPointSetToLabelHierarchy>::New();
+  this->Hierarchy->SetInputData(this->Anchors);
+  this->Hierarchy->SetLabelArrayName("LabelText");
+  this->Hierarchy->SetPriorityArrayName("Priority");
+  this->Hierarchy->SetTextProperty(this->TextProperty);
+  
+  // All texts are drawn by one strategy in the overlay pass, each with its own text property.
+  this->RenderStrategy = vtkSmartPointer<vtkLabelTypeRenderStrategy>::New();
+  this->RenderStrategy->SetDefaultTextProperty(this->TextProperty);
+  
+  this->Mapper = vtkSmartPointer<vtkLabelPlacementMapper>::New();
+  this->Mapper->SetInputConnection(this->Hierarchy->GetOutputPort());
+  this->Mapper->SetRenderStrategy(this->RenderStrategy);
+  // Visit the labels by decreasing priority; skip those overlapping a placed one.
+  this->Mapper->SetIteratorType(vtkLabelHierarchy::FULL_SORT);
+  this->Mapper->PlaceAllLabelsOff();
+  this->Mapper->SetMaximumLabelFraction(1.0);
+  this->Mapper->UseDepthBufferOff();
+  
+  this->Actor = vtkSmartPointer<vtkActor2D>::New();
+  this->Actor->SetMapper(this->Mapper);
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelHierarchyRenderer::~vtkSlicerLabelHierarchyRenderer() = default;
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkSlicerLabelHierarchyRenderer::Enabled << "\n";
+  os << indent << "Number of labels: " << this->Labels.size() << "\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::SetEnabled(bool enabled)
+{
+  vtkSlicerLabelHierarchyRenderer::Enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelHierarchyRenderer::GetEnabled()
+{
+  return vtkSlicerLabelHierarchyRenderer::Enabled;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelHierarchyRenderer * vtkSlicerLabelHierarchyRenderer::GetLabelRenderer(vtkRenderer * renderer, bool create)
+{
+  vtkInformation * information = renderer ? renderer->GetInformation() : nullptr;
+  if (!information)
+  {
+    return nullptr;
+  }
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = vtkSlicerLabelHierarchyRenderer::SafeDownCast(
+    information->Get(vtkSlicerLabelHierarchyRenderer::LABEL_RENDERER()));
+  if (labelRenderer || !create)
+  {
+    return labelRenderer;
+  }
+  vtkNew<vtkSlicerLabelHierarchyRenderer> newLabelRenderer;
+  newLabelRenderer->Renderer = renderer;
+  information->Set(vtkSlicerLabelHierarchyRenderer::LABEL_RENDERER(), newLabelRenderer);
+  return newLabelRenderer;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::SetLabel(vtkObject * owner, const char * nodeID, const double position[3],
+                                               const char * text, double priority, vtkTextProperty * textProperty)
+{
+  if (!owner)
+  {
+    return;
+  }
+  auto found = this->LabelIndices.find(owner);
+  if (found == this->LabelIndices.end())
+  {
+    this->LabelIndices[owner] = this->Labels.size();
+    this->Labels.emplace_back();
+    found = this->LabelIndices.find(owner);
+  }
+  Label& label = this->Labels[found->second];
+  label.Owner = owner;
+  label.NodeID = nodeID ? nodeID : "";
+  for (int i = 0; i < 3; i++)
+  {
+    label.Position[i] = position[i];
+  }
+  label.Text = text ? text : "";
+  label.Priority = priority;
+  label.TextProperty = textProperty;
+  this->LabelsModified = true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::SetLabelVisibility(vtkObject * owner, bool visible)
+{
+  auto found = this->LabelIndices.find(owner);
+  if (found == this->LabelIndices.end() || this->Labels[found->second].Visible == visible)
+  {
+    return;
+  }
+  this->Labels[found->second].Visible = visible;
+  this->LabelsModified = true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::RemoveLabel(vtkObject * owner)
+{
+  auto found = this->LabelIndices.find(owner);
+  if (found == this->LabelIndices.end())
+  {
+    return;
+  }
+  // Move the last label into the freed slot.
+  const size_t index = found->second;
+  this->LabelIndices.erase(found);
+  if (index != this->Labels.size() - 1)
+  {
+    this->Labels[index] = this->Labels.back();
+    this->LabelIndices[this->Labels[index].Owner] = index;
+  }
+  this->Labels.pop_back();
+  this->LabelsModified = true;
+  
+  if (this->Labels.empty())
+  {
+    // The caller may hold this pointer; it is only valid until this returns.
+    vtkSmartPointer<vtkSlicerLabelHierarchyRenderer> keepAlive = this;
+    this->Renderer->GetInformation()->Remove(vtkSlicerLabelHierarchyRenderer::LABEL_RENDERER());
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelHierarchyRenderer::HasLabel(vtkObject * owner) const
+{
+  return this->LabelIndices.find(owner) != this->LabelIndices.end();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelHierarchyRenderer::IsRenderingOwner(vtkObject * owner) const
+{
+  return !this->Labels.empty() && this->Labels.front().Owner == owner;
+}
+
+//------------------------------------------------------------------------------
+vtkActor2D * vtkSlicerLabelHierarchyRenderer::GetActor()
+{
+  return this->Actor;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::UpdateLabels()
+{
+  if (!this->LabelsModified)
+  {
+    return;
+  }
+  const vtkIdType numberOfLabels = static_cast<vtkIdType>(std::count_if(this->Labels.begin(),
+    this->Labels.end(), [](const Label& label) { return label.Visible; }));
+  vtkNew<vtkPoints> anchors;
+  anchors->SetNumberOfPoints(numberOfLabels);
+  vtkNew<vtkStringArray> texts;
+  texts->SetName("LabelText");
+  texts->SetNumberOfValues(numberOfLabels);
+  vtkNew<vtkDoubleArray> priorities;
+  priorities->SetName("Priority");
+  priorities->SetNumberOfTuples(numberOfLabels);
+  // One type per distinct text property; labels sharing a text property share a type.
+  vtkLabelTypeRenderStrategy * renderStrategy = static_cast<vtkLabelTypeRenderStrategy*>(this->RenderStrategy.GetPointer());
+  renderStrategy->TextProperties.clear();
+  std::map<vtkTextProperty*, size_t> types;
+  vtkIdType i = 0;
+  for (const Label& label : this->Labels)
+  {
+    if (!label.Visible)
+    {
+      continue;
+    }
+    anchors->SetPoint(i, label.Position);
+    if (label.TextProperty)
+    {
+      auto type = types.emplace(label.TextProperty, types.size());
+      if (type.second)
+      {
+        renderStrategy->TextProperties.push_back(label.TextProperty);
+      }
+      texts->SetValue(i, vtkLabelTypeRenderStrategy::EncodeText(type.first->second, label.Text));
+    }
+    else
+    {
+      texts->SetValue(i, label.Text);
+    }
+    priorities->SetValue(i, label.Priority);
+    i++;
+  }
+  this->Anchors->Initialize();
+  this->Anchors->SetPoints(anchors);
+  this->Anchors->GetPointData()->AddArray(texts);
+  this->Anchors->GetPointData()->AddArray(priorities);
+  this->Anchors->Modified();
+  this->LabelsModified = false;
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerLabelHierarchyRenderer::RenderOverlay(vtkViewport * viewport)
+{
+  this->UpdateLabels();
+  if (this->Labels.empty())
+  {
+    return 0;
+  }
+  return this->Actor->RenderOverlay(viewport);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelHierarchyRenderer::ReleaseGraphicsResources(vtkWindow * window)
+{
+  this->Actor->ReleaseGraphicsResources(window);
+}
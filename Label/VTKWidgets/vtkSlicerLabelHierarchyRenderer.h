@@ -0,0 +1,134 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkslicerlabelhierarchyrenderer_h_
+#define __vtkslicerlabelhierarchyrenderer_h_
+
+#include "vtkSlicerLabelModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkActor2D;
+class vtkFreeTypeLabelRenderStrategy;
+class vtkInformationObjectBaseKey;
+class vtkLabelPlacementMapper;
+class vtkPointSetToLabelHierarchy;
+class vtkPolyData;
+class vtkRenderer;
+class vtkTextProperty;
+class vtkViewport;
+class vtkWindow;
+
+/**
+ * @class   vtkSlicerLabelHierarchyRenderer
+ * @brief   Draws the texts of all labels of a 3D renderer with one label mapper
+ *
+ * Representations register their text with a world anchor and a priority,
+ * and hide their own text actor. The anchors of a renderer are sorted in a
+ * label hierarchy; a vtkLabelPlacementMapper draws, in priority order, only
+ * the texts that do not overlap already placed ones, in one actor that the
+ * first registered representation renders. Each text is drawn with the
+ * text property of its representation, so it keeps its colour, opacity and
+ * size. Arrows and control points remain drawn and picked by each
+ * representation. The label renderer is kept in the information of its
+ * renderer, so it lives and dies with that view.
+ *
+ * The renderer is global and off by default; see vtkSlicerLabelLogic.
+*/
+class VTK_SLICER_LABEL_MODULE_VTKWIDGETS_EXPORT vtkSlicerLabelHierarchyRenderer
+: public vtkObject
+{
+public:
+  static vtkSlicerLabelHierarchyRenderer* New();
+  vtkTypeMacro(vtkSlicerLabelHierarchyRenderer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+
+  // The label renderer shared by all representations of a renderer; created on request.
+  static vtkSlicerLabelHierarchyRenderer * GetLabelRenderer(vtkRenderer * renderer, bool create = true);
+
+  // Add or update the label of 'owner'. Labels of higher priority are placed first.
+  void SetLabel(vtkObject * owner, const char * nodeID, const double position[3],
+                const char * text, double priority, vtkTextProperty * textProperty);
+  // Hide the label of 'owner' without removing it, e.g. by level of detail.
+  void SetLabelVisibility(vtkObject * owner, bool visible);
+  // Forget the label of 'owner', if any. The label renderer may be deleted.
+  void RemoveLabel(vtkObject * owner);
+  bool HasLabel(vtkObject * owner) const;
+  int GetNumberOfLabels() const { return static_cast<int>(this->Labels.size()); }
+
+  // Only the first registered representation renders the shared actor.
+  bool IsRenderingOwner(vtkObject * owner) const;
+  vtkActor2D * GetActor();
+
+  int RenderOverlay(vtkViewport * viewport);
+  void ReleaseGraphicsResources(vtkWindow * window);
+
+protected:
+  vtkSlicerLabelHierarchyRenderer();
+  ~vtkSlicerLabelHierarchyRenderer() override;
+
+  // Rebuild the anchors if a label changed.
+  void UpdateLabels();
+
+  struct Label
+  {
+    vtkObject * Owner = nullptr;
+    std::string NodeID;
+    double Position[3] = { 0.0, 0.0, 0.0 };
+    std::string Text;
+    double Priority = 0.0;
+    vtkSmartPointer<vtkTextProperty> TextProperty;
+    bool Visible = true;
+  };
+  std::vector<Label> Labels;
+  std::map<vtkObject*, size_t> LabelIndices;
+  bool LabelsModified = false;
+
+  vtkSmartPointer<vtkPolyData> Anchors;
+  // Used for labels without a text property.
+  vtkSmartPointer<vtkTextProperty> TextProperty;
+  vtkSmartPointer<vtkPointSetToLabelHierarchy> Hierarchy;
+  vtkSmartPointer<vtkFreeTypeLabelRenderStrategy> RenderStrategy;
+  vtkSmartPointer<vtkLabelPlacementMapper> Mapper;
+  vtkSmartPointer<vtkActor2D> Actor;
+
+  // Holds this label renderer in its information.
+  vtkRenderer * Renderer = nullptr;
+
+private:
+  // Key of the label renderer in the information of its renderer.
+  static vtkInformationObjectBaseKey * LABEL_RENDERER();
+  static bool Enabled;
+
+  vtkSlicerLabelHierarchyRenderer(const vtkSlicerLabelHierarchyRenderer&) = delete;
+  void operator=(const vtkSlicerLabelHierarchyRenderer&) = delete;
+};
+
+#endif // __vtkslicerlabelhierarchyrenderer_h_
@@ -19,6 +19,7 @@
 ==============================================================================*/
 
 #include "vtkSlicerLabelRepresentation2D.h"
+#include "vtkSlicerLabelWidget.h"
 
 #include <vtkActor2D.h>
 #include <vtkGlyphSource2D.h>
@@ -29,6 +30,7 @@
 #include <cmath>
 
 #include "vtkMRMLMarkupsLabelNode.h"
+#include "vtkMRMLMarkupsProfiler.h"
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerLabelRepresentation2D);
@@ -68,6 +70,7 @@ void vtkSlicerLabelRepresentation2D::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------
 void vtkSlicerLabelRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Update2D");
   this->Superclass::UpdateFromMRML(caller, event, callData);
   this->NeedToRenderOn();
   
@@ -79,6 +82,7 @@ void vtkSlicerLabelRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigne
   
   this->LineActor->SetVisibility(false);
   this->TextActor->SetVisibility(false);
+  this->ProjectedArrowSize = 0.0;
   switch (markupsNode->GetNumberOfDefinedControlPoints(true))
   {
     case 1:
@@ -90,11 +94,60 @@ void vtkSlicerLabelRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigne
     default:
       vtkErrorMacro("Number of control points out of range.");
   }
+  // Slice view changes update all representations : no separate observation is needed.
+  if (this->ProjectedArrowSize > 0.0
+    && vtkSlicerLabelWidget::GetLevelOfDetailThresholds(this->GetViewNode(), this->LevelOfDetailThresholds))
+  {
+    this->ApplyLevelOfDetail(vtkSlicerLabelWidget::GetLevelOfDetail(this->ProjectedArrowSize,
+      this->LevelOfDetailThresholds));
+  }
+}
+
+// -----------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation2D::ApplyLevelOfDetail(int levelOfDetail)
+{
+  if (levelOfDetail == vtkSlicerLabelWidget::LevelOfDetailFull)
+  {
+    return;
+  }
+  this->LineActor->SetVisibility(false);
+  this->TextActor->SetVisibility(false);
+  vtkMRMLMarkupsDisplayNode * displayNode = this->GetMarkupsDisplayNode();
+  for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; controlPointType++)
+  {
+    ControlPointsPipeline2D * pipeline = this->GetControlPointsPipeline(controlPointType);
+    if (levelOfDetail == vtkSlicerLabelWidget::LevelOfDetailHidden)
+    {
+      pipeline->Actor->SetVisibility(false);
+      pipeline->LabelsActor->SetVisibility(false);
+    }
+    else if (displayNode)
+    {
+      // As in 3D, the arrow glyphs become the control point glyphs of the display node.
+      pipeline->GlyphSource2D->SetGlyphType(displayNode->GetGlyphType());
+      pipeline->GlyphSource2D->SetRotationAngle(0.0);
+      pipeline->GlyphSource2D->SetScale(1.0);
+      pipeline->GlyphSource2D->Update();
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation2D::UpdateLabelTextFromMRML()
+{
+  vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(this->GetMarkupsNode());
+  if (!labelNode)
+  {
+    return;
+  }
+  this->TextActor->SetInput(labelNode->GetLabel());
+  this->NeedToRenderOn();
 }
 
 // -----------------------------------------------------------------------------
 void vtkSlicerLabelRepresentation2D::UpdateTagFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData /*=nullptr*/)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Tag");
   vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
   if (!markupsNode || markupsNode->GetNumberOfDefinedControlPoints(true) != 1)
   {
@@ -124,6 +177,7 @@ void vtkSlicerLabelRepresentation2D::UpdateTagFromMRML(vtkMRMLNode* caller, unsi
 // -----------------------------------------------------------------------------
 void vtkSlicerLabelRepresentation2D::UpdatePointerFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData /*=nullptr*/)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Pointer");
   vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
   if (!markupsNode || markupsNode->GetNumberOfDefinedControlPoints(true) != 2)
   {
@@ -149,6 +203,7 @@ void vtkSlicerLabelRepresentation2D::UpdatePointerFromMRML(vtkMRMLNode* caller,
   this->LineSource->SetPoint1(p1);
   this->LineSource->SetPoint2(p2);
   this->LineSource->Update();
+  this->ProjectedArrowSize = std::sqrt((p2[0] - p1[0]) * (p2[0] - p1[0]) + (p2[1] - p1[1]) * (p2[1] - p1[1]));
   
   this->LineActor->SetVisibility(true);
   this->TextActor->SetVisibility(true);
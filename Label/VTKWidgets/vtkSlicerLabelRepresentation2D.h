@@ -74,6 +74,8 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
   void UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData=nullptr) override;
+  // Only set the text; see vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent.
+  void UpdateLabelTextFromMRML();
 
   /// Methods to make this class behave as a vtkProp.
   void GetActors(vtkPropCollection *) override;
@@ -97,6 +99,13 @@ protected:
   vtkSmartPointer<vtkLineSource> LineSource;
   vtkSmartPointer<vtkPolyDataMapper2D> LineMapper;
   vtkSmartPointer<vtkActor2D> LineActor;
+  
+  // See vtkSlicerLabelWidget::SetLevelOfDetailThresholds().
+  void ApplyLevelOfDetail(int levelOfDetail);
+  // Read from the slice node on each update.
+  double LevelOfDetailThresholds[2] = { 0.0, 0.0 };
+  // Length of the arrow in pixels, 0 for a tag.
+  double ProjectedArrowSize = 0.0;
 
 private:
   vtkSlicerLabelRepresentation2D(const vtkSlicerLabelRepresentation2D&) = delete;
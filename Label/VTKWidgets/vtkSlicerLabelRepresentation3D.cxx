@@ -19,11 +19,16 @@
 ==============================================================================*/
 
 #include "vtkSlicerLabelRepresentation3D.h"
+#include "vtkSlicerLabelArrowInstancer.h"
+#include "vtkSlicerLabelHierarchyRenderer.h"
+#include "vtkSlicerLabelWidget.h"
 
 #include "vtkMRMLMarkupsLabelNode.h"
+#include "vtkMRMLMarkupsProfiler.h"
 
 // VTK includes
 #include <vtkActor.h>
+#include <vtkActor2D.h>
 #include <vtkPlane.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkDiscretizableColorTransferFunction.h>
@@ -32,37 +37,51 @@
 #include <vtkTextActor.h>
 #include <vtkTextProperty.h>
 #include <vtkGlyph3DMapper.h>
+#include <vtkMatrix4x4.h>
 #include <vtkRenderer.h>
 #include <vtkCamera.h>
 
+// STD includes
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerLabelRepresentation3D);
 
 //------------------------------------------------------------------------------
 vtkSlicerLabelRepresentation3D::vtkSlicerLabelRepresentation3D()
 {
-  this->LineSource = vtkSmartPointer<vtkLineSource>::New();
-  this->ConeSource = vtkSmartPointer<vtkConeSource>::New();
-  this->AppendedArrow = vtkSmartPointer<vtkAppendPolyData>::New();
+  this->ShaftMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  this->ShaftMapper->SetInputData(vtkSlicerLabelArrowInstancer::GetUnitShaft());
+  this->ShaftMapper->SetScalarVisibility(true);
   
-  this->AppendedArrow->AddInputConnection(this->LineSource->GetOutputPort());
-  this->AppendedArrow->AddInputConnection(this->ConeSource->GetOutputPort());
+  this->ShaftActor = vtkSmartPointer<vtkActor>::New();
+  this->ShaftActor->SetMapper(this->ShaftMapper);
+  this->ShaftActor->SetProperty(this->GetControlPointsPipeline(Unselected)->Property);
+  this->ShaftActor->SetUserMatrix(vtkSmartPointer<vtkMatrix4x4>::New());
   
-  this->ArrowMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  this->ArrowMapper->SetInputConnection(this->AppendedArrow->GetOutputPort());
-  this->ArrowMapper->SetScalarVisibility(true);
+  this->TipMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  this->TipMapper->SetInputData(vtkSlicerLabelArrowInstancer::GetUnitCone());
+  this->TipMapper->SetScalarVisibility(true);
   
-  this->ArrowActor = vtkSmartPointer<vtkActor>::New();
-  this->ArrowActor->SetMapper(this->ArrowMapper);
-  this->ArrowActor->SetProperty(this->GetControlPointsPipeline(Unselected)->Property);
+  this->TipActor = vtkSmartPointer<vtkActor>::New();
+  this->TipActor->SetMapper(this->TipMapper);
+  this->TipActor->SetProperty(this->GetControlPointsPipeline(Unselected)->Property);
+  this->TipActor->SetUserMatrix(vtkSmartPointer<vtkMatrix4x4>::New());
   
   this->TextActor->SetTextProperty(this->GetControlPointsPipeline(Unselected)->TextProperty);
-  this->ConeSource->SetAngle(30.0);
+  
+  this->CameraCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->CameraCallback->SetClientData(reinterpret_cast<void *>(this));
+  this->CameraCallback->SetCallback(vtkSlicerLabelRepresentation3D::OnCameraModified);
+  this->LevelOfDetail = vtkSlicerLabelWidget::LevelOfDetailFull;
 }
 
 //------------------------------------------------------------------------------
 vtkSlicerLabelRepresentation3D::~vtkSlicerLabelRepresentation3D()
 {
+  this->RemoveHierarchyLabel();
+  this->RemoveArrowInstance();
+  this->ObserveCamera(nullptr);
 }
 
 //------------------------------------------------------------------------------
@@ -70,9 +89,9 @@ void vtkSlicerLabelRepresentation3D::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
   
-  if (this->ArrowActor)
+  if (this->ShaftActor && this->TipActor)
   {
-    os << indent << "Arrow Visibility: " << this->ArrowActor->GetVisibility() << "\n";
+    os << indent << "Arrow Visibility: " << (this->ShaftActor->GetVisibility() && this->TipActor->GetVisibility()) << "\n";
   }
   else
   {
@@ -85,8 +104,20 @@ void vtkSlicerLabelRepresentation3D::GetActors(vtkPropCollection* pc)
 {
   this->Superclass::GetActors(pc);
 
-  this->ArrowActor->GetActors(pc);
+  this->ShaftActor->GetActors(pc);
+  this->TipActor->GetActors(pc);
   this->TextActor->GetActors(pc);
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+  {
+    instancer->GetShaftActor()->GetActors(pc);
+    instancer->GetConeActor()->GetActors(pc);
+  }
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = this->GetLabelHierarchyRenderer();
+  if (labelRenderer && labelRenderer->IsRenderingOwner(this))
+  {
+    labelRenderer->GetActor()->GetActors(pc);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -94,8 +125,19 @@ void vtkSlicerLabelRepresentation3D::ReleaseGraphicsResources(vtkWindow* win)
 {
   this->Superclass::ReleaseGraphicsResources(win);
 
-  this->ArrowActor->ReleaseGraphicsResources(win);
+  this->ShaftActor->ReleaseGraphicsResources(win);
+  this->TipActor->ReleaseGraphicsResources(win);
   this->TextActor->ReleaseGraphicsResources(win);
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+  {
+    instancer->ReleaseGraphicsResources(win);
+  }
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = this->GetLabelHierarchyRenderer();
+  if (labelRenderer && labelRenderer->IsRenderingOwner(this))
+  {
+    labelRenderer->ReleaseGraphicsResources(win);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -103,14 +145,23 @@ int vtkSlicerLabelRepresentation3D::RenderOverlay(vtkViewport* viewport)
 {
   int count = this->Superclass::RenderOverlay(viewport);
 
-  if (this->ArrowActor->GetVisibility())
+  if (this->ShaftActor->GetVisibility())
+    {
+    count += this->ShaftActor->RenderOverlay(viewport);
+    }
+  if (this->TipActor->GetVisibility())
     {
-    count += this->ArrowActor->RenderOverlay(viewport);
+    count += this->TipActor->RenderOverlay(viewport);
     }
   if (this->TextActor->GetVisibility())
     {
       count += this->TextActor->RenderOverlay(viewport);
     }
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = this->GetLabelHierarchyRenderer();
+  if (labelRenderer && labelRenderer->IsRenderingOwner(this))
+  {
+    count += labelRenderer->RenderOverlay(viewport);
+  }
   return count;
 }
 
@@ -119,9 +170,18 @@ int vtkSlicerLabelRepresentation3D::RenderOpaqueGeometry(vtkViewport* viewport)
 {
   int count = this->Superclass::RenderOpaqueGeometry(viewport);
 
-  if (this->ArrowActor->GetVisibility())
+  if (this->ShaftActor->GetVisibility())
+    {
+    count += this->ShaftActor->RenderOpaqueGeometry(viewport);
+    }
+  if (this->TipActor->GetVisibility())
+    {
+    count += this->TipActor->RenderOpaqueGeometry(viewport);
+    }
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
     {
-    count += this->ArrowActor->RenderOpaqueGeometry(viewport);
+    count += instancer->RenderOpaqueGeometry(viewport);
     }
   if (this->TextActor->GetVisibility())
     {
@@ -136,10 +196,20 @@ int vtkSlicerLabelRepresentation3D::RenderTranslucentPolygonalGeometry(vtkViewpo
 {
   int count = this->Superclass::RenderTranslucentPolygonalGeometry(viewport);
 
-  if (this->ArrowActor->GetVisibility())
+  if (this->ShaftActor->GetVisibility())
     {
-    this->ArrowActor->SetPropertyKeys(this->GetPropertyKeys());
-    count += this->ArrowActor->RenderTranslucentPolygonalGeometry(viewport);
+    this->ShaftActor->SetPropertyKeys(this->GetPropertyKeys());
+    count += this->ShaftActor->RenderTranslucentPolygonalGeometry(viewport);
+    }
+  if (this->TipActor->GetVisibility())
+    {
+    this->TipActor->SetPropertyKeys(this->GetPropertyKeys());
+    count += this->TipActor->RenderTranslucentPolygonalGeometry(viewport);
+    }
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+    {
+    count += instancer->RenderTranslucentPolygonalGeometry(viewport);
     }
   if (this->TextActor->GetVisibility())
     {
@@ -158,8 +228,19 @@ vtkTypeBool vtkSlicerLabelRepresentation3D::HasTranslucentPolygonalGeometry()
     return true;
     }
 
-  if (this->ArrowActor->GetVisibility() &&
-      this->ArrowActor->HasTranslucentPolygonalGeometry())
+  if (this->ShaftActor->GetVisibility() &&
+      this->ShaftActor->HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  if (this->TipActor->GetVisibility() &&
+      this->TipActor->HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer && instancer->IsRenderingOwner(this) &&
+      instancer->HasTranslucentPolygonalGeometry())
     {
     return true;
     }
@@ -175,21 +256,31 @@ vtkTypeBool vtkSlicerLabelRepresentation3D::HasTranslucentPolygonalGeometry()
 //----------------------------------------------------------------------
 void vtkSlicerLabelRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Update3D");
   this->Superclass::UpdateFromMRML(caller, event, callData);
   this->NeedToRenderOn();
+  this->LevelOfDetailEnabled = vtkSlicerLabelWidget::GetLevelOfDetailThresholds(this->GetViewNode(),
+    this->LevelOfDetailThresholds);
 
   vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
   if (!markupsNode || markupsNode->GetNumberOfDefinedControlPoints(true) == 0)
   {
+    this->RemoveHierarchyLabel();
+    this->RemoveArrowInstance();
+    this->ObserveCamera(nullptr);
     return;
   }
   
-  this->ArrowActor->SetVisibility(false);
+  this->ShaftActor->SetVisibility(false);
+  this->TipActor->SetVisibility(false);
   this->TextActor->SetVisibility(false);
+  this->HasArrow = false;
+  this->TipFollowsViewScale = false;
   switch (markupsNode->GetNumberOfDefinedControlPoints(true))
   {
     case 1:
       this->UpdateTagFromMRML(caller, event, callData);
+      this->RemoveArrowInstance();
       break;
     case 2:
       this->UpdatePointerFromMRML(caller, event, callData);
@@ -197,6 +288,32 @@ void vtkSlicerLabelRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller, unsigne
     default:
       vtkErrorMacro("Number of control points out of range.");
   }
+  this->UpdateHierarchyLabel();
+  this->SaveFullDetail();
+  this->LevelOfDetail = this->ComputeLevelOfDetail();
+  this->ApplyLevelOfDetail();
+  
+  const bool followCamera = this->TipFollowsViewScale || this->LevelOfDetailEnabled;
+  this->ObserveCamera((followCamera && this->GetRenderer()) ? this->GetRenderer()->GetActiveCamera() : nullptr);
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::UpdateLabelTextFromMRML()
+{
+  vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(this->GetMarkupsNode());
+  if (!labelNode)
+  {
+    return;
+  }
+  this->TextActor->SetInput(labelNode->GetLabel());
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = this->GetLabelHierarchyRenderer();
+  if (labelRenderer && labelRenderer->HasLabel(this))
+  {
+    const double priority = this->GetAllControlPointsSelected() ? 1.0 : 0.0;
+    labelRenderer->SetLabel(this, labelNode->GetID(), this->TextActorPositionWorld,
+      labelNode->GetLabel(), priority, this->TextActor->GetTextProperty());
+  }
+  this->NeedToRenderOn();
 }
 
 //----------------------------------------------------------------------
@@ -204,6 +321,7 @@ void vtkSlicerLabelRepresentation3D::UpdateTagFromMRML(vtkMRMLNode* caller,
                                                     unsigned long event,
                                                     void *callData /*=nullptr*/)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Tag");
   vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
   if (!markupsNode || markupsNode->GetNumberOfDefinedControlPoints() != 1)
   {
@@ -235,6 +353,7 @@ void vtkSlicerLabelRepresentation3D::UpdatePointerFromMRML(vtkMRMLNode* caller,
                                                            unsigned long event,
                                                            void *callData /*=nullptr*/)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Pointer");
   vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
   if (!markupsNode || markupsNode->GetNumberOfDefinedControlPoints(true) != 2)
   {
@@ -246,9 +365,6 @@ void vtkSlicerLabelRepresentation3D::UpdatePointerFromMRML(vtkMRMLNode* caller,
   double p2[3] = { 0.0 };
   markupsNode->GetNthControlPointPositionWorld(0, p1);
   markupsNode->GetNthControlPointPositionWorld(1, p2);
-  double direction[3] = { 0.0 };
-  vtkMath::Subtract(p2, p1, direction);
-  
   const double lineLength = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   double radius = 6.0 * this->ViewScaleFactorMmPerPixel;
 
@@ -266,40 +382,30 @@ void vtkSlicerLabelRepresentation3D::UpdatePointerFromMRML(vtkMRMLNode* caller,
       vtkErrorMacro("Unknown 3D tip dimension mode, using default.");
       break;
   }
-  const double height = 3.0 * radius;
-  
-  this->LineSource->SetPoint1(p1);
-  this->LineSource->SetPoint2(p2);
-  this->LineSource->Update();
-  this->ConeSource->SetCenter(p2);
-  this->ConeSource->SetRadius(radius);
-  this->ConeSource->SetHeight(height);
-  this->ConeSource->SetResolution(45);
-  this->ConeSource->SetDirection(direction);
-  this->ConeSource->Update();
   
-  // p1, the center (tip) of the cone, has always id 0.
-  vtkIdType closestIdToP2 = this->ConeSource->GetOutput()->FindPoint(p1);
-  // If the tip is closest, it's inversely oriented.
-  if (closestIdToP2 == 0)
+  // Only the user matrices change : the meshes are shared by all labels.
+  vtkSlicerLabelArrowInstancer::PlaceArrow(p1, p2, radius,
+    this->ShaftActor->GetUserMatrix(), this->TipActor->GetUserMatrix());
+  for (int i = 0; i < 3; i++)
   {
-    // Invert direction.
-    vtkMath::Subtract(p1, p2, direction);
-    this->ConeSource->SetDirection(direction);
-    this->ConeSource->Update();
+    this->ArrowStart[i] = p1[i];
+    this->ArrowEnd[i] = p2[i];
   }
-  
-  this->AppendedArrow->Update();
+  this->HasArrow = true;
+  this->TipFollowsViewScale = labelNode->GetTipDimensionMode3D() == vtkMRMLMarkupsLabelNode::ViewScaleFactor;
   this->TextActor->SetInput(labelNode->GetLabel());
   this->TextActorPositionWorld[0] = labelNode->GetLabelLocation() == 0 ? p1[0] : p2[0];
   this->TextActorPositionWorld[1] = labelNode->GetLabelLocation() == 0 ? p1[1] : p2[1];
   this->TextActorPositionWorld[2] = labelNode->GetLabelLocation() == 0 ? p1[2] : p2[2];
   
-  this->ArrowActor->SetVisibility(true);
+  this->ShaftActor->SetVisibility(true);
+  this->TipActor->SetVisibility(true);
   this->TextActor->SetVisibility(true);
   
   int controlPointType = this->GetAllControlPointsSelected() ? Selected : Unselected;
-  this->ArrowActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
+  this->ShaftActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
+  this->TipActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
+  this->UpdateArrowInstance(p1, p2, radius);
   this->TextActor->SetTextProperty(this->GetControlPointsPipeline(controlPointType)->TextProperty);
 
   //Hide a control point by decreasing its size.
@@ -312,8 +418,233 @@ void vtkSlicerLabelRepresentation3D::UpdatePointerFromMRML(vtkMRMLNode* caller,
 double * vtkSlicerLabelRepresentation3D::GetBounds()
 {
   vtkBoundingBox boundingBox;
-  const std::vector<vtkProp*> actors({ this->ArrowActor });
+  const std::vector<vtkProp*> actors({ this->ShaftActor, this->TipActor });
   this->AddActorsBounds(boundingBox, actors, Superclass::GetBounds());
   boundingBox.GetBounds(this->Bounds);
   return this->Bounds;
 }
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelHierarchyRenderer * vtkSlicerLabelRepresentation3D::GetLabelHierarchyRenderer() const
+{
+  return vtkSlicerLabelHierarchyRenderer::GetLabelRenderer(this->HierarchyRenderer, false);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::UpdateHierarchyLabel()
+{
+  // The text is drawn by the renderer's label hierarchy rather than by TextActor.
+  vtkRenderer * renderer = this->GetRenderer();
+  vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(this->GetMarkupsNode());
+  if (!vtkSlicerLabelHierarchyRenderer::GetEnabled() || !renderer || !labelNode
+    || !this->GetVisibility() || !this->TextActor->GetVisibility())
+  {
+    this->RemoveHierarchyLabel();
+    return;
+  }
+  if (this->HierarchyRenderer && this->HierarchyRenderer != renderer)
+  {
+    this->RemoveHierarchyLabel();
+  }
+  // Selected labels are placed first.
+  const double priority = this->GetAllControlPointsSelected() ? 1.0 : 0.0;
+  vtkSlicerLabelHierarchyRenderer::GetLabelRenderer(renderer)->SetLabel(this, labelNode->GetID(),
+    this->TextActorPositionWorld, labelNode->GetLabel(), priority, this->TextActor->GetTextProperty());
+  this->HierarchyRenderer = renderer;
+  this->TextActor->SetVisibility(false);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::RemoveHierarchyLabel()
+{
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = this->GetLabelHierarchyRenderer();
+  if (labelRenderer)
+  {
+    labelRenderer->RemoveLabel(this);
+  }
+  this->HierarchyRenderer = nullptr;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerLabelArrowInstancer * vtkSlicerLabelRepresentation3D::GetArrowInstancer() const
+{
+  return vtkSlicerLabelArrowInstancer::GetInstancer(this->InstancedRenderer, false);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::UpdateArrowInstance(const double p1[3], const double p2[3], double radius)
+{
+  // The arrow is drawn by the renderer's instancer rather than by ShaftActor and TipActor.
+  vtkRenderer * renderer = this->GetRenderer();
+  vtkMRMLMarkupsNode * markupsNode = this->GetMarkupsNode();
+  if (!vtkSlicerLabelArrowInstancer::GetEnabled() || !renderer || !markupsNode || !this->GetVisibility())
+  {
+    this->RemoveArrowInstance();
+    return;
+  }
+  if (this->InstancedRenderer && this->InstancedRenderer != renderer)
+  {
+    this->RemoveArrowInstance();
+  }
+  vtkProperty * property = this->TipActor->GetProperty();
+  vtkSlicerLabelArrowInstancer::GetInstancer(renderer)->SetInstance(this, markupsNode->GetID(),
+    p1, p2, radius, property->GetColor(), property->GetOpacity());
+  this->InstancedRenderer = renderer;
+  this->ShaftActor->SetVisibility(false);
+  this->TipActor->SetVisibility(false);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::RemoveArrowInstance()
+{
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer)
+  {
+    instancer->RemoveInstance(this);
+  }
+  this->InstancedRenderer = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::ObserveCamera(vtkCamera * camera)
+{
+  if (this->ObservedCamera == camera)
+  {
+    return;
+  }
+  if (this->ObservedCamera)
+  {
+    this->ObservedCamera->RemoveObserver(this->CameraObserverTag);
+  }
+  this->ObservedCamera = camera;
+  this->CameraObserverTag = camera ? camera->AddObserver(vtkCommand::ModifiedEvent, this->CameraCallback) : 0;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::OnCameraModified(vtkObject * vtkNotUsed(caller),
+                                                      unsigned long vtkNotUsed(event),
+                                                      void * clientData, void * vtkNotUsed(callData))
+{
+  vtkSlicerLabelRepresentation3D * self = reinterpret_cast<vtkSlicerLabelRepresentation3D*>(clientData);
+  self->UpdateTipScale();
+  const int levelOfDetail = self->ComputeLevelOfDetail();
+  if (levelOfDetail == self->LevelOfDetail)
+  {
+    return;
+  }
+  // Only visibilities change; the render may already be in progress, so request another.
+  self->LevelOfDetail = levelOfDetail;
+  self->ApplyLevelOfDetail();
+  self->NeedToRenderOn();
+  vtkSlicerLabelWidget::RequestRender(self->GetRenderer());
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::UpdateTipScale()
+{
+  // The camera is also modified while rendering, e.g. by clipping range resets : the scale is then unchanged.
+  const double previousScaleFactor = this->ViewScaleFactorMmPerPixel;
+  this->UpdateViewScaleFactor();
+  if (!this->HasArrow || !this->TipFollowsViewScale || this->ViewScaleFactorMmPerPixel == previousScaleFactor)
+  {
+    return;
+  }
+  const double radius = 6.0 * this->ViewScaleFactorMmPerPixel;
+  vtkSlicerLabelArrowInstancer::PlaceArrow(this->ArrowStart, this->ArrowEnd, radius,
+    nullptr, this->TipActor->GetUserMatrix());
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer)
+  {
+    instancer->SetInstanceConeRadius(this, radius);
+  }
+  this->NeedToRenderOn();
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerLabelRepresentation3D::ComputeLevelOfDetail()
+{
+  vtkRenderer * renderer = this->GetRenderer();
+  vtkCamera * camera = renderer ? renderer->GetActiveCamera() : nullptr;
+  if (!this->LevelOfDetailEnabled || !camera)
+  {
+    return vtkSlicerLabelWidget::LevelOfDetailFull;
+  }
+  const double * start = this->HasArrow ? this->ArrowStart : this->TextActorPositionWorld;
+  const double * end = this->HasArrow ? this->ArrowEnd : this->TextActorPositionWorld;
+  double cameraPosition[3] = { 0.0 };
+  double directionOfProjection[3] = { 0.0 };
+  camera->GetPosition(cameraPosition);
+  camera->GetDirectionOfProjection(directionOfProjection);
+  double toStart[3] = { 0.0 };
+  double toEnd[3] = { 0.0 };
+  vtkMath::Subtract(start, cameraPosition, toStart);
+  vtkMath::Subtract(end, cameraPosition, toEnd);
+  const double startDepth = vtkMath::Dot(toStart, directionOfProjection);
+  const double endDepth = vtkMath::Dot(toEnd, directionOfProjection);
+  const bool parallelProjection = camera->GetParallelProjection();
+  if (!parallelProjection && startDepth <= 0.0 && endDepth <= 0.0)
+  {
+    return vtkSlicerLabelWidget::LevelOfDetailHidden;
+  }
+  if (!this->HasArrow)
+  {
+    return vtkSlicerLabelWidget::LevelOfDetailFull;
+  }
+  // The view scale factor applies at the focal point; scale it to the depth of the arrow.
+  double mmPerPixel = this->ViewScaleFactorMmPerPixel;
+  if (!parallelProjection && camera->GetDistance() > 0.0)
+  {
+    mmPerPixel *= std::max(0.5 * (startDepth + endDepth), 0.0) / camera->GetDistance();
+  }
+  if (mmPerPixel <= 0.0)
+  {
+    return vtkSlicerLabelWidget::LevelOfDetailFull;
+  }
+  const double projectedSize = std::sqrt(vtkMath::Distance2BetweenPoints(start, end)) / mmPerPixel;
+  return vtkSlicerLabelWidget::GetLevelOfDetail(projectedSize, this->LevelOfDetailThresholds);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::SaveFullDetail()
+{
+  this->FullDetail.Shaft = this->ShaftActor->GetVisibility();
+  this->FullDetail.Tip = this->TipActor->GetVisibility();
+  this->FullDetail.Text = this->TextActor->GetVisibility();
+  for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; controlPointType++)
+  {
+    ControlPointsPipeline3D * pipeline = this->GetControlPointsPipeline(controlPointType);
+    this->FullDetail.ControlPoints[controlPointType] = pipeline->Actor->GetVisibility();
+    this->FullDetail.ControlPointLabels[controlPointType] = pipeline->LabelsActor->GetVisibility();
+    this->FullDetail.GlyphScaleFactors[controlPointType] = pipeline->GlyphMapper->GetScaleFactor();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelRepresentation3D::ApplyLevelOfDetail()
+{
+  const bool full = this->LevelOfDetail == vtkSlicerLabelWidget::LevelOfDetailFull;
+  const bool hidden = this->LevelOfDetail == vtkSlicerLabelWidget::LevelOfDetailHidden;
+  this->ShaftActor->SetVisibility(full && this->FullDetail.Shaft);
+  this->TipActor->SetVisibility(full && this->FullDetail.Tip);
+  this->TextActor->SetVisibility(full && this->FullDetail.Text);
+  // Shared arrows and texts are hidden in place : the rendering owners do not change.
+  vtkSlicerLabelArrowInstancer * instancer = this->GetArrowInstancer();
+  if (instancer)
+  {
+    instancer->SetInstanceVisibility(this, full);
+  }
+  vtkSlicerLabelHierarchyRenderer * labelRenderer = this->GetLabelHierarchyRenderer();
+  if (labelRenderer)
+  {
+    labelRenderer->SetLabelVisibility(this, full);
+  }
+  for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; controlPointType++)
+  {
+    ControlPointsPipeline3D * pipeline = this->GetControlPointsPipeline(controlPointType);
+    pipeline->Actor->SetVisibility(!hidden && this->FullDetail.ControlPoints[controlPointType]);
+    pipeline->LabelsActor->SetVisibility(!hidden && this->FullDetail.ControlPointLabels[controlPointType]);
+    // The control points are otherwise shrunk to nothing.
+    pipeline->GlyphMapper->SetScaleFactor(full ? this->FullDetail.GlyphScaleFactors[controlPointType]
+                                               : this->ControlPointSize);
+  }
+}
@@ -27,9 +27,12 @@
 #include "vtkSlicerMarkupsWidgetRepresentation3D.h"
 
 // VTK includes
+#include <vtkCallbackCommand.h>
 #include <vtkWeakPointer.h>
-#include <vtkConeSource.h>
-#include <vtkLineSource.h>
+
+class vtkCamera;
+class vtkSlicerLabelArrowInstancer;
+class vtkSlicerLabelHierarchyRenderer;
 
 //------------------------------------------------------------------------------
 /**
@@ -52,6 +55,8 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
   void UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData=nullptr) override;
+  // Only set the text; see vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent.
+  void UpdateLabelTextFromMRML();
 
   /// Methods to make this class behave as a vtkProp.
   void GetActors(vtkPropCollection*) override;
@@ -70,11 +75,56 @@ protected:
   void UpdateTagFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData=nullptr);
   void UpdatePointerFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData=nullptr);
 
-  vtkSmartPointer<vtkLineSource> LineSource;
-  vtkSmartPointer<vtkConeSource> ConeSource;
-  vtkSmartPointer<vtkAppendPolyData> AppendedArrow;
-  vtkSmartPointer<vtkPolyDataMapper> ArrowMapper;
-  vtkSmartPointer<vtkActor> ArrowActor;
+  // The shaft and the tip share the unit meshes of vtkSlicerLabelArrowInstancer, placed by their user matrix.
+  vtkSmartPointer<vtkPolyDataMapper> ShaftMapper;
+  vtkSmartPointer<vtkActor> ShaftActor;
+  vtkSmartPointer<vtkPolyDataMapper> TipMapper;
+  vtkSmartPointer<vtkActor> TipActor;
+  
+  // Arrows may instead be drawn by a vtkSlicerLabelArrowInstancer shared by the renderer.
+  vtkSlicerLabelArrowInstancer * GetArrowInstancer() const;
+  void UpdateArrowInstance(const double p1[3], const double p2[3], double radius);
+  void RemoveArrowInstance();
+  vtkWeakPointer<vtkRenderer> InstancedRenderer;
+  
+  // In ViewScaleFactor mode, only the tip is rescaled when the camera is modified.
+  void ObserveCamera(vtkCamera * camera);
+  void UpdateTipScale();
+  vtkSmartPointer<vtkCallbackCommand> CameraCallback;
+  static void OnCameraModified(vtkObject * caller, unsigned long event, void * clientData, void * callData);
+  vtkWeakPointer<vtkCamera> ObservedCamera;
+  unsigned long CameraObserverTag = 0;
+  double ArrowStart[3] = { 0.0, 0.0, 0.0 };
+  double ArrowEnd[3] = { 0.0, 0.0, 0.0 };
+  bool HasArrow = false;
+  bool TipFollowsViewScale = false;
+  
+  // See vtkSlicerLabelWidget::SetLevelOfDetailThresholds(); evaluated from the cached positions only.
+  int ComputeLevelOfDetail();
+  // Read from the view node on each update.
+  double LevelOfDetailThresholds[2] = { 0.0, 0.0 };
+  bool LevelOfDetailEnabled = false;
+  // Only toggles visibilities, so that it may follow the camera.
+  void ApplyLevelOfDetail();
+  int LevelOfDetail;
+  // Visibilities and glyph scales set by the last update, restored at full detail.
+  struct FullDetailState
+  {
+    bool Shaft = false;
+    bool Tip = false;
+    bool Text = false;
+    bool ControlPoints[NumberOfControlPointTypes] = {};
+    bool ControlPointLabels[NumberOfControlPointTypes] = {};
+    double GlyphScaleFactors[NumberOfControlPointTypes] = {};
+  };
+  FullDetailState FullDetail;
+  void SaveFullDetail();
+  
+  // Texts may be drawn by a vtkSlicerLabelHierarchyRenderer shared by the renderer.
+  vtkSlicerLabelHierarchyRenderer * GetLabelHierarchyRenderer() const;
+  void UpdateHierarchyLabel();
+  void RemoveHierarchyLabel();
+  vtkWeakPointer<vtkRenderer> HierarchyRenderer;
   
 private:
   vtkSlicerLabelRepresentation3D(const vtkSlicerLabelRepresentation3D&) = delete;
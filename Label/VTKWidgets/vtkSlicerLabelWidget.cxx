@@ -24,11 +24,25 @@
 #include "vtkSlicerLabelRepresentation3D.h"
 #include "vtkSlicerLabelRepresentation2D.h"
 
+// Label MRML includes
+#include "vtkMRMLMarkupsLabelNode.h"
+
 // VTK includes
 #include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkVariant.h>
 
 // MRML includes
+#include <vtkMRMLAbstractViewNode.h>
+#include <vtkMRMLDisplayableManagerGroup.h>
+#include <vtkMRMLMarkupsDisplayNode.h>
 #include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewInteractorStyle.h>
+
+// STD includes
+#include <algorithm>
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerLabelWidget);
@@ -36,11 +50,16 @@ vtkStandardNewMacro(vtkSlicerLabelWidget);
 //------------------------------------------------------------------------------
 vtkSlicerLabelWidget::vtkSlicerLabelWidget()
 {
-
+  this->LabelTextCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->LabelTextCallback->SetClientData(reinterpret_cast<void *>(this));
+  this->LabelTextCallback->SetCallback(vtkSlicerLabelWidget::OnLabelTextModified);
 }
 
 //------------------------------------------------------------------------------
-vtkSlicerLabelWidget::~vtkSlicerLabelWidget() = default;
+vtkSlicerLabelWidget::~vtkSlicerLabelWidget()
+{
+  this->ObserveLabelNode(nullptr);
+}
 
 //------------------------------------------------------------------------------
 void vtkSlicerLabelWidget::CreateDefaultRepresentation(vtkMRMLMarkupsDisplayNode* markupsDisplayNode,
@@ -61,6 +80,120 @@ void vtkSlicerLabelWidget::CreateDefaultRepresentation(vtkMRMLMarkupsDisplayNode
   rep->SetViewNode(viewNode);
   rep->SetMarkupsDisplayNode(markupsDisplayNode);
   rep->UpdateFromMRML(nullptr, 0); // full update
+  this->ObserveLabelNode(markupsDisplayNode ? markupsDisplayNode->GetMarkupsNode() : nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelWidget::SetLevelOfDetailThresholds(vtkMRMLAbstractViewNode * viewNode,
+                                                      double glyphOnlySize, double hiddenSize)
+{
+  if (!viewNode)
+  {
+    return;
+  }
+  MRMLNodeModifyBlocker blocker(viewNode);
+  viewNode->SetAttribute(vtkSlicerLabelWidget::GetLevelOfDetailGlyphOnlySizeAttributeName(),
+                         vtkVariant(std::max(glyphOnlySize, 0.0)).ToString().c_str());
+  viewNode->SetAttribute(vtkSlicerLabelWidget::GetLevelOfDetailHiddenSizeAttributeName(),
+                         vtkVariant(std::max(hiddenSize, 0.0)).ToString().c_str());
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerLabelWidget::GetLevelOfDetailThresholds(vtkMRMLAbstractViewNode * viewNode, double thresholds[2])
+{
+  thresholds[0] = 0.0;
+  thresholds[1] = 0.0;
+  if (!viewNode)
+  {
+    return false;
+  }
+  const char * glyphOnlySize = viewNode->GetAttribute(vtkSlicerLabelWidget::GetLevelOfDetailGlyphOnlySizeAttributeName());
+  const char * hiddenSize = viewNode->GetAttribute(vtkSlicerLabelWidget::GetLevelOfDetailHiddenSizeAttributeName());
+  if (glyphOnlySize)
+  {
+    thresholds[0] = std::max(vtkVariant(glyphOnlySize).ToDouble(), 0.0);
+  }
+  if (hiddenSize)
+  {
+    thresholds[1] = std::max(vtkVariant(hiddenSize).ToDouble(), 0.0);
+  }
+  return thresholds[0] > 0.0 || thresholds[1] > 0.0;
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerLabelWidget::GetLevelOfDetail(double projectedSize, const double thresholds[2])
+{
+  if (projectedSize < thresholds[1])
+  {
+    return LevelOfDetailHidden;
+  }
+  if (projectedSize < thresholds[0])
+  {
+    return LevelOfDetailGlyphOnly;
+  }
+  return LevelOfDetailFull;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelWidget::RequestRender()
+{
+  vtkSlicerLabelWidget::RequestRender(this->GetRenderer());
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelWidget::RequestRender(vtkRenderer * renderer)
+{
+  vtkRenderWindow * renderWindow = renderer ? renderer->GetRenderWindow() : nullptr;
+  vtkRenderWindowInteractor * interactor = renderWindow ? renderWindow->GetInteractor() : nullptr;
+  vtkMRMLViewInteractorStyle * interactorStyle = interactor
+    ? vtkMRMLViewInteractorStyle::SafeDownCast(interactor->GetInteractorStyle())
+    : nullptr;
+  vtkMRMLDisplayableManagerGroup * displayableManagers = interactorStyle
+    ? interactorStyle->GetDisplayableManagers()
+    : nullptr;
+  if (displayableManagers)
+  {
+    displayableManagers->RequestRender();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelWidget::ObserveLabelNode(vtkMRMLMarkupsNode * markupsNode)
+{
+  if (this->ObservedLabelNode == markupsNode)
+  {
+    return;
+  }
+  if (this->ObservedLabelNode)
+  {
+    this->ObservedLabelNode->RemoveObserver(this->LabelTextObserverTag);
+  }
+  this->ObservedLabelNode = markupsNode;
+  this->LabelTextObserverTag = markupsNode
+    ? markupsNode->AddObserver(vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent, this->LabelTextCallback)
+    : 0;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerLabelWidget::OnLabelTextModified(vtkObject * vtkNotUsed(caller),
+                                               unsigned long vtkNotUsed(event),
+                                               void * clientData, void * vtkNotUsed(callData))
+{
+  vtkSlicerLabelWidget * self = reinterpret_cast<vtkSlicerLabelWidget*>(clientData);
+  vtkMRMLAbstractWidgetRepresentation * rep = self->GetRepresentation();
+  if (vtkSlicerLabelRepresentation3D::SafeDownCast(rep))
+  {
+    vtkSlicerLabelRepresentation3D::SafeDownCast(rep)->UpdateLabelTextFromMRML();
+  }
+  else if (vtkSlicerLabelRepresentation2D::SafeDownCast(rep))
+  {
+    vtkSlicerLabelRepresentation2D::SafeDownCast(rep)->UpdateLabelTextFromMRML();
+  }
+  if (rep && rep->GetNeedToRender())
+  {
+    rep->NeedToRenderOff();
+    self->RequestRender();
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -25,6 +25,10 @@
 
 #include <vtkSlicerMarkupsWidget.h>
 
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkWeakPointer.h>
+
 class VTK_SLICER_LABEL_MODULE_VTKWIDGETS_EXPORT vtkSlicerLabelWidget
 : public vtkSlicerMarkupsWidget
 {
@@ -40,10 +44,42 @@ public:
   VTK_NEWINSTANCE
   virtual vtkSlicerMarkupsWidget* CreateInstance() const override;
 
+  enum
+  {
+    LevelOfDetailHidden = 0,
+    LevelOfDetailGlyphOnly,
+    LevelOfDetailFull
+  };
+  /*
+   * Labels whose arrow projects to less than the glyph-only size in pixels
+   * show their control points only, and to less than the hidden size nothing.
+   * Labels behind the camera of a 3D view are hidden. The sizes are attributes
+   * of each view node, saved with it; 0 for both, or none, disables it.
+   */
+  static const char * GetLevelOfDetailGlyphOnlySizeAttributeName() { return "Label.LevelOfDetailGlyphOnlySize"; }
+  static const char * GetLevelOfDetailHiddenSizeAttributeName() { return "Label.LevelOfDetailHiddenSize"; }
+  static void SetLevelOfDetailThresholds(vtkMRMLAbstractViewNode * viewNode, double glyphOnlySize, double hiddenSize);
+  // Glyph-only and hidden sizes of a view. Returns false if the level of detail is disabled.
+  static bool GetLevelOfDetailThresholds(vtkMRMLAbstractViewNode * viewNode, double thresholds[2]);
+  // Level of detail of an arrow projecting to 'projectedSize' pixels.
+  static int GetLevelOfDetail(double projectedSize, const double thresholds[2]);
+
+  // Request a render of the view of this widget from its displayable managers;
+  // the view coalesces the requests of a burst of changes into one render.
+  void RequestRender();
+  static void RequestRender(vtkRenderer * renderer);
+
 protected:
   vtkSlicerLabelWidget();
   ~vtkSlicerLabelWidget() override;
 
+  // Text changes only set the text of the representation; see vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent.
+  void ObserveLabelNode(vtkMRMLMarkupsNode * markupsNode);
+  vtkSmartPointer<vtkCallbackCommand> LabelTextCallback;
+  static void OnLabelTextModified(vtkObject * caller, unsigned long event, void * clientData, void * callData);
+  vtkWeakPointer<vtkMRMLMarkupsNode> ObservedLabelNode;
+  unsigned long LabelTextObserverTag = 0;
+
 private:
   vtkSlicerLabelWidget(const vtkSlicerLabelWidget&) = delete;
   void operator=(const vtkSlicerLabelWidget) = delete;
@@ -133,7 +133,11 @@ void qMRMLMarkupsLabelWidget::setMRMLMarkupsNode(vtkMRMLMarkupsNode* markupsNode
 {
   Q_D(qMRMLMarkupsLabelWidget);
 
-  d->MarkupsLabelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(markupsNode);
+  vtkMRMLMarkupsLabelNode * labelNode = vtkMRMLMarkupsLabelNode::SafeDownCast(markupsNode);
+  // The node is not modified by text changes.
+  this->qvtkReconnect(d->MarkupsLabelNode, labelNode, vtkMRMLMarkupsLabelNode::LabelTextModifiedEvent,
+                      this, SLOT(onLabelTextModified()));
+  d->MarkupsLabelNode = labelNode;
   this->setEnabled(markupsNode != nullptr);
   if (d->MarkupsLabelNode)
   {
@@ -169,6 +173,23 @@ void qMRMLMarkupsLabelWidget::onTextChanged()
   d->MarkupsLabelNode->SetLabel(d->labelTextEdit->toPlainText().toStdString().c_str());
 }
 
+// --------------------------------------------------------------------------
+void qMRMLMarkupsLabelWidget::onLabelTextModified()
+{
+  Q_D(qMRMLMarkupsLabelWidget);
+  
+  if (!d->MarkupsLabelNode)
+  {
+    return;
+  }
+  // Don't reset the cursor while the text is being typed.
+  const QString label = QString::fromStdString(d->MarkupsLabelNode->GetLabel() ? d->MarkupsLabelNode->GetLabel() : "");
+  if (d->labelTextEdit->toPlainText() != label)
+  {
+    d->labelTextEdit->setPlainText(label);
+  }
+}
+
 // --------------------------------------------------------------------------
 void qMRMLMarkupsLabelWidget::onThreeDTipDimensionModeChanged(int mode)
 {
@@ -59,6 +59,7 @@ public slots:
   void setMRMLMarkupsNode(vtkMRMLMarkupsNode* node) override;
   
   void onTextChanged();
+  void onLabelTextModified();
   void onThreeDTipDimensionModeChanged(int mode);
   void onLabelAtBaseClicked(bool checked);
   void onLabelAtTipClicked(bool checked);
@@ -23,9 +23,11 @@
 // Shape MRML includes
 #include "vtkMRMLMarkupsShapeNode.h"
 #include "vtkMRMLMarkupsShapeJsonStorageNode.h"
+#include "vtkMRMLMeasurementShape.h"
 
 // Shape VTKWidgets includes
 #include "vtkSlicerShapeWidget.h"
+#include "vtkSlicerShapeInstancer.h"
 
 // MRML includes
 #include <vtkMRMLScene.h>
@@ -39,6 +41,10 @@
 // VTK includes
 #include <vtkObjectFactory.h>
 #include <vtkMRMLColorTableNode.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerShapeLogic);
@@ -56,6 +62,41 @@ vtkSlicerShapeLogic::~vtkSlicerShapeLogic() = default;
 void vtkSlicerShapeLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "SphereInstancing: " << this->GetSphereInstancing() << "\n";
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerShapeLogic::SetSphereInstancing(bool enabled)
+{
+  if (vtkSlicerShapeInstancer::GetEnabled() == enabled)
+  {
+    return;
+  }
+  vtkSlicerShapeInstancer::SetEnabled(enabled);
+  this->Modified();
+  
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  if (!scene)
+  {
+    return;
+  }
+  // Let the representations switch between their own actor and the instancer.
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass("vtkMRMLMarkupsShapeNode", nodes);
+  for (vtkMRMLNode * node : nodes)
+  {
+    vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(node);
+    if (shapeNode && shapeNode->GetShapeName() == vtkMRMLMarkupsShapeNode::Sphere)
+    {
+      shapeNode->Modified();
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerShapeLogic::GetSphereInstancing() const
+{
+  return vtkSlicerShapeInstancer::GetEnabled();
 }
 
 //-----------------------------------------------------------------------------
@@ -112,6 +153,18 @@ void vtkSlicerShapeLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
     vtkErrorMacro("OnMRMLSceneNodeAdded failed: invalid markups shape node");
     return;
   }
+  /*
+   * Nodes loaded from a scene file or a scene view, or brought back by undo
+   * and redo, get their shape and colours from their storage or the copy.
+   * Shape nodes left without a shape are completed in OnMRMLSceneEndImport.
+   */
+  const int states = scene->GetStates();
+  if (scene->IsImporting() || scene->IsRestoring()
+    || (states & vtkMRMLScene::UndoState) == vtkMRMLScene::UndoState
+    || (states & vtkMRMLScene::RedoState) == vtkMRMLScene::RedoState)
+  {
+    return;
+  }
 
   const std::string colourNodeID = shapeNode->GetUseAlternateColors();
   if (!colourNodeID.empty())
@@ -123,11 +176,133 @@ void vtkSlicerShapeLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
     }
     double selectedColour[3] = { 1.0, 0.5, 0.5};
     this->GenerateUniqueColor(selectedColour, colourNodeID);
-    double colour[3] = { 1.0 - colour[0], 1.0 - colour[1], 1.0 - colour[2]};
+    double colour[3] = { 1.0 - selectedColour[0], 1.0 - selectedColour[1], 1.0 - selectedColour[2]};
     shapeNode->GetDisplayNode()->SetSelectedColor(selectedColour);
     shapeNode->GetDisplayNode()->SetColor(colour);
   }
-  shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Sphere);
+  // Nodes created programmatically may already have been given a shape.
+  if (shapeNode->GetShapeName() == vtkMRMLMarkupsShapeNode::ShapeName_Last)
+  {
+    shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Sphere);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerShapeLogic::OnMRMLSceneEndImport()
+{
+  this->Superclass::OnMRMLSceneEndImport();
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  if (!scene)
+  {
+    vtkErrorMacro("OnMRMLSceneEndImport failed: invalid scene");
+    return;
+  }
+  // Imported nodes whose storage did not define a shape.
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass("vtkMRMLMarkupsShapeNode", nodes);
+  for (vtkMRMLNode * node : nodes)
+  {
+    vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(node);
+    if (shapeNode && shapeNode->GetShapeName() == vtkMRMLMarkupsShapeNode::ShapeName_Last)
+    {
+      shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Sphere);
+    }
+  }
+  this->UpdateShapeMeasurements(false);
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerShapeLogic::UpdateShapeMeasurements(bool modifiedOnly)
+{
+  vtkMRMLScene *scene = this->GetMRMLScene();
+  if (!scene)
+  {
+    vtkErrorMacro("UpdateShapeMeasurements failed: invalid scene");
+    return 0;
+  }
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass("vtkMRMLMarkupsShapeNode", nodes);
+  
+  /*
+   * Serially : collect the nodes with enabled measurements to compute, and
+   * copy their world positions and, for measurements computed on the mesh,
+   * their generated geometry : the node caches and pipelines are not thread
+   * safe. The geometry of other hidden nodes stays deferred.
+   */
+  std::vector<vtkMRMLMarkupsShapeNode*> shapeNodes;
+  std::vector<vtkMRMLMeasurementShape::Input> inputs;
+  for (vtkMRMLNode * node : nodes)
+  {
+    vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(node);
+    if (!shapeNode)
+    {
+      continue;
+    }
+    const vtkMTimeType inputTime = shapeNode->GetMeasurementInputMTime();
+    bool modified = false;
+    bool readsGeometry = false;
+    for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+    {
+      vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+      if (!measurement || !measurement->GetEnabled())
+      {
+        continue;
+      }
+      modified = modified || !modifiedOnly || measurement->GetComputeTime() <= inputTime;
+      readsGeometry = readsGeometry || measurement->ReadsGeometry();
+    }
+    if (!modified)
+    {
+      continue;
+    }
+    shapeNodes.push_back(shapeNode);
+    inputs.push_back(vtkMRMLMeasurementShape::CopyInput(shapeNode, readsGeometry));
+  }
+  
+  // In parallel : all measurements of a node are computed by the same thread, from its copies only, without events.
+  vtkSMPTools::For(0, static_cast<vtkIdType>(shapeNodes.size()),
+    [&shapeNodes, &inputs](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType n = begin; n < end; n++)
+      {
+        vtkMRMLMarkupsShapeNode * shapeNode = shapeNodes[n];
+        for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+        {
+          vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+          if (measurement && measurement->GetEnabled())
+          {
+            measurement->ComputeDeferred(inputs[n]);
+          }
+        }
+      }
+    });
+  
+  // Serially : publish the values, with one modified event per node.
+  for (vtkMRMLMarkupsShapeNode * shapeNode : shapeNodes)
+  {
+    {
+      MRMLNodeModifyBlocker blocker(shapeNode);
+      for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+      {
+        vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+        if (measurement)
+        {
+          measurement->PublishValue();
+        }
+      }
+      shapeNode->Modified();
+    }
+    // The node is now newer than the values : they would otherwise never be up to date.
+    for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+    {
+      vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+      if (measurement && measurement->GetEnabled())
+      {
+        measurement->MarkComputed();
+      }
+    }
+  }
+  return static_cast<int>(shapeNodes.size());
 }
 
 //------------------------------------------------------------------------------
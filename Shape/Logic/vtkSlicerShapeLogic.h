@@ -21,17 +21,36 @@
 #ifndef __vtkSlicerShapeMarkupslogic_h_
 #define __vtkSlicerShapeMarkupslogic_h_
 
-#include <vtkSlicerMarkupsLogic.h>
+#include <vtkSlicerExtraMarkupsLogic.h>
 
 #include "vtkSlicerShapeModuleLogicExport.h"
 
 class VTK_SLICER_SHAPE_MODULE_LOGIC_EXPORT vtkSlicerShapeLogic:
-  public vtkSlicerMarkupsLogic
+  public vtkSlicerExtraMarkupsLogic
 {
 public:
   static vtkSlicerShapeLogic* New();
-  vtkTypeMacro(vtkSlicerShapeLogic, vtkSlicerMarkupsLogic);
+  vtkTypeMacro(vtkSlicerShapeLogic, vtkSlicerExtraMarkupsLogic);
   void PrintSelf(ostream& os, vtkIndent indent) override;
+  
+  /*
+   * Draw all Sphere shapes of a 3D view with a single glyph mapper instead
+   * of one actor each. This applies to all scenes; off by default.
+   */
+  void SetSphereInstancing(bool enabled);
+  bool GetSphereInstancing() const;
+  vtkBooleanMacro(SphereInstancing, bool);
+  
+  /*
+   * Recompute the enabled measurements of all shape nodes in parallel.
+   * With modifiedOnly, nodes whose control points, transform and geometry
+   * have not changed since their last computation are skipped. Results are
+   * published afterwards with a single modified event per node. Nodes
+   * without enabled measurements are skipped, and their geometry, if
+   * deferred while hidden, is not generated.
+   * Returns the number of nodes that were updated.
+   */
+  int UpdateShapeMeasurements(bool modifiedOnly = true);
 
 protected:
   vtkSlicerShapeLogic();
@@ -39,6 +58,7 @@ protected:
 
   void RegisterNodes() override;
   void OnMRMLSceneNodeAdded(vtkMRMLNode * node) override;
+  void OnMRMLSceneEndImport() override;
   void GenerateUniqueColor(double color[3], const std::string& colorNodeID);
 
 private:
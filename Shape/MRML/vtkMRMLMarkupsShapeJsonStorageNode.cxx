@@ -1,10 +1,70 @@
 #include "vtkMRMLMarkupsShapeJsonStorageNode.h"
 
 #include "vtkMRMLJsonElement.h"
+#include "vtkMRMLJsonWriter.h"
 #include "vtkMRMLMarkupsShapeNode.h"
 #include "vtkMRMLScene.h"
 
 #include "vtkObjectFactory.h"
+#include <vtkBase64Utilities.h>
+#include <vtkByteSwap.h>
+#include <vtkFieldData.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkStringArray.h>
+#include <vtkVector.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <vtkZLibDataCompressor.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+std::string EncodeBytes(const std::vector<unsigned char>& bytes, bool compress)
+{
+  std::vector<unsigned char> compressed;
+  const std::vector<unsigned char>* data = &bytes;
+  if (compress && !bytes.empty())
+  {
+    vtkNew<vtkZLibDataCompressor> compressor;
+    compressed.resize(compressor->GetMaximumCompressionSpace(bytes.size()));
+    compressed.resize(compressor->Compress(bytes.data(), bytes.size(), compressed.data(), compressed.size()));
+    data = &compressed;
+  }
+  std::string encoded(((data->size() + 2) / 3) * 4, '\0');
+  encoded.resize(vtkBase64Utilities::Encode(data->data(), data->size(),
+                                            reinterpret_cast<unsigned char*>(&encoded[0])));
+  return encoded;
+}
+
+//----------------------------------------------------------------------------
+// 'size' is the number of bytes before encoding, known from the other properties.
+bool DecodeBytes(const std::string& encoded, bool compressed, size_t size, std::vector<unsigned char>& bytes)
+{
+  std::vector<unsigned char> decoded((encoded.size() / 4) * 3 + 3);
+  decoded.resize(vtkBase64Utilities::DecodeSafely(reinterpret_cast<const unsigned char*>(encoded.data()),
+                                                  encoded.size(), decoded.data(), decoded.size()));
+  if (!compressed)
+  {
+    bytes.swap(decoded);
+    return bytes.size() == size;
+  }
+  bytes.resize(size);
+  if (size == 0)
+  {
+    return true;
+  }
+  vtkNew<vtkZLibDataCompressor> compressor;
+  return compressor->Uncompress(decoded.data(), decoded.size(), bytes.data(), size) == size;
+}
+
+} // end of anonymous namespace
 
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsShapeJsonStorageNode);
@@ -23,6 +83,175 @@ bool vtkMRMLMarkupsShapeJsonStorageNode::CanReadInReferenceNode(vtkMRMLNode *ref
   return refNode->IsA("vtkMRMLMarkupsShapeNode");
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeJsonStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(writeGeometryCache, WriteGeometryCache);
+  vtkMRMLWriteXMLBooleanMacro(compactControlPoints, CompactControlPoints);
+  vtkMRMLWriteXMLBooleanMacro(compressControlPoints, CompressControlPoints);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeJsonStorageNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(writeGeometryCache, WriteGeometryCache);
+  vtkMRMLReadXMLBooleanMacro(compactControlPoints, CompactControlPoints);
+  vtkMRMLReadXMLBooleanMacro(compressControlPoints, CompressControlPoints);
+  vtkMRMLReadXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeJsonStorageNode::Copy(vtkMRMLNode* anode)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(WriteGeometryCache);
+  vtkMRMLCopyBooleanMacro(CompactControlPoints);
+  vtkMRMLCopyBooleanMacro(CompressControlPoints);
+  vtkMRMLCopyEndMacro();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLMarkupsShapeJsonStorageNode::GetGeometryCacheFileName(const char* part)
+{
+  std::string fileName = this->GetFileName() ? this->GetFileName() : "";
+  if (fileName.empty())
+  {
+    return fileName;
+  }
+  const std::string extension = ".json";
+  if (fileName.size() > extension.size()
+    && fileName.compare(fileName.size() - extension.size(), extension.size(), extension) == 0)
+  {
+    fileName.resize(fileName.size() - extension.size());
+  }
+  if (part && *part)
+  {
+    fileName += std::string(".") + part;
+  }
+  return fileName + ".vtp";
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsShapeJsonStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
+{
+  if (!Superclass::ReadDataInternal(refNode))
+  {
+    return 0;
+  }
+  vtkMRMLMarkupsShapeNode* shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(refNode);
+  if (!shapeNode)
+  {
+    return 1;
+  }
+  shapeNode->ClearCachedGeometry();
+  if (shapeNode->GetShapeName() != vtkMRMLMarkupsShapeNode::Tube
+    || !vtksys::SystemTools::FileExists(this->GetGeometryCacheFileName()))
+  {
+    return 1;
+  }
+  /*
+   * The hash is not checked here : the world control points may depend on a
+   * transform that is not observed yet. The representations check it on use.
+   */
+  std::string tubeHash, cappedTubeHash, splineHash;
+  vtkSmartPointer<vtkPolyData> tube = this->ReadGeometryCacheFile(this->GetGeometryCacheFileName(), tubeHash);
+  vtkSmartPointer<vtkPolyData> cappedTube = this->ReadGeometryCacheFile(this->GetGeometryCacheFileName("capped"), cappedTubeHash);
+  vtkSmartPointer<vtkPolyData> spline = this->ReadGeometryCacheFile(this->GetGeometryCacheFileName("spline"), splineHash);
+  if (tube && cappedTube && spline && !tubeHash.empty()
+    && tubeHash == cappedTubeHash && tubeHash == splineHash)
+  {
+    shapeNode->SetCachedGeometry(tube, cappedTube, spline, tubeHash);
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsShapeJsonStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
+{
+  if (!Superclass::WriteDataInternal(refNode))
+  {
+    return 0;
+  }
+  vtkMRMLMarkupsShapeNode* shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(refNode);
+  // The geometry of a hidden node is not generated only to be cached; it is regenerated on load.
+  if (!this->WriteGeometryCache || !shapeNode || shapeNode->HasDeferredGeometry() || !shapeNode->GetShapeWorld())
+  {
+    return 1;
+  }
+  // A failure to write the sidecar does not fail the markups file.
+  const std::string hash = shapeNode->GetGeometryHash();
+  this->WriteGeometryCacheFile(shapeNode->GetShapeWorld(), this->GetGeometryCacheFileName(), hash);
+  if (shapeNode->GetShapeName() == vtkMRMLMarkupsShapeNode::Tube
+    && shapeNode->GetCappedTubeWorld() && shapeNode->GetSplineWorld())
+  {
+    this->WriteGeometryCacheFile(shapeNode->GetCappedTubeWorld(), this->GetGeometryCacheFileName("capped"), hash);
+    this->WriteGeometryCacheFile(shapeNode->GetSplineWorld(), this->GetGeometryCacheFileName("spline"), hash);
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsShapeJsonStorageNode::WriteGeometryCacheFile(vtkPolyData* polyData,
+                                                                const std::string& fileName,
+                                                                const std::string& hash)
+{
+  // Do not alter the field data of the representation's output.
+  vtkNew<vtkPolyData> output;
+  output->ShallowCopy(polyData);
+  vtkNew<vtkFieldData> fieldData;
+  fieldData->ShallowCopy(polyData->GetFieldData());
+  vtkNew<vtkStringArray> hashArray;
+  hashArray->SetName("ShapeGeometryHash");
+  hashArray->InsertNextValue(hash);
+  fieldData->AddArray(hashArray);
+  output->SetFieldData(fieldData);
+  
+  vtkNew<vtkXMLPolyDataWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(output);
+  writer->SetDataModeToBinary();
+  writer->SetCompressorTypeToLZ4();
+  if (!writer->Write())
+  {
+    vtkWarningMacro("WriteGeometryCacheFile: cannot write " << fileName);
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> vtkMRMLMarkupsShapeJsonStorageNode::ReadGeometryCacheFile(const std::string& fileName,
+                                                                                       std::string& hash)
+{
+  hash.clear();
+  if (!vtksys::SystemTools::FileExists(fileName))
+  {
+    return nullptr;
+  }
+  vtkNew<vtkXMLPolyDataReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkPolyData* polyData = reader->GetOutput();
+  vtkStringArray* hashArray = polyData
+    ? vtkStringArray::SafeDownCast(polyData->GetFieldData()->GetAbstractArray("ShapeGeometryHash"))
+    : nullptr;
+  if (!hashArray || hashArray->GetNumberOfValues() == 0)
+  {
+    return nullptr;
+  }
+  hash = hashArray->GetValue(0);
+  vtkSmartPointer<vtkPolyData> geometry = polyData;
+  return geometry;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsShapeJsonStorageNode::WriteBasicProperties(
   vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode)
@@ -47,6 +276,8 @@ bool vtkMRMLMarkupsShapeJsonStorageNode::WriteBasicProperties(
   writer->WriteBoolProperty("scalarVisibility", shapeNode->GetScalarVisibility());
   writer->WriteBoolProperty("splineVisibility", shapeNode->GetSplineVisibility());
   writer->WriteIntProperty("splineResolution", shapeNode->GetSplineResolution());
+  writer->WriteDoubleProperty("splineTolerance", shapeNode->GetSplineTolerance());
+  writer->WriteDoubleProperty("tubeChordError", shapeNode->GetTubeChordError());
   writer->WriteBoolProperty("splineNewInterpolationInterval", shapeNode->GetSplineNewInterpolationInterval());
   // Ignoring shapeNode->ResliceNode.
   
@@ -122,6 +353,16 @@ bool vtkMRMLMarkupsShapeJsonStorageNode::UpdateMarkupsNodeFromJsonValue(vtkMRMLM
   {
     shapeNode->SetSplineResolution(splineResolution);
   }
+  double splineTolerance = 0.0;
+  if (markupsObject->GetDoubleProperty("splineTolerance", splineTolerance))
+  {
+    shapeNode->SetSplineTolerance(splineTolerance);
+  }
+  double tubeChordError = 0.0;
+  if (markupsObject->GetDoubleProperty("tubeChordError", tubeChordError))
+  {
+    shapeNode->SetTubeChordError(tubeChordError);
+  }
   if (markupsObject->HasMember("splineNewInterpolationInterval"))
   {
     bool splineNewInterpolationInterval = markupsObject->GetBoolProperty("splineNewInterpolationInterval");
@@ -231,5 +472,132 @@ bool vtkMRMLMarkupsShapeJsonStorageNode::UpdateMarkupsNodeFromJsonValue(vtkMRMLM
   */
   shapeNode->CreateDefaultDisplayNodes();
   
-  return Superclass::UpdateMarkupsNodeFromJsonValue(markupsNode, markupsObject);
+  if (!Superclass::UpdateMarkupsNodeFromJsonValue(markupsNode, markupsObject))
+  {
+    return false;
+  }
+  if (markupsObject->HasMember("controlPointPositions") && !markupsObject->HasMember("controlPoints"))
+  {
+    return this->ReadCompactControlPoints(shapeNode, markupsObject);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsShapeJsonStorageNode::CanWriteCompactControlPoints(vtkMRMLMarkupsNode* markupsNode)
+{
+  const double identity[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+  for (int i = 0; i < markupsNode->GetNumberOfControlPoints(); i++)
+  {
+    double orientation[9] = { 0.0 };
+    markupsNode->GetNthControlPointOrientationMatrix(i, orientation);
+    if (!std::equal(orientation, orientation + 9, identity)
+      || !markupsNode->GetNthControlPointDescription(i).empty()
+      || !markupsNode->GetNthControlPointAssociatedNodeID(i).empty()
+      || !markupsNode->GetNthControlPointSelected(i)
+      || markupsNode->GetNthControlPointLocked(i)
+      || !markupsNode->GetNthControlPointVisibility(i)
+      || markupsNode->GetNthControlPointPositionStatus(i) != vtkMRMLMarkupsNode::PositionDefined)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsShapeJsonStorageNode::WriteControlPoints(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode)
+{
+  if (!this->CompactControlPoints || !this->CanWriteCompactControlPoints(markupsNode))
+  {
+    return Superclass::WriteControlPoints(writer, markupsNode);
+  }
+  const int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+  const bool lps = (this->GetCoordinateSystem() == vtkMRMLStorageNode::CoordinateSystemLPS);
+  std::vector<double> positions(3 * static_cast<size_t>(numberOfControlPoints));
+  std::vector<unsigned char> labels;
+  for (int i = 0; i < numberOfControlPoints; i++)
+  {
+    double* position = &positions[3 * static_cast<size_t>(i)];
+    markupsNode->GetNthControlPointPosition(i, position);
+    if (lps)
+    {
+      position[0] = -position[0];
+      position[1] = -position[1];
+    }
+    // Labels are separated by a null character.
+    const std::string label = markupsNode->GetNthControlPointLabel(i);
+    labels.insert(labels.end(), label.begin(), label.end());
+    labels.push_back('\0');
+  }
+  vtkByteSwap::SwapLERange(positions.data(), positions.size());
+  const unsigned char* positionBytes = reinterpret_cast<const unsigned char*>(positions.data());
+  
+  writer->WriteStringProperty("controlPointEncoding", "base64");
+  writer->WriteStringProperty("controlPointDataType", "float64LE");
+  writer->WriteStringProperty("controlPointCompression", this->CompressControlPoints ? "zlib" : "none");
+  writer->WriteStringProperty("controlPointCoordinateSystem",
+    vtkMRMLStorageNode::GetCoordinateSystemTypeAsString(lps ? vtkMRMLStorageNode::CoordinateSystemLPS
+                                                            : vtkMRMLStorageNode::CoordinateSystemRAS));
+  writer->WriteIntProperty("controlPointCount", numberOfControlPoints);
+  writer->WriteIntProperty("controlPointLabelsSize", static_cast<int>(labels.size()));
+  writer->WriteStringProperty("controlPointPositions",
+    EncodeBytes(std::vector<unsigned char>(positionBytes, positionBytes + positions.size() * sizeof(double)),
+                this->CompressControlPoints));
+  writer->WriteStringProperty("controlPointLabels", EncodeBytes(labels, this->CompressControlPoints));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsShapeJsonStorageNode::ReadCompactControlPoints(vtkMRMLMarkupsNode* markupsNode, vtkMRMLJsonElement* markupsObject)
+{
+  int numberOfControlPoints = 0;
+  int labelsSize = 0;
+  if (markupsObject->GetStringProperty("controlPointEncoding") != "base64"
+    || markupsObject->GetStringProperty("controlPointDataType") != "float64LE"
+    || !markupsObject->GetIntProperty("controlPointCount", numberOfControlPoints)
+    || numberOfControlPoints < 0)
+  {
+    vtkErrorMacro("ReadCompactControlPoints: unsupported control point encoding");
+    return false;
+  }
+  const bool compressed = (markupsObject->GetStringProperty("controlPointCompression") == "zlib");
+  std::vector<unsigned char> positionBytes;
+  if (!DecodeBytes(markupsObject->GetStringProperty("controlPointPositions"), compressed,
+                   3 * sizeof(double) * static_cast<size_t>(numberOfControlPoints), positionBytes))
+  {
+    vtkErrorMacro("ReadCompactControlPoints: invalid control point positions");
+    return false;
+  }
+  std::vector<double> positions(3 * static_cast<size_t>(numberOfControlPoints));
+  std::copy(positionBytes.begin(), positionBytes.end(), reinterpret_cast<unsigned char*>(positions.data()));
+  vtkByteSwap::SwapLERange(positions.data(), positions.size());
+  
+  std::vector<unsigned char> labelBytes;
+  if (markupsObject->GetIntProperty("controlPointLabelsSize", labelsSize) && labelsSize > 0
+    && !DecodeBytes(markupsObject->GetStringProperty("controlPointLabels"), compressed, labelsSize, labelBytes))
+  {
+    vtkWarningMacro("ReadCompactControlPoints: invalid control point labels, using default labels");
+    labelBytes.clear();
+  }
+  
+  const bool lps = (vtkMRMLStorageNode::GetCoordinateSystemTypeFromString(
+    markupsObject->GetStringProperty("controlPointCoordinateSystem").c_str()) == vtkMRMLStorageNode::CoordinateSystemLPS);
+  MRMLNodeModifyBlocker blocker(markupsNode);
+  markupsNode->RemoveAllControlPoints();
+  size_t labelStart = 0;
+  for (int i = 0; i < numberOfControlPoints; i++)
+  {
+    const double* position = &positions[3 * static_cast<size_t>(i)];
+    vtkVector3d point(lps ? -position[0] : position[0], lps ? -position[1] : position[1], position[2]);
+    std::string label;
+    if (labelStart < labelBytes.size())
+    {
+      const size_t labelEnd = std::find(labelBytes.begin() + labelStart, labelBytes.end(), '\0') - labelBytes.begin();
+      label.assign(labelBytes.begin() + labelStart, labelBytes.begin() + labelEnd);
+      labelStart = labelEnd + 1;
+    }
+    markupsNode->AddControlPoint(point, label);
+  }
+  return true;
 }
@@ -10,9 +10,13 @@
 #include "vtkSlicerShapeModuleMRMLExport.h"
 #include "vtkMRMLMarkupsJsonStorageNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 class vtkMRMLJsonElement;
 class vtkMRMLJsonWriter;
 class vtkMRMLMarkupsNode;
+class vtkPolyData;
 
 class VTK_SLICER_SHAPE_MODULE_MRML_EXPORT vtkMRMLMarkupsShapeJsonStorageNode : public vtkMRMLMarkupsJsonStorageNode
 {
@@ -23,6 +27,37 @@ public:
     vtkMRMLNode* CreateNodeInstance() override;
     const char* GetNodeTagName() override { return "MarkupsShapesJsonStorage"; };
     bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
+    
+    void WriteXML(ostream& of, int indent) override;
+    void ReadXMLAttributes(const char** atts) override;
+    void Copy(vtkMRMLNode* node) override;
+    
+    /*
+     * Also write the generated world geometry next to the file, as .vtp,
+     * with the hash of the parameters that produced it. A Tube's sidecar
+     * is read back on load and used while the hash matches, instead of
+     * regenerating the tube. Off by default.
+     */
+    vtkSetMacro(WriteGeometryCache, bool);
+    vtkGetMacro(WriteGeometryCache, bool);
+    vtkBooleanMacro(WriteGeometryCache, bool);
+    // Sidecar of the file name; 'part' is "capped" or "spline" for a Tube's other meshes.
+    std::string GetGeometryCacheFileName(const char* part = nullptr);
+    
+    /*
+     * Write the control point positions as one base64 string of little endian
+     * float64 instead of one JSON object per point, for Tubes with thousands
+     * of points. Labels are kept. The usual form is written anyway if a point
+     * has another property that is not the default, so that nothing is lost.
+     * Both forms are read. Off by default.
+     */
+    vtkSetMacro(CompactControlPoints, bool);
+    vtkGetMacro(CompactControlPoints, bool);
+    vtkBooleanMacro(CompactControlPoints, bool);
+    // zlib compression of the compact form. On by default.
+    vtkSetMacro(CompressControlPoints, bool);
+    vtkGetMacro(CompressControlPoints, bool);
+    vtkBooleanMacro(CompressControlPoints, bool);
 
 protected:
     vtkMRMLMarkupsShapeJsonStorageNode();
@@ -31,7 +66,20 @@ protected:
     void operator=(const vtkMRMLMarkupsShapeJsonStorageNode&);
 
     bool WriteBasicProperties(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode) override;
+    bool WriteControlPoints(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode) override;
     bool UpdateMarkupsNodeFromJsonValue(vtkMRMLMarkupsNode* markupsNode, vtkMRMLJsonElement* markupObject) override;
+    int ReadDataInternal(vtkMRMLNode* refNode) override;
+    int WriteDataInternal(vtkMRMLNode* refNode) override;
+    
+    bool WriteGeometryCacheFile(vtkPolyData* polyData, const std::string& fileName, const std::string& hash);
+    vtkSmartPointer<vtkPolyData> ReadGeometryCacheFile(const std::string& fileName, std::string& hash);
+    bool WriteGeometryCache = false;
+    
+    // True if no control point has a property that the compact form drops.
+    bool CanWriteCompactControlPoints(vtkMRMLMarkupsNode* markupsNode);
+    bool ReadCompactControlPoints(vtkMRMLMarkupsNode* markupsNode, vtkMRMLJsonElement* markupObject);
+    bool CompactControlPoints = false;
+    bool CompressControlPoints = true;
 };
 
 #endif // VTKMRMLMARKUPSSHAPEJSONSTORAGENODE_H
@@ -21,6 +21,7 @@
 #include "vtkMRMLMarkupsShapeNode.h"
 #include "vtkMRMLMeasurementShape.h"
 #include "vtkMRMLMarkupsShapeJsonStorageNode.h"
+#include "vtkMRMLMarkupsShapeTraits.h"
 #include "vtkMRMLMarkupsDisplayNode.h"
 
 // VTK includes
@@ -33,6 +34,15 @@
 #include <vtkPolyLineSource.h>
 #include <vtkPointData.h>
 #include <vtkMRMLUnitNode.h>
+#include <vtkMRMLTransformNode.h>
+#include <vtkGeneralTransform.h>
+#include <vtkAlgorithm.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
 
 //--------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsShapeNode);
@@ -40,19 +50,8 @@ vtkMRMLNodeNewMacro(vtkMRMLMarkupsShapeNode);
 //--------------------------------------------------------------------------------
 vtkMRMLMarkupsShapeNode::vtkMRMLMarkupsShapeNode()
 {
-  const double pi = vtkMath::Pi();
-  // Default UVW values for all parametric shapes; obtained from the header files.
-  Parametrics[Ellipsoid] =     {-1.0 * pi, 1.0 * pi, -0.5 * pi, 0.5 * pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0};
-  Parametrics[Toroid] =        {0,         2.0 * pi, 0,         2.0 * pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 1};
-  Parametrics[BohemianDome] =  {-1.0 * pi, 1.0 * pi, -1.0 * pi, 1.0 * pi, 0.0, 1.0, 1, 1, 0, 0, 0, 0, 0};
-  Parametrics[Bour] =          {0,         1.0,      0,         4.0 * pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0};
-  Parametrics[Boy] =           {0,         1.0 * pi, 0,         1.0 * pi, 0.0, 1.0, 1, 1, 0, 1, 1, 0, 0};
-  Parametrics[CrossCap] =      {0,         1.0 * pi, 0,         1.0 * pi, 0.0, 1.0, 1, 1, 0, 1, 1, 0, 0};
-  Parametrics[ConicSpiral] =   {0,         2.0 * pi, 0,         2.0 * pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0};
-  Parametrics[Kuen] =          {-4.5,      4.5,      0.05,      1.0 * pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0};
-  Parametrics[Mobius] =        {0,         2.0 * pi, -1.0,      1.0,      0.0, 1.0, 1, 0, 0, 0, 0, 0, 0};
-  Parametrics[PluckerConoid] = {0,         3.0,      0.0,       2.0 * pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0};
-  Parametrics[Roman] =         {0,         1.0 * pi, 0,         1.0 * pi, 0.0, 1.0, 1, 1, 0, 1, 0, 0, 0};
+  this->ControlPointPositionsWorld = vtkSmartPointer<vtkPoints>::New();
+  this->ControlPointPositionsWorld->SetDataTypeToDouble();
 }
 
 //--------------------------------------------------------------------------------
@@ -103,48 +102,7 @@ void vtkMRMLMarkupsShapeNode::CreateDefaultDisplayNodes()
 //----------------------------------------------------------------------------
 const char* vtkMRMLMarkupsShapeNode::GetShapeNameAsString(int shapeName)
 {
-  switch (shapeName)
-  {
-    case vtkMRMLMarkupsShapeNode::Sphere:
-      return "Sphere";
-    case vtkMRMLMarkupsShapeNode::Ring:
-      return "Ring";
-    case vtkMRMLMarkupsShapeNode::Disk:
-      return "Disk";
-    case vtkMRMLMarkupsShapeNode::Tube:
-      return "Tube";
-    case vtkMRMLMarkupsShapeNode::Cylinder:
-      return "Cylinder";
-    case vtkMRMLMarkupsShapeNode::Cone:
-      return "Cone";
-    case vtkMRMLMarkupsShapeNode::Arc:
-      return "Arc";
-    case vtkMRMLMarkupsShapeNode::Ellipsoid:
-      return "Ellipsoid";
-    case vtkMRMLMarkupsShapeNode::Toroid:
-      return "Toroid";
-    case vtkMRMLMarkupsShapeNode::BohemianDome:
-      return "BohemianDome";
-    case vtkMRMLMarkupsShapeNode::Bour:
-      return "Bour";
-    case vtkMRMLMarkupsShapeNode::Boy:
-      return "Boy";
-    case vtkMRMLMarkupsShapeNode::ConicSpiral:
-      return "ConicSpiral";
-    case vtkMRMLMarkupsShapeNode::CrossCap:
-      return "CrossCap";
-    case vtkMRMLMarkupsShapeNode::Kuen:
-      return "Kuen";
-    case vtkMRMLMarkupsShapeNode::Mobius:
-      return "Mobius";
-    case vtkMRMLMarkupsShapeNode::PluckerConoid:
-      return "PluckerConoid";
-    case vtkMRMLMarkupsShapeNode::Roman:
-      return "Roman";
-    default:
-      break;
-  }
-  return "";
+  return vtkMRMLMarkupsShapeTraits::Get(shapeName).Name;
 }
 
 //-----------------------------------------------------------
@@ -244,121 +202,65 @@ void vtkMRMLMarkupsShapeNode::SetShapeName(int shapeName)
   {
     return;
   }
+  if (shapeName < 0 || shapeName > ShapeName_Last)
+  {
+    vtkErrorMacro("Unknown shape.");
+    return;
+  }
   this->ShapeName = shapeName;
-  switch (shapeName)
+  // N.B. - Tube : control points need not and are not required to be on the surface.
+  // A control point pair merely defines a radius value and a middle point for the spline (centerline).
+  // For control points to lie on the surface of the tube, adjacent pairs must not be too close to each other.
+  const vtkMRMLMarkupsShapeTraits& traits = vtkMRMLMarkupsShapeTraits::Get(shapeName);
+  this->ShapeIsParametric = traits.Parametric;
+  if (shapeName != ShapeName_Last)
+  {
+    this->RequiredNumberOfControlPoints = traits.RequiredNumberOfControlPoints;
+    this->MaximumNumberOfControlPoints = traits.MaximumNumberOfControlPoints;
+  }
+  switch (traits.Measurements)
   {
-    case Sphere :
-      this->ShapeIsParametric = false;
-      this->RequiredNumberOfControlPoints = 2;
-      this->MaximumNumberOfControlPoints = 2;
+    case vtkMRMLMarkupsShapeTraits::SphereMeasurements :
       this->ForceSphereMeasurements();
       break;
-    case Ring:
-      this->ShapeIsParametric = false;
-      // Third point is used to calculate normal relative to the center in 3D view.
-      this->RequiredNumberOfControlPoints = 3;
-      this->MaximumNumberOfControlPoints = 3;
+    case vtkMRMLMarkupsShapeTraits::RingMeasurements :
       this->ForceRingMeasurements();
       break;
-    case Disk:
-      this->ShapeIsParametric = false;
-      // Point 0 : always the center.
-      this->RequiredNumberOfControlPoints = 3;
-      this->MaximumNumberOfControlPoints = 3;
+    case vtkMRMLMarkupsShapeTraits::DiskMeasurements :
       this->ForceDiskMeasurements();
       break;
-    case Tube:
-      /*
-       * RequiredNumberOfControlPoints should be 4, but toolbar new control point button remains grayed for ever.
-       * With -1, it still remains grayed, but hovering on a control point activates the new control point button.
-       * 
-       * N.B. - control points need not and are not required to be on the surface.
-       * A control point pair merely defines a radius value and a middle point for the spline (centerline).
-       * For control points to lie on the surface of the tube, adjacent pairs must not be too close to each other.
-       * In practice, we would place points on the walls of a diseased artery, a short part of it.
-       * All this is useless for healthy arteries : we have real structures using segmentation,
-       * and they do not have perfectly circular cross-sections.
-       */
-      this->ShapeIsParametric = false;
-      this->RequiredNumberOfControlPoints = -1;
-      this->MaximumNumberOfControlPoints = -1;
+    case vtkMRMLMarkupsShapeTraits::TubeMeasurements :
       this->ForceTubeMeasurements();
       break;
-    case Cylinder:
-      this->ShapeIsParametric = false;
-      // Points 0 : centre at one end; point 2 : radius; point 3 : centre of the opposite end
-      this->RequiredNumberOfControlPoints = 3;
-      this->MaximumNumberOfControlPoints = 3;
+    case vtkMRMLMarkupsShapeTraits::CylinderMeasurements :
       this->ForceCylinderMeasurements();
       break;
-    case Cone:
-      this->ShapeIsParametric = false;
-      // Points 0 : centre of the base; point 2 : radius; point 3 : tip
-      this->RequiredNumberOfControlPoints = 3;
-      this->MaximumNumberOfControlPoints = 3;
+    case vtkMRMLMarkupsShapeTraits::ConeMeasurements :
       this->ForceConeMeasurements();
       break;
-    case Arc:
-      this->ShapeIsParametric = false;
-      // Points 0 : centre; point 2 : radius and polar vector; point 3 : normal and angle
-      this->RequiredNumberOfControlPoints = 3;
-      this->MaximumNumberOfControlPoints = 3;
+    case vtkMRMLMarkupsShapeTraits::ArcMeasurements :
       this->ForceArcMeasurements();
       break;
-    case Roman :
-    case PluckerConoid :
-    case Mobius :
-    case Kuen :
-    case ConicSpiral :
-    case CrossCap :
-    case Boy :
-    case Bour :
-    case BohemianDome :
-    case Toroid :
-    case Ellipsoid :
-      this->ShapeIsParametric = true;
-      this->RequiredNumberOfControlPoints = 4;
-      this->MaximumNumberOfControlPoints = 4;
+    case vtkMRMLMarkupsShapeTraits::EllipsoidMeasurements :
+      this->ForceEllipsoidMeasurements();
       break;
-    case ShapeName_Last :
+    case vtkMRMLMarkupsShapeTraits::ToroidMeasurements :
+      this->ForceToroidMeasurements();
+      break;
+    case vtkMRMLMarkupsShapeTraits::BohemianDomeMeasurements :
+      this->ForceBohemianDomeMeasurements();
+      break;
+    case vtkMRMLMarkupsShapeTraits::ConicSpiralMeasurements :
+      this->ForceConicSpiralMeasurements();
+      break;
+    case vtkMRMLMarkupsShapeTraits::TransformScaledMeasurements :
+      this->ForceTransformScaledMeasurements();
+      break;
+    case vtkMRMLMarkupsShapeTraits::TransformScaledVolumeMeasurements :
+      this->ForceTransformScaledMeasurements(true); // With volume measurement.
+      break;
+    case vtkMRMLMarkupsShapeTraits::NoMeasurements :
       break;
-    default :
-      vtkErrorMacro("Unknown shape.");
-      return;
-  };
-  if (this->ShapeIsParametric)
-  {
-    switch (shapeName)
-    {
-      case Ellipsoid:
-        this->ForceEllipsoidMeasurements();
-        break;
-      case Toroid:
-        this->ForceToroidMeasurements();
-        break;
-      case BohemianDome:
-        this->ForceBohemianDomeMeasurements();
-        break;
-      case Roman:
-      case PluckerConoid:
-      case Mobius:
-      case Kuen:
-      case Bour:
-        this->ForceTransformScaledMeasurements();
-        break;
-      case ConicSpiral:
-        this->ForceConicSpiralMeasurements();
-        break;
-      case CrossCap:
-      case Boy:
-        this->ForceTransformScaledMeasurements(true); // With volume measurement.
-        break;
-      case ShapeName_Last :
-        break;
-      default:
-        vtkErrorMacro("Unknown shape.");
-        return;
-    }
   }
   if (this->MaximumNumberOfControlPoints > 0)
   {
@@ -394,9 +296,10 @@ bool vtkMRMLMarkupsShapeNode::DescribeDiskPointSpacing(double * closestPoint, do
   double p1[3] = { 0.0 }; // center
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  this->GetNthControlPointPositionWorld(0, p1);
-  this->GetNthControlPointPositionWorld(1, p2);
-  this->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   
   double distance2 = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   double distance3 = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p3));
@@ -613,39 +516,27 @@ void vtkMRMLMarkupsShapeNode::SetAperture(double aperture)
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsShapeNode::ResliceToControlPoints()
 {
-  switch (this->ShapeName)
+  switch (vtkMRMLMarkupsShapeTraits::Get(this->ShapeName).Reslice)
   {
-    case Sphere :
+    case vtkMRMLMarkupsShapeTraits::LineReslice :
       this->ResliceToLine();
       break;
-    case Ring:
-    case Disk:
-    case Cylinder:
-    case Cone:
-    case Arc:
+    case vtkMRMLMarkupsShapeTraits::PlaneReslice :
       this->ResliceToPlane();
       break;
-    case Tube:
+    case vtkMRMLMarkupsShapeTraits::TubeCrossSectionReslice :
       if (this->SnapNthControlPointToTubeSurface(this->ActiveControlPoint, false))
       {
         this->ResliceToTubeCrossSection(this->ActiveControlPoint);
       }
       break;
-    case Roman:
-    case PluckerConoid:
-    case Mobius:
-    case Kuen:
-    case CrossCap:
-    case Boy:
-    case Bour:
-    case BohemianDome:
-    case Toroid:
-    case Ellipsoid:
+    case vtkMRMLMarkupsShapeTraits::ParametricPlaneReslice :
       // Can be any combination; we want at least p1 and p4 since they control orientation.
       this->ResliceToPlane(0, 1, 3);
-    default :
+      break;
+    case vtkMRMLMarkupsShapeTraits::NoReslice :
       vtkErrorMacro("Unknown shape.");
-      return;
+      break;
   };
 }
 
@@ -768,6 +659,7 @@ void vtkMRMLMarkupsShapeNode::ForceCylinderMeasurements()
   this->AddLengthMeasurement("radius", true);
   this->AddLengthMeasurement("height", true);
   this->AddAreaMeasurement("area");
+  this->AddAreaMeasurement("totalArea");
   this->AddVolumeMeasurement("volume");
 }
 
@@ -944,14 +836,15 @@ double vtkMRMLMarkupsShapeNode::GetNthControlPointRadius(int n)
   double radius = 0.0;
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
   if ((n % 2) == 0)
   {
-    this->GetNthControlPointPositionWorld(n, p1);
-    this->GetNthControlPointPositionWorld(n + 1, p2);
+    controlPointsWorld->GetPoint(n, p1);
+    controlPointsWorld->GetPoint(n + 1, p2);
   }
   else {
-    this->GetNthControlPointPositionWorld(n, p2);
-    this->GetNthControlPointPositionWorld(n - 1, p1);
+    controlPointsWorld->GetPoint(n, p2);
+    controlPointsWorld->GetPoint(n - 1, p1);
   }
   radius = (std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2))) / 2.0;
   return radius;
@@ -978,14 +871,15 @@ void vtkMRMLMarkupsShapeNode::SetNthControlPointRadius(int n, double radius)
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
   if ((n % 2) == 0)
   {
-    this->GetNthControlPointPositionWorld(n, p1);
-    this->GetNthControlPointPositionWorld(n + 1, p2);
+    controlPointsWorld->GetPoint(n, p1);
+    controlPointsWorld->GetPoint(n + 1, p2);
   }
   else {
-    this->GetNthControlPointPositionWorld(n, p2);
-    this->GetNthControlPointPositionWorld(n - 1, p1);
+    controlPointsWorld->GetPoint(n, p2);
+    controlPointsWorld->GetPoint(n - 1, p1);
   }
   double middlePoint[3] = { (p1[0] + p2[0]) / 2.0,
                             (p1[1] + p2[1]) / 2.0,
@@ -1012,6 +906,7 @@ void vtkMRMLMarkupsShapeNode::SetNthControlPointRadius(int n, double radius)
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsShapeNode::GetNthControlPointSplineIntersection(int pointIndex, vtkPoints * point)
 {
+  this->GenerateDeferredGeometry();
   if (this->GetShapeName() != Tube)
   {
     vtkErrorMacro("Not a Tube shape.");
@@ -1035,14 +930,15 @@ bool vtkMRMLMarkupsShapeNode::GetNthControlPointSplineIntersection(int pointInde
 
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
   if ((pointIndex % 2) == 0)
   {
-    this->GetNthControlPointPositionWorld(pointIndex, p1);
-    this->GetNthControlPointPositionWorld(pointIndex + 1, p2);
+    controlPointsWorld->GetPoint(pointIndex, p1);
+    controlPointsWorld->GetPoint(pointIndex + 1, p2);
   }
   else {
-    this->GetNthControlPointPositionWorld(pointIndex, p2);
-    this->GetNthControlPointPositionWorld(pointIndex - 1, p1);
+    controlPointsWorld->GetPoint(pointIndex, p2);
+    controlPointsWorld->GetPoint(pointIndex - 1, p1);
   }
   // Middle point between p1 and p2.
   double middlePoint[3] = { (p1[0] + p2[0]) / 2.0,
@@ -1081,13 +977,45 @@ bool vtkMRMLMarkupsShapeNode::SnapNthControlPointToTubeSurface(int pointIndex, b
     " or less than 4 control points, or fewer control points than requested.");
     return false;
   }
-  const double radius = this->GetNthControlPointRadius(pointIndex);
+  // First point of the pair is always at an even index.
+  const int pairIndex = pointIndex - (pointIndex % 2);
+  double p1[3] = { 0.0 };
+  double p2[3] = { 0.0 };
+  double newP1[3] = { 0.0 };
+  double newP2[3] = { 0.0 };
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(pairIndex, p1);
+  controlPointsWorld->GetPoint(pairIndex + 1, p2);
+  if (!this->GetSnappedControlPointPair(p1, p2, newP1, newP2))
+  {
+    return false;
+  }
+  this->SetNthControlPointPositionWorld(pairIndex, newP1);
+  this->SetNthControlPointPositionWorld(pairIndex + 1, newP2);
+  this->Modified();
+  return true;
+}
 
-  vtkNew<vtkPoints> result;
-  this->GetNthControlPointSplineIntersection(pointIndex, result);
-  double * splineMiddlePoint = result->GetPoint(0);
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsShapeNode::GetSnappedControlPointPair(const double * p1, const double * p2,
+                                                         double * newP1, double * newP2)
+{
+  this->GenerateDeferredGeometry();
+  if (!this->SplineWorld || this->SplineWorld->GetNumberOfPoints() < 2)
+  {
+    vtkErrorMacro("Tube spline is not available.");
+    return false;
+  }
+  const double radius = (std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2))) / 2.0;
+  // Middle point between p1 and p2.
+  double middlePoint[3] = { (p1[0] + p2[0]) / 2.0,
+                          (p1[1] + p2[1]) / 2.0,
+                          (p1[2] + p2[2]) / 2.0};
+  // Closest point on spline to calculated middle point.
+  double splineMiddlePoint[3] = { 0.0 };
+  vtkIdType id = this->SplineWorld->FindPoint(middlePoint);
+  this->SplineWorld->GetPoint(id, splineMiddlePoint);
   double splineMiddlePointNeighbour[3] = { 0.0 };
-  vtkIdType id = this->SplineWorld->FindPoint(splineMiddlePoint);
   vtkIdType idNeighbour = (id == this->SplineWorld->GetNumberOfPoints() - 1) // Last point
                         ? id -1
                         : id + 1;
@@ -1106,21 +1034,9 @@ bool vtkMRMLMarkupsShapeNode::SnapNthControlPointToTubeSurface(int pointIndex, b
                               splineMiddlePoint[2] + rPerpendicular1[2]};
   // This is usually 1.0 mm.
   const double distance = std::sqrt(vtkMath::Distance2BetweenPoints(splineMiddlePoint, perpendicular1));
-  double newP1[3] = { 0.0 };
-  double newP2[3] = { 0.0 };
   // radius may be less than distance.
   vtkMath::GetPointAlongLine(newP1, splineMiddlePoint, perpendicular1, radius - distance);
   vtkMath::GetPointAlongLine(newP2, newP1, splineMiddlePoint, radius);
-  if ((pointIndex % 2) == 0)
-  {
-    this->SetNthControlPointPositionWorld(pointIndex, newP1);
-    this->SetNthControlPointPositionWorld(pointIndex + 1, newP2);
-  }
-  else {
-    this->SetNthControlPointPositionWorld(pointIndex, newP2);
-    this->SetNthControlPointPositionWorld(pointIndex - 1, newP1);
-  }
-  this->Modified();
   return true;
 }
 
@@ -1145,10 +1061,36 @@ bool vtkMRMLMarkupsShapeNode::SnapAllControlPointsToTubeSurface(bool bypassLocke
     " or less than 4 control points.");
     return false;
   }
-  for (int i = 0; i < this->GetNumberOfDefinedControlPoints(); i = i + 2)
+  /*
+   * All pairs are snapped against the current spline, the tube as displayed :
+   * it is not regenerated between pairs. Compute every new position before
+   * moving any control point, so that a failure leaves the node unchanged.
+   */
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
+  vtkNew<vtkPoints> snappedPointsWorld;
+  snappedPointsWorld->SetNumberOfPoints(controlPointsWorld->GetNumberOfPoints());
+  double p1[3] = { 0.0 };
+  double p2[3] = { 0.0 };
+  double newP1[3] = { 0.0 };
+  double newP2[3] = { 0.0 };
+  for (int i = 0; i < controlPointsWorld->GetNumberOfPoints() - 1; i = i + 2)
   {
-    this->SnapNthControlPointToTubeSurface(i, true);
+    controlPointsWorld->GetPoint(i, p1);
+    controlPointsWorld->GetPoint(i + 1, p2);
+    if (!this->GetSnappedControlPointPair(p1, p2, newP1, newP2))
+    {
+      return false;
+    }
+    snappedPointsWorld->SetPoint(i, newP1);
+    snappedPointsWorld->SetPoint(i + 1, newP2);
   }
+  // Notify once.
+  MRMLNodeModifyBlocker blocker(this);
+  for (int i = 0; i < snappedPointsWorld->GetNumberOfPoints(); i++)
+  {
+    this->SetNthControlPointPositionWorld(i, snappedPointsWorld->GetPoint(i));
+  }
+  this->Modified();
   return true;
 }
 
@@ -1202,6 +1144,7 @@ bool vtkMRMLMarkupsShapeNode::GetControlPointPairPosition(vtkPolyData * spline,
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsShapeNode::UpdateNumberOfControlPoints(int numberOfControlPoints, bool bypassLockedState)
 {
+  this->GenerateDeferredGeometry();
   if (this->GetShapeName() != Tube)
   {
     vtkErrorMacro("Not a Tube shape.");
@@ -1281,7 +1224,7 @@ bool vtkMRMLMarkupsShapeNode::UpdateNumberOfControlPoints(int numberOfControlPoi
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsShapeNode::ResliceToTubeCrossSection(int pointIndex)
 {
-  
+  this->GenerateDeferredGeometry();
   if (this->GetShapeName() != Tube)
   {
     vtkErrorMacro("Not a Tube shape.");
@@ -1336,6 +1279,7 @@ void vtkMRMLMarkupsShapeNode::ResliceToTubeCrossSection(int pointIndex)
 bool vtkMRMLMarkupsShapeNode::GetTrimmedSplineWorld(vtkPolyData * trimmedSpline,
                                                     int numberOfPointsToTrimAtStart, int numberOfPointsToTrimAtEnd)
 {
+  this->GenerateDeferredGeometry();
   /*
    * At each end, the tube is bell shaped. This is apparent when any tube end is made very large.
    * This is a problem for modules that rely on radii along the spline. They expect a smooth radius variation.
@@ -1406,12 +1350,56 @@ bool vtkMRMLMarkupsShapeNode::GetTrimmedSplineWorld(vtkPolyData * trimmedSpline,
   return true;
 }
 
+//----------------------------------------------------------------------------
+vtkPolyData * vtkMRMLMarkupsShapeNode::GetShapeWorld() const
+{
+  // The world copy of a placed primitive is only computed for those who ask.
+  if (this->ShapeWorldProducer)
+  {
+    this->ShapeWorldProducer->Update();
+  }
+  return this->ShapeWorld;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData * vtkMRMLMarkupsShapeNode::GetSplineWorld() const
+{
+  return this->SplineWorld;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData * vtkMRMLMarkupsShapeNode::GetCappedTubeWorld() const
+{
+  return this->CappedTubeWorld;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeNode::GenerateDeferredGeometry()
+{
+  if (!this->DeferredGeometryCommand)
+  {
+    return;
+  }
+  // Once : the representation generates the geometry and sets the world pointers.
+  vtkSmartPointer<vtkCommand> command = this->DeferredGeometryCommand.GetPointer();
+  this->DeferredGeometryCommand = nullptr;
+  command->Execute(this, vtkCommand::ModifiedEvent, nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeNode::SetShapeWorldProducer(vtkAlgorithm * producer)
+{
+  this->ShapeWorldProducer = producer;
+  this->ShapeWorld = producer ? vtkPolyData::SafeDownCast(producer->GetOutputDataObject(0)) : nullptr;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsShapeNode::GetCenterWorld(double center[3])
 {
-  if (this->ShapeName == Tube || this->ShapeName == Cylinder)
+  const vtkMRMLMarkupsShapeTraits& traits = vtkMRMLMarkupsShapeTraits::Get(this->ShapeName);
+  if (traits.Center == vtkMRMLMarkupsShapeTraits::NoCenter)
   {
-    vtkErrorMacro("GetCenterWorld is not implemented for Tube and Cylinder shapes.");
+    vtkErrorMacro("GetCenterWorld is not implemented for " << traits.Name << " shapes.");
     return false;
   }
   if ((this->GetNumberOfUndefinedControlPoints() || this->GetNumberOfUndefinedControlPoints(true)))
@@ -1423,117 +1411,54 @@ bool vtkMRMLMarkupsShapeNode::GetCenterWorld(double center[3])
     }
     return false;
   }
+  if (this->GetNumberOfDefinedControlPoints() != traits.RequiredNumberOfControlPoints)
+  {
+    // Avoid this message when CopyContent is unexpectedly called: markups creation, point placement, moving points.
+    if (!this->GetDisableModifiedEvent())
+    {
+      vtkErrorMacro("Shape::" << traits.Name << " node does not have "
+                    << traits.RequiredNumberOfControlPoints << " defined control points.");
+    }
+    return false;
+  }
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  double p4[3] = { 0.0 };
-  switch (this->ShapeName)
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
+  // Point 0, or the middle of point 0 and the opposite point.
+  const int opposite = (traits.Center == vtkMRMLMarkupsShapeTraits::ParametricCenter) ? 3 : 1;
+  switch (traits.Center)
   {
-    case Sphere:
-      if (this->GetNumberOfDefinedControlPoints() != 2)
-      {
-        vtkErrorMacro("Shape::Sphere node does not have 2 defined control points.");
-        return false;
-      }
-      if (this->RadiusMode == Centered)
-      {
-        this->GetNthControlPointPositionWorld(0, center);
-      }
-      else
-      {
-        this->GetNthControlPointPositionWorld(0, p1);
-        this->GetNthControlPointPositionWorld(1, p2);
-        for (int i = 0; i < 3; i++)
-        {
-          center[i] = (p1[i] + p2[i]) / 2.0;
-        }
-      }
+    case vtkMRMLMarkupsShapeTraits::FirstPointCenter :
+      controlPointsWorld->GetPoint(0, center);
       break;
-    case Ring:
-      if (this->GetNumberOfDefinedControlPoints() != 3)
-      {
-        vtkErrorMacro("Shape::Ring node does not have 3 defined control points.");
-        return false;
-      }
+    case vtkMRMLMarkupsShapeTraits::RadiusModeCenter :
+    case vtkMRMLMarkupsShapeTraits::ParametricCenter :
       if (this->RadiusMode == Centered)
       {
-        this->GetNthControlPointPositionWorld(0, center);
+        controlPointsWorld->GetPoint(0, center);
       }
       else
       {
-        this->GetNthControlPointPositionWorld(0, p1);
-        this->GetNthControlPointPositionWorld(1, p2);
+        controlPointsWorld->GetPoint(0, p1);
+        controlPointsWorld->GetPoint(opposite, p2);
         for (int i = 0; i < 3; i++)
         {
           center[i] = (p1[i] + p2[i]) / 2.0;
         }
       }
       break;
-    case Disk:
-      if (this->GetNumberOfDefinedControlPoints() != 3)
-      {
-        vtkErrorMacro("Shape::Disk node does not have 3 defined control points.");
-        return false;
-      }
-      this->GetNthControlPointPositionWorld(0, center);
-      break;
-    case Cone:
+    case vtkMRMLMarkupsShapeTraits::ConeCenter :
       // Centre of mass : a quarter distance from base centre to tip.
-      if (this->GetNumberOfDefinedControlPoints() != 3)
       {
-        vtkErrorMacro("Shape::Cone node does not have 3 defined control points.");
-        return false;
-      }
-      {
-        this->GetNthControlPointPositionWorld(0, p1);
-        this->GetNthControlPointPositionWorld(2, p3);
+        controlPointsWorld->GetPoint(0, p1);
+        controlPointsWorld->GetPoint(2, p3);
         const double height = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p3));
         vtkMath::GetPointAlongLine(center, p1, p3, -height * 0.75);
       }
       break;
-    case Arc:
-      if (this->GetNumberOfDefinedControlPoints() != 3)
-      {
-        vtkErrorMacro("Shape::Arc node does not have 3 defined control points.");
-        return false;
-      }
-      this->GetNthControlPointPositionWorld(0, center);
-      break;
-    case Roman:
-    case PluckerConoid:
-    case Mobius:
-    case Kuen:
-    case ConicSpiral:
-    case CrossCap:
-    case Boy:
-    case Bour:
-    case BohemianDome:
-    case Toroid:
-    case Ellipsoid:
-      if (this->GetNumberOfDefinedControlPoints() != 4)
-      {
-        // Avoid this message when CopyContent is unexpectedly called: markups creation, point placement, moving points.
-        if (!this->GetDisableModifiedEvent())
-        {
-          vtkErrorMacro("Parametric Shape node does not have 4 defined control points.");
-        }
-        return false;
-      }
-      this->GetNthControlPointPositionWorld(0, p1);
-      this->GetNthControlPointPositionWorld(3, p4);
-      if (this->GetRadiusMode() == vtkMRMLMarkupsShapeNode::Centered)
-      {
-        vtkMath::Assign(p1, center);
-      }
-      else
-      {
-        center[0] = (p1[0] + p4[0]) / 2.0;
-        center[1] = (p1[1] + p4[1]) / 2.0;
-        center[2] = (p1[2] + p4[2]) / 2.0;
-      }
-      break;
-    default:
+    case vtkMRMLMarkupsShapeTraits::NoCenter :
       break;
   }
   return true;
@@ -1768,6 +1693,144 @@ bool vtkMRMLMarkupsShapeNode::SetParametricXYZToActiveControlPoint()
   return (this->SetParametricXYZ(distance) == 0);
 }
 
+//----------------------------------------------------------------------------
+vtkPoints * vtkMRMLMarkupsShapeNode::GetControlPointPositionsWorldBuffer()
+{
+  const int numberOfControlPoints = this->GetNumberOfControlPoints();
+  /*
+   * CurveInputPoly is refreshed by the base class whenever a control point is
+   * added, removed or moved; CurvePolyToWorldTransform follows the parent
+   * transform. Either being newer than the buffer means it is stale.
+   */
+  vtkMTimeType inputTime = 0;
+  if (this->CurveInputPoly)
+  {
+    inputTime = std::max(inputTime, this->CurveInputPoly->GetMTime());
+  }
+  if (this->CurvePolyToWorldTransform)
+  {
+    inputTime = std::max(inputTime, this->CurvePolyToWorldTransform->GetMTime());
+  }
+  if (this->ControlPointPositionsWorld->GetNumberOfPoints() == numberOfControlPoints
+    && this->ControlPointPositionsWorldTime.GetMTime() > inputTime)
+  {
+    return this->ControlPointPositionsWorld;
+  }
+
+  // One transform lookup for all points instead of one per point.
+  vtkNew<vtkGeneralTransform> localToWorld;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(this->GetParentTransformNode(), nullptr, localToWorld);
+  this->ControlPointPositionsWorld->SetNumberOfPoints(numberOfControlPoints);
+  double local[3] = { 0.0 };
+  double world[3] = { 0.0 };
+  for (int i = 0; i < numberOfControlPoints; i++)
+  {
+    this->GetNthControlPointPosition(i, local);
+    localToWorld->TransformPoint(local, world);
+    this->ControlPointPositionsWorld->SetPoint(i, world);
+  }
+  this->ControlPointPositionsWorld->Modified();
+  this->ControlPointPositionsWorldTime.Modified();
+  return this->ControlPointPositionsWorld;
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkMRMLMarkupsShapeNode::GetMeasurementInputMTime()
+{
+  vtkMTimeType inputTime = this->GetMTime();
+  if (this->CurveInputPoly)
+  {
+    inputTime = std::max(inputTime, this->CurveInputPoly->GetMTime());
+  }
+  if (this->CurvePolyToWorldTransform)
+  {
+    inputTime = std::max(inputTime, this->CurvePolyToWorldTransform->GetMTime());
+  }
+  vtkPolyData * geometries[] = { this->ShapeWorld, this->CappedTubeWorld, this->SplineWorld };
+  for (vtkPolyData * geometry : geometries)
+  {
+    if (geometry)
+    {
+      inputTime = std::max(inputTime, geometry->GetMTime());
+    }
+  }
+  return inputTime;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLMarkupsShapeNode::GetGeometryHash()
+{
+  // 64-bit FNV-1a.
+  uint64_t hash = 14695981039346656037ULL;
+  auto hashBytes = [&hash](const void * data, size_t size)
+  {
+    const unsigned char * bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  };
+  // Increment when the generated geometry changes for the same parameters.
+  const int geometryVersion = 1;
+  const int integers[] = { geometryVersion, this->ShapeName, this->RadiusMode,
+    this->SplineResolution, this->SplineNewInterpolationInterval,
+    this->ParametricJoinU, this->ParametricJoinV, this->ParametricJoinW,
+    this->ParametricTwistU, this->ParametricTwistV, this->ParametricTwistW,
+    this->ParametricClockwiseOrdering, this->ParametricScalarMode };
+  const double reals[] = { this->Resolution, this->SplineTolerance, this->TubeChordError,
+    this->ParametricN, this->ParametricN1, this->ParametricN2,
+    this->ParametricRadius, this->ParametricRingRadius, this->ParametricCrossSectionRadius,
+    this->ParametricMinimumU, this->ParametricMaximumU, this->ParametricMinimumV,
+    this->ParametricMaximumV, this->ParametricMinimumW, this->ParametricMaximumW };
+  hashBytes(integers, sizeof(integers));
+  hashBytes(reals, sizeof(reals));
+  vtkPoints * controlPointsWorld = this->GetControlPointPositionsWorldBuffer();
+  for (vtkIdType i = 0; i < controlPointsWorld->GetNumberOfPoints(); i++)
+  {
+    double point[3] = { 0.0 };
+    controlPointsWorld->GetPoint(i, point);
+    hashBytes(point, sizeof(point));
+  }
+  std::ostringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return stream.str();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeNode::SetCachedGeometry(vtkPolyData * tube, vtkPolyData * cappedTube,
+                                                vtkPolyData * spline, const std::string& hash)
+{
+  // The world pointers may refer to the geometry being released.
+  if (this->CachedTubeWorld && this->ShapeWorld == this->CachedTubeWorld)
+  {
+    this->ShapeWorld = nullptr;
+    this->CappedTubeWorld = nullptr;
+    this->SplineWorld = nullptr;
+  }
+  this->CachedTubeWorld = tube;
+  this->CachedCappedTubeWorld = cappedTube;
+  this->CachedSplineWorld = spline;
+  this->CachedGeometryHash = hash;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsShapeNode::ValidateCachedGeometry()
+{
+  if (!this->CachedTubeWorld || !this->CachedCappedTubeWorld || !this->CachedSplineWorld
+    || this->ShapeName != Tube)
+  {
+    return false;
+  }
+  return this->CachedGeometryHash == this->GetGeometryHash();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsShapeNode::ClearCachedGeometry()
+{
+  this->SetCachedGeometry(nullptr, nullptr, nullptr, std::string());
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsShapeNode::SetParametricN(double value)
 {
@@ -1854,27 +1917,27 @@ void vtkMRMLMarkupsShapeNode::ApplyDefaultParametrics()
     return;
   }
   // Set the default UVW values for the current shape.
-  ParametricsTuple tuple = this->Parametrics[this->ShapeName];
-  this->ParametricRangeU.first = std::get<MinimumU>(tuple);
-  this->ParametricRangeU.second = std::get<MaximumU>(tuple);
-  this->ParametricRangeV.first = std::get<MinimumV>(tuple);
-  this->ParametricRangeV.second = std::get<MaximumV>(tuple);
-  this->ParametricRangeW.first = std::get<MinimumW>(tuple);
-  this->ParametricRangeW.second = std::get<MaximumW>(tuple);
+  const vtkMRMLMarkupsShapeTraits& traits = vtkMRMLMarkupsShapeTraits::Get(this->ShapeName);
+  this->ParametricRangeU.first = traits.MinimumU;
+  this->ParametricRangeU.second = traits.MaximumU;
+  this->ParametricRangeV.first = traits.MinimumV;
+  this->ParametricRangeV.second = traits.MaximumV;
+  this->ParametricRangeW.first = traits.MinimumW;
+  this->ParametricRangeW.second = traits.MaximumW;
   
-  this->ParametricMinimumU = std::get<MinimumU>(tuple);
-  this->ParametricMaximumU = std::get<MaximumU>(tuple);
-  this->ParametricMinimumV = std::get<MinimumV>(tuple);
-  this->ParametricMaximumV = std::get<MaximumV>(tuple);
-  this->ParametricMinimumW = std::get<MinimumW>(tuple);
-  this->ParametricMaximumW = std::get<MaximumW>(tuple);
-  this->ParametricJoinU = std::get<JoinU>(tuple);
-  this->ParametricJoinV = std::get<JoinV>(tuple);
-  this->ParametricJoinW = std::get<JoinW>(tuple);
-  this->ParametricTwistU = std::get<TwistU>(tuple);
-  this->ParametricTwistV = std::get<TwistV>(tuple);
-  this->ParametricTwistW = std::get<TwistW>(tuple);
-  this->ParametricClockwiseOrdering = std::get<ClockwiseOrdering>(tuple);
+  this->ParametricMinimumU = traits.MinimumU;
+  this->ParametricMaximumU = traits.MaximumU;
+  this->ParametricMinimumV = traits.MinimumV;
+  this->ParametricMaximumV = traits.MaximumV;
+  this->ParametricMinimumW = traits.MinimumW;
+  this->ParametricMaximumW = traits.MaximumW;
+  this->ParametricJoinU = traits.JoinU;
+  this->ParametricJoinV = traits.JoinV;
+  this->ParametricJoinW = traits.JoinW;
+  this->ParametricTwistU = traits.TwistU;
+  this->ParametricTwistV = traits.TwistV;
+  this->ParametricTwistW = traits.TwistW;
+  this->ParametricClockwiseOrdering = traits.ClockwiseOrdering;
 }
 
 //----------------------------------------------------------------------------
@@ -1905,6 +1968,8 @@ void vtkMRMLMarkupsShapeNode::PrintSelf(ostream& os, vtkIndent indent)
   vtkMRMLPrintStdStringMacro(UseAlternateColors);
   vtkMRMLPrintBooleanMacro(SplineVisibility);
   vtkMRMLPrintIntMacro(SplineResolution);
+  vtkMRMLPrintFloatMacro(SplineTolerance);
+  vtkMRMLPrintFloatMacro(TubeChordError);
   vtkMRMLPrintBooleanMacro(SplineNewInterpolationInterval);
   vtkMRMLPrintFloatMacro(ParametricN1);
   vtkMRMLPrintFloatMacro(ParametricN2);
@@ -1948,6 +2013,8 @@ void vtkMRMLMarkupsShapeNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=tr
   vtkMRMLCopyStdStringMacro(UseAlternateColors);
   vtkMRMLCopyBooleanMacro(SplineVisibility);
   vtkMRMLCopyIntMacro(SplineResolution);
+  vtkMRMLCopyFloatMacro(SplineTolerance);
+  vtkMRMLCopyFloatMacro(TubeChordError);
   vtkMRMLCopyBooleanMacro(SplineNewInterpolationInterval);
   if (this->ShapeIsParametric)
   {
@@ -22,7 +22,9 @@
 #define __vtkmrmlmarkupsshapenode_h_
 
 #include <vtkMRMLMarkupsNode.h>
+#include <vtkCommand.h>
 #include <vtkParametricFunctionSource.h>
+#include <vtkWeakPointer.h>
 
 #include "vtkSlicerShapeModuleMRMLExport.h"
 
@@ -119,6 +121,15 @@ public:
   vtkBooleanMacro(SplineVisibility, bool);
   vtkGetMacro(SplineResolution, int);
   vtkSetClampMacro(SplineResolution, int, 10, 300);
+  // Maximum deviation in mm of the tube centerline and radius from the dense spline.
+  // 0 keeps all spline points.
+  vtkGetMacro(SplineTolerance, double);
+  vtkSetClampMacro(SplineTolerance, double, 0.0, 5.0);
+  // Maximum distance in mm between a tube facet and the circle it approximates.
+  // The number of sides then follows the local radius, up to Resolution.
+  // 0 uses Resolution sides everywhere.
+  vtkGetMacro(TubeChordError, double);
+  vtkSetClampMacro(TubeChordError, double, 0.0, 1.0);
   vtkGetMacro(SplineNewInterpolationInterval, bool);
   vtkSetMacro(SplineNewInterpolationInterval, bool);
   vtkBooleanMacro(SplineNewInterpolationInterval, bool);
@@ -202,17 +213,48 @@ public:
   bool SetParametricCrossSectionRadius(double value);
   
   bool GetCenterWorld(double center[3]);
-  vtkPolyData * GetShapeWorld() const {return this->ShapeWorld;}
+  /*
+   * The geometry of a node hidden in all 3D views may not be generated :
+   * call GenerateDeferredGeometry() first if it is needed for such nodes.
+   */
+  bool HasDeferredGeometry() const {return this->DeferredGeometryCommand.GetPointer() != nullptr;}
+  void GenerateDeferredGeometry();
+  // Updates the producer first if the shape is placed lazily.
+  vtkPolyData * GetShapeWorld() const;
   // For Tube
-  vtkPolyData * GetSplineWorld() const {return this->SplineWorld;}
+  vtkPolyData * GetSplineWorld() const;
   bool GetTrimmedSplineWorld(vtkPolyData * trimmedSpline,
                              int numberOfPointsToTrimAtStart = -1, int numberOfPointsToTrimAtEnd = -1);
   // This is to calculate volume with vtkMassProperties, it needs a closed polydata.
-  vtkPolyData * GetCappedTubeWorld() const {return this->CappedTubeWorld;}
+  vtkPolyData * GetCappedTubeWorld() const;
   // Used by 3D representation.
-  void SetShapeWorld(vtkPolyData * polydata) {this->ShapeWorld = polydata;}
+  void SetShapeWorld(vtkPolyData * polydata) {this->ShapeWorldProducer = nullptr; this->ShapeWorld = polydata;}
+  // The world shape is the output of 'producer', only updated when it is requested.
+  void SetShapeWorldProducer(vtkAlgorithm * producer);
   void SetSplineWorld(vtkPolyData * polydata) {this->SplineWorld = polydata;}
   void SetCappedTubeWorld(vtkPolyData * polydata) {this->CappedTubeWorld = polydata;}
+  /*
+   * Set by the first 3D view when it skips generating the geometry of a hidden
+   * node. GenerateDeferredGeometry() executes it once, so that measurements
+   * and API consumers can still get up to date geometry.
+   */
+  void SetDeferredGeometryCommand(vtkCommand * command) {this->DeferredGeometryCommand = command;}
+  
+  // Hash of the shape, its parameters and its world control points.
+  std::string GetGeometryHash();
+  /*
+   * Tube geometry read from a sidecar file with the node, and the hash it was
+   * generated with. Representations use it instead of regenerating the tube
+   * while ValidateCachedGeometry() is true. The first 3D view clears it once
+   * it regenerates.
+   */
+  void SetCachedGeometry(vtkPolyData * tube, vtkPolyData * cappedTube,
+                         vtkPolyData * spline, const std::string& hash);
+  bool ValidateCachedGeometry();
+  void ClearCachedGeometry();
+  vtkPolyData * GetCachedTubeWorld() const {return this->CachedTubeWorld;}
+  vtkPolyData * GetCachedCappedTubeWorld() const {return this->CachedCappedTubeWorld;}
+  vtkPolyData * GetCachedSplineWorld() const {return this->CachedSplineWorld;}
   
   vtkSetObjectMacro(ResliceNode, vtkMRMLNode);
   vtkGetObjectMacro(ResliceNode, vtkMRMLNode);
@@ -230,6 +272,7 @@ public:
   // - The closest spline point to the middle point between the pair of control points.
   bool GetNthControlPointSplineIntersection(int pointIndex, vtkPoints * point);
   bool SnapNthControlPointToTubeSurface(int pointIndex = 0, bool bypassLockedState = false);
+  // All pairs are snapped against the current spline; on failure, no control point is moved.
   bool SnapAllControlPointsToTubeSurface(bool bypassLockedState = false);
   bool UpdateNumberOfControlPoints(int numberOfControlPoints, bool bypassLockedState = false);
   vtkGetMacro(DisplayCappedTube, bool);
@@ -259,6 +302,15 @@ public:
   
   bool SetParametricXYZToActiveControlPoint();
 
+  // World positions of all control points, indexed as the control points.
+  // The buffer is refilled only if a control point or the parent transform
+  // has changed since the last call. It is owned by the node, don't modify it.
+  vtkPoints * GetControlPointPositionsWorldBuffer();
+  // Latest change of anything measurements depend on : the node, its control
+  // points, the parent transform and the generated geometry. Publishing
+  // measurements modifies the node : see vtkMRMLMeasurementShape::MarkComputed().
+  vtkMTimeType GetMeasurementInputMTime();
+
   // Handled in logic; is ignored in the storage node.
   std::string GetUseAlternateColors() {return UseAlternateColors;};
   void SetUseAlternateColors(const std::string& nodeID = "vtkMRMLColorTableNodeLabels");
@@ -298,6 +350,8 @@ protected:
   static void OnPointPositionUndefined(vtkObject *caller,
                                        unsigned long event, void *clientData, void *callData);
   bool GetControlPointPairPosition(vtkPolyData * spline, int pointIndex, vtkPoints * result);
+  // New positions of a pair of control points, orthogonal to the spline at their middle.
+  bool GetSnappedControlPointPair(const double * p1, const double * p2, double * newP1, double * newP2);
 
   // Any shape
   vtkSmartPointer<vtkCallbackCommand> OnJumpToPointCallback;
@@ -316,6 +370,8 @@ protected:
   bool ScalarVisibility = false;
   bool SplineVisibility = false;
   int SplineResolution = 100;
+  double SplineTolerance = 0.0;
+  double TubeChordError = 0.0;
   // In the original scheme, this was the number of control point pairs.
   // In the new scheme, this is the number of intervals between control point pairs.
   bool SplineNewInterpolationInterval = false;
@@ -362,23 +418,24 @@ protected:
   std::pair<double, double> ParametricRangeW;
   // MinimumW, MaximumW, JoinW and TwistU do not seem to be used anywhere
   // in vtkParametric*.{h,cxx}.
-  enum {MinimumU = 0, MaximumU, MinimumV, MaximumV, MinimumW, MaximumW,
-        JoinU, JoinV, JoinW, TwistU, TwistV, TwistW,
-        ClockwiseOrdering}; // Column names in tuples
-  // Default UVW values for one geometry.
-  typedef std::tuple<double, double, double, double, double, double,
-                    bool, bool, bool, bool, bool, bool,
-                    bool> ParametricsTuple;
-  // Collection of defaults, from the header files.
-  typedef std::map<int, ParametricsTuple> ParametricsMap;
-  ParametricsMap Parametrics;
-  // Set defaut UVW whenever a shape is selected.
+  // Set defaut UVW whenever a shape is selected; see vtkMRMLMarkupsShapeTraits.
   void ApplyDefaultParametrics();
   
   vtkPolyData * ShapeWorld = nullptr;
+  vtkWeakPointer<vtkAlgorithm> ShapeWorldProducer;
+  // Owned by the representation.
+  vtkWeakPointer<vtkCommand> DeferredGeometryCommand;
   vtkPolyData * CappedTubeWorld = nullptr;
   vtkPolyData * SplineWorld = nullptr;
   vtkMRMLNode * ResliceNode = nullptr;
+  
+  vtkSmartPointer<vtkPolyData> CachedTubeWorld;
+  vtkSmartPointer<vtkPolyData> CachedCappedTubeWorld;
+  vtkSmartPointer<vtkPolyData> CachedSplineWorld;
+  std::string CachedGeometryHash;
+
+  vtkSmartPointer<vtkPoints> ControlPointPositionsWorld;
+  vtkTimeStamp ControlPointPositionsWorldTime;
 
 private:
   bool RemovingPairControlPoint = false; // Tube
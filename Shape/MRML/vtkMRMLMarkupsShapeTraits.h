@@ -0,0 +1,195 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkmrmlmarkupsshapetraits_h_
+#define __vtkmrmlmarkupsshapetraits_h_
+
+#include "vtkMRMLMarkupsShapeNode.h"
+
+// STD includes
+#include <cstring>
+#include <string>
+
+/*
+ * Constant description of each shape, in the order of the shape names of
+ * vtkMRMLMarkupsShapeNode : control points, measurements, centre and
+ * reslicing rules, and the default UVW of parametric shapes.
+ *
+ * The node, its measurements and the representations read this table
+ * instead of switching on the shape name; a new shape is described here.
+ * Nothing is allocated per node.
+ */
+struct vtkMRMLMarkupsShapeTraits
+{
+  // The measurements a node creates; see vtkMRMLMarkupsShapeNode::Force*Measurements().
+  enum MeasurementSet
+  {
+    NoMeasurements = 0,
+    SphereMeasurements,
+    RingMeasurements,
+    DiskMeasurements,
+    TubeMeasurements,
+    CylinderMeasurements,
+    ConeMeasurements,
+    ArcMeasurements,
+    EllipsoidMeasurements,
+    ToroidMeasurements,
+    BohemianDomeMeasurements,
+    ConicSpiralMeasurements,
+    TransformScaledMeasurements,
+    TransformScaledVolumeMeasurements
+  };
+  // How vtkMRMLMarkupsShapeNode::GetCenterWorld() finds the centre.
+  enum CenterRule
+  {
+    NoCenter = 0,
+    FirstPointCenter,
+    RadiusModeCenter, // Point 0 if centered, else between points 0 and 1.
+    ConeCenter, // Centre of mass.
+    ParametricCenter // Point 0 if centered, else between points 0 and 3.
+  };
+  // How vtkMRMLMarkupsShapeNode::ResliceToControlPoints() orients the slice.
+  enum ResliceRule
+  {
+    NoReslice = 0,
+    LineReslice,
+    PlaneReslice,
+    TubeCrossSectionReslice,
+    ParametricPlaneReslice // Points 0, 1 and 3.
+  };
+  
+  int ShapeName;
+  const char * Name;
+  bool Parametric;
+  int RequiredNumberOfControlPoints;
+  int MaximumNumberOfControlPoints;
+  MeasurementSet Measurements;
+  // Names between '|' of the measurements computed on the generated geometry.
+  const char * GeometryMeasurements;
+  CenterRule Center;
+  ResliceRule Reslice;
+  // Default UVW of parametric shapes; obtained from the vtkParametric* header files.
+  double MinimumU;
+  double MaximumU;
+  double MinimumV;
+  double MaximumV;
+  double MinimumW;
+  double MaximumW;
+  bool JoinU;
+  bool JoinV;
+  bool JoinW;
+  bool TwistU;
+  bool TwistV;
+  bool TwistW;
+  bool ClockwiseOrdering;
+  
+  // The traits of a shape; ShapeName_Last and unknown values get an empty entry.
+  static const vtkMRMLMarkupsShapeTraits& Get(int shapeName);
+  
+  // Whether the measurement 'name' needs the generated geometry; others are analytic.
+  bool IsGeometryMeasurement(const char * name) const
+  {
+    return name && std::strstr(this->GeometryMeasurements, (std::string("|") + name + "|").c_str());
+  }
+  
+private:
+  static constexpr double Pi = 3.14159265358979323846;
+  template <int N>
+  static constexpr bool IsInShapeNameOrder(const vtkMRMLMarkupsShapeTraits (&table)[N])
+  {
+    for (int i = 0; i < N; i++)
+    {
+      if (table[i].ShapeName != i)
+      {
+        return false;
+      }
+    }
+    return N == vtkMRMLMarkupsShapeNode::ShapeName_Last + 1;
+  }
+};
+
+//----------------------------------------------------------------------------
+inline const vtkMRMLMarkupsShapeTraits& vtkMRMLMarkupsShapeTraits::Get(int shapeName)
+{
+  typedef vtkMRMLMarkupsShapeNode Node;
+  typedef vtkMRMLMarkupsShapeTraits Traits;
+  /*
+   * Tube : the required number of control points should be 4, but the
+   * toolbar's new control point button would remain grayed for ever.
+   * With -1, hovering on a control point activates the button.
+   */
+  static constexpr Traits table[] = {
+    // Shape, name, parametric, required and maximum number of points, measurements and those
+    // computed on the generated geometry, centre, reslicing,
+    // U, V and W ranges, JoinU/V/W, TwistU/V/W, ClockwiseOrdering.
+    { Node::Sphere, "Sphere", false, 2, 2, SphereMeasurements, "", RadiusModeCenter, LineReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    // Third point is used to calculate normal relative to the center in 3D view.
+    { Node::Ring, "Ring", false, 3, 3, RingMeasurements, "", RadiusModeCenter, PlaneReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    // Point 0 : always the center.
+    { Node::Disk, "Disk", false, 3, 3, DiskMeasurements, "|area|innerArea|outerArea|", FirstPointCenter, PlaneReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::Tube, "Tube", false, -1, -1, TubeMeasurements, "|area|volume|", NoCenter, TubeCrossSectionReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    // Points 0 : centre at one end; point 2 : radius; point 3 : centre of the opposite end
+    { Node::Cylinder, "Cylinder", false, 3, 3, CylinderMeasurements, "", NoCenter, PlaneReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    // Points 0 : centre of the base; point 2 : radius; point 3 : tip
+    { Node::Cone, "Cone", false, 3, 3, ConeMeasurements, "", ConeCenter, PlaneReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    // Points 0 : centre; point 2 : radius and polar vector; point 3 : normal and angle
+    { Node::Arc, "Arc", false, 3, 3, ArcMeasurements, "", FirstPointCenter, PlaneReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::Ellipsoid, "Ellipsoid", true, 4, 4, EllipsoidMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      -1.0 * Pi, 1.0 * Pi, -0.5 * Pi, 0.5 * Pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::Toroid, "Toroid", true, 4, 4, ToroidMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 2.0 * Pi, 0.0, 2.0 * Pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 1 },
+    { Node::BohemianDome, "BohemianDome", true, 4, 4, BohemianDomeMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      -1.0 * Pi, 1.0 * Pi, -1.0 * Pi, 1.0 * Pi, 0.0, 1.0, 1, 1, 0, 0, 0, 0, 0 },
+    { Node::Bour, "Bour", true, 4, 4, TransformScaledMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 1.0, 0.0, 4.0 * Pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::Boy, "Boy", true, 4, 4, TransformScaledVolumeMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 1.0 * Pi, 0.0, 1.0 * Pi, 0.0, 1.0, 1, 1, 0, 1, 1, 0, 0 },
+    { Node::ConicSpiral, "ConicSpiral", true, 4, 4, ConicSpiralMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 2.0 * Pi, 0.0, 2.0 * Pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::CrossCap, "CrossCap", true, 4, 4, TransformScaledVolumeMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 1.0 * Pi, 0.0, 1.0 * Pi, 0.0, 1.0, 1, 1, 0, 1, 1, 0, 0 },
+    { Node::Kuen, "Kuen", true, 4, 4, TransformScaledMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      -4.5, 4.5, 0.05, 1.0 * Pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::Mobius, "Mobius", true, 4, 4, TransformScaledMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 2.0 * Pi, -1.0, 1.0, 0.0, 1.0, 1, 0, 0, 0, 0, 0, 0 },
+    { Node::PluckerConoid, "PluckerConoid", true, 4, 4, TransformScaledMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 3.0, 0.0, 2.0 * Pi, 0.0, 1.0, 0, 0, 0, 0, 0, 0, 0 },
+    { Node::Roman, "Roman", true, 4, 4, TransformScaledMeasurements, "|area|volume|", ParametricCenter, ParametricPlaneReslice,
+      0.0, 1.0 * Pi, 0.0, 1.0 * Pi, 0.0, 1.0, 1, 1, 0, 1, 0, 0, 0 },
+    // No shape yet.
+    { Node::ShapeName_Last, "", false, 0, 0, NoMeasurements, "", NoCenter, NoReslice,
+      0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0, 0 }
+  };
+  static_assert(IsInShapeNameOrder(table), "Shape traits must follow the order of the shape names.");
+  if (shapeName < 0 || shapeName > Node::ShapeName_Last)
+  {
+    return table[Node::ShapeName_Last];
+  }
+  return table[shapeName];
+}
+
+#endif // __vtkmrmlmarkupsshapetraits_h_
@@ -3,15 +3,33 @@
 
 // Markups includes
 #include "vtkMRMLMarkupsShapeNode.h"
+#include "vtkMRMLMarkupsProfiler.h"
+#include "vtkMRMLMarkupsShapeTraits.h"
 
 #include <vtkMath.h>
 #include <vtkTriangleFilter.h>
 #include <vtkMassProperties.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 
+#include <algorithm>
 #include <cmath>
 
 vtkStandardNewMacro(vtkMRMLMeasurementShape);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// The generated geometry that mesh-based measurements read.
+vtkPolyData * GetMeasuredGeometry(vtkMRMLMarkupsShapeNode * shapeNode)
+{
+  return shapeNode->GetShapeName() == vtkMRMLMarkupsShapeNode::Tube
+    ? shapeNode->GetCappedTubeWorld() : shapeNode->GetShapeWorld();
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkMRMLMeasurementShape::vtkMRMLMeasurementShape()
 {
@@ -27,69 +45,178 @@ void vtkMRMLMeasurementShape::PrintSelf(std::ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkMRMLMeasurementShape::Compute()
 {
+  this->ComputeTime.Modified();
   vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!shapeNode)
   {
-    this->SetValue(0.0, "#ERR");
+    this->SetShapeValue(0.0, "#ERR");
     return;
   }
+  // Not GetName() : it returns a copy, even when profiling is off.
+  vtkMRMLMarkupsProfiler::Scope timer(shapeNode, "Measurement", this->Name.c_str());
+  // Not from worker threads : deferred computations get their geometry generated beforehand.
+  if (!this->DeferValue && this->ReadsGeometry())
+  {
+    shapeNode->GenerateDeferredGeometry();
+  }
   
   if (shapeNode->GetNumberOfControlPoints() < shapeNode->GetRequiredNumberOfControlPoints())
   {
     return;
   }
   
-  switch (shapeNode->GetShapeName())
+  switch (vtkMRMLMarkupsShapeTraits::Get(shapeNode->GetShapeName()).Measurements)
   {
-    case vtkMRMLMarkupsShapeNode::Sphere :
+    case vtkMRMLMarkupsShapeTraits::SphereMeasurements :
       this->ComputeSphere();
       break;
-    case vtkMRMLMarkupsShapeNode::Ring:
+    case vtkMRMLMarkupsShapeTraits::RingMeasurements :
       this->ComputeRing();
       break;
-    case vtkMRMLMarkupsShapeNode::Disk:
+    case vtkMRMLMarkupsShapeTraits::DiskMeasurements :
       this->ComputeDisk();
       break;
-    case vtkMRMLMarkupsShapeNode::Tube:
+    case vtkMRMLMarkupsShapeTraits::TubeMeasurements :
       this->ComputeTube();
       break;
-    case vtkMRMLMarkupsShapeNode::Cylinder:
+    case vtkMRMLMarkupsShapeTraits::CylinderMeasurements :
       this->ComputeCylinder();
       break;
-    case vtkMRMLMarkupsShapeNode::Cone:
+    case vtkMRMLMarkupsShapeTraits::ConeMeasurements :
       this->ComputeCone();
       break;
-    case vtkMRMLMarkupsShapeNode::Arc:
+    case vtkMRMLMarkupsShapeTraits::ArcMeasurements :
       this->ComputeArc();
       break;
-    case vtkMRMLMarkupsShapeNode::Ellipsoid:
+    case vtkMRMLMarkupsShapeTraits::EllipsoidMeasurements :
       this->ComputeEllipsoid();
       break;
-    case vtkMRMLMarkupsShapeNode::Toroid:
+    case vtkMRMLMarkupsShapeTraits::ToroidMeasurements :
       this->ComputeToroid();
       break;
-    case vtkMRMLMarkupsShapeNode::BohemianDome:
+    case vtkMRMLMarkupsShapeTraits::BohemianDomeMeasurements :
       this->ComputeBohemianDome();
       break;
-    case vtkMRMLMarkupsShapeNode::ConicSpiral:
+    case vtkMRMLMarkupsShapeTraits::ConicSpiralMeasurements :
       this->ComputeConicSpiral();
       break;
-    case vtkMRMLMarkupsShapeNode::Roman:
-    case vtkMRMLMarkupsShapeNode::PluckerConoid:
-    case vtkMRMLMarkupsShapeNode::Mobius:
-    case vtkMRMLMarkupsShapeNode::Kuen:
-    case vtkMRMLMarkupsShapeNode::CrossCap:
-    case vtkMRMLMarkupsShapeNode::Boy:
-    case vtkMRMLMarkupsShapeNode::Bour:
+    case vtkMRMLMarkupsShapeTraits::TransformScaledMeasurements :
+    case vtkMRMLMarkupsShapeTraits::TransformScaledVolumeMeasurements :
       this->ComputeTransformScaledShape();
       break;
-    default :
+    case vtkMRMLMarkupsShapeTraits::NoMeasurements :
       vtkErrorMacro("Unknown shape.");
       return;
   };
 }
 
 
+//----------------------------------------------------------------------------
+bool vtkMRMLMeasurementShape::ReadsGeometry() const
+{
+  vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
+  return shapeNode
+    && vtkMRMLMarkupsShapeTraits::Get(shapeNode->GetShapeName()).IsGeometryMeasurement(this->Name.c_str());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMeasurementShape::ComputeMassProperties(vtkPolyData * mesh, double& area, double& volume)
+{
+  if (!mesh)
+  {
+    return false;
+  }
+  vtkNew<vtkTriangleFilter> triangleFilter;
+  vtkNew<vtkMassProperties> massProperties;
+  triangleFilter->SetInputData(mesh);
+  triangleFilter->Update();
+  massProperties->SetInputData(triangleFilter->GetOutput());
+  massProperties->Update();
+  area = massProperties->GetSurfaceArea();
+  volume = massProperties->GetVolume();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLMeasurementShape::Input vtkMRMLMeasurementShape::CopyInput(vtkMRMLMarkupsShapeNode * shapeNode, bool geometry)
+{
+  Input input;
+  if (!shapeNode)
+  {
+    return input;
+  }
+  input.ControlPointsWorld = vtkSmartPointer<vtkPoints>::New();
+  input.ControlPointsWorld->DeepCopy(shapeNode->GetControlPointPositionsWorldBuffer());
+  if (!geometry)
+  {
+    return input;
+  }
+  shapeNode->GenerateDeferredGeometry();
+  vtkPolyData * geometryWorld = GetMeasuredGeometry(shapeNode);
+  if (geometryWorld)
+  {
+    // Detached from the pipeline : nothing is updated while computing.
+    input.GeometryWorld = vtkSmartPointer<vtkPolyData>::New();
+    input.GeometryWorld->ShallowCopy(geometryWorld);
+  }
+  return input;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMeasurementShape::ComputeDeferred(const Input& input)
+{
+  this->HasPendingValue = false;
+  this->DeferValue = true;
+  this->DeferredInput = &input;
+  this->Compute();
+  this->DeferredInput = nullptr;
+  this->DeferValue = false;
+}
+
+//----------------------------------------------------------------------------
+vtkPoints * vtkMRMLMeasurementShape::GetControlPointsWorld(vtkMRMLMarkupsShapeNode * shapeNode) const
+{
+  if (this->DeferredInput)
+  {
+    return this->DeferredInput->ControlPointsWorld;
+  }
+  return shapeNode->GetControlPointPositionsWorldBuffer();
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData * vtkMRMLMeasurementShape::GetGeometryWorld(vtkMRMLMarkupsShapeNode * shapeNode) const
+{
+  if (this->DeferredInput)
+  {
+    return this->DeferredInput->GeometryWorld;
+  }
+  return GetMeasuredGeometry(shapeNode);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMeasurementShape::PublishValue()
+{
+  if (!this->HasPendingValue)
+  {
+    return;
+  }
+  this->HasPendingValue = false;
+  this->SetValue(this->PendingValue, this->PendingQuantityCode.c_str());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMeasurementShape::SetShapeValue(double value, const char * quantityCode)
+{
+  if (!this->DeferValue)
+  {
+    this->SetValue(value, quantityCode);
+    return;
+  }
+  this->PendingValue = value;
+  this->PendingQuantityCode = quantityCode ? quantityCode : "";
+  this->HasPendingValue = true;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLMeasurementShape::ComputeDisk()
 {
@@ -97,73 +224,82 @@ void vtkMRMLMeasurementShape::ComputeDisk()
   vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!shapeNode)
   {
-      this->SetValue(measurement, "#ERR");
+      this->SetShapeValue(measurement, "#ERR");
       return;
   }
   
-  double closestPoint[3] = { 0.0 }; // Unused here
-  double farthestPoint[3] = { 0.0 };
-  double innerRadius = 0.0, outerRadius = 0.0;
-  if (!shapeNode->DescribeDiskPointSpacing(closestPoint, farthestPoint, innerRadius, outerRadius))
+  // As DescribeDiskPointSpacing(), from the deferred input if any.
+  if (shapeNode->GetNumberOfDefinedControlPoints(true) != 3)
   {
     vtkDebugMacro("Point proximity description failure.");
     return;
   }
+  double p1[3] = { 0.0 }; // center
+  double p2[3] = { 0.0 };
+  double p3[3] = { 0.0 };
+  vtkPoints * controlPointsWorld = this->GetControlPointsWorld(shapeNode);
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
+  const double distance2 = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+  const double distance3 = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p3));
+  const double innerRadius = std::min(distance2, distance3);
+  const double outerRadius = std::max(distance2, distance3);
   
   if (this->GetName() == std::string("innerRadius"))
   {
-    this->SetValue(innerRadius, this->GetName().c_str());
+    this->SetShapeValue(innerRadius, this->GetName().c_str());
   }
   else
   if (this->GetName() == std::string("outerRadius"))
   {
-    this->SetValue(outerRadius, this->GetName().c_str());
+    this->SetShapeValue(outerRadius, this->GetName().c_str());
   }
   else
   if (this->GetName() == std::string("width"))
     {
       measurement = outerRadius - innerRadius;
-      this->SetValue(measurement, this->GetName().c_str());
+      this->SetShapeValue(measurement, this->GetName().c_str());
     }
   else
   if (this->GetName() == std::string("area"))
   {
-    if (!shapeNode->GetShapeWorld())
+    if (!this->GetGeometryWorld(shapeNode))
     {
-        this->SetValue(measurement, "#ERR");
+        this->SetShapeValue(measurement, "#ERR");
         return;
     }
     // vtkMassProperties fails here : <Input data type must be VTK_TRIANGLE not 9>.
     const double innerArea = vtkMath::Pi() * innerRadius * innerRadius;
     const double outerArea = vtkMath::Pi() * outerRadius * outerRadius;
     measurement = outerArea - innerArea;
-    this->SetValue(measurement, this->GetName().c_str());
+    this->SetShapeValue(measurement, this->GetName().c_str());
   }
   else
   if (this->GetName() == std::string("innerArea"))
   {
-    if (!shapeNode->GetShapeWorld())
+    if (!this->GetGeometryWorld(shapeNode))
     {
-      this->SetValue(measurement, "#ERR");
+      this->SetShapeValue(measurement, "#ERR");
       return;
     }
     const double innerArea = vtkMath::Pi() * innerRadius * innerRadius;
-    this->SetValue(innerArea, this->GetName().c_str());
+    this->SetShapeValue(innerArea, this->GetName().c_str());
   }
   else
     if (this->GetName() == std::string("outerArea"))
     {
-      if (!shapeNode->GetShapeWorld())
+      if (!this->GetGeometryWorld(shapeNode))
       {
-        this->SetValue(measurement, "#ERR");
+        this->SetShapeValue(measurement, "#ERR");
         return;
       }
       const double outerArea = vtkMath::Pi() * outerRadius * outerRadius;
-      this->SetValue(outerArea, this->GetName().c_str());
+      this->SetShapeValue(outerArea, this->GetName().c_str());
     }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
   }
   
 }
@@ -175,14 +311,15 @@ void vtkMRMLMeasurementShape::ComputeRing()
   vtkMRMLMarkupsShapeNode * ringNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!ringNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
-  ringNode->GetNthControlPointPositionWorld(0, p1);
-  ringNode->GetNthControlPointPositionWorld(1, p2);
+  vtkPoints * controlPointsWorld = this->GetControlPointsWorld(ringNode);
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
   const double lineLength = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   
   if (this->GetName() == std::string("radius"))
@@ -210,10 +347,10 @@ void vtkMRMLMeasurementShape::ComputeRing()
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -223,14 +360,15 @@ void vtkMRMLMeasurementShape::ComputeSphere()
   vtkMRMLMarkupsShapeNode * sphereNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!sphereNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
-  sphereNode->GetNthControlPointPositionWorld(0, p1);
-  sphereNode->GetNthControlPointPositionWorld(1, p2);
+  vtkPoints * controlPointsWorld = this->GetControlPointsWorld(sphereNode);
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
   const double lineLength = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   
   if (this->GetName() == std::string("radius"))
@@ -272,10 +410,10 @@ void vtkMRMLMeasurementShape::ComputeSphere()
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -283,33 +421,29 @@ void vtkMRMLMeasurementShape::ComputeTube()
 {
   double measurement = 0.0;
   vtkMRMLMarkupsShapeNode * tubeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
-  if (!tubeNode || tubeNode->GetCappedTubeWorld() == nullptr)
+  double area = 0.0;
+  double volume = 0.0;
+  if (!tubeNode || !vtkMRMLMeasurementShape::ComputeMassProperties(this->GetGeometryWorld(tubeNode), area, volume))
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  vtkNew<vtkTriangleFilter> triangleFilter;
-  vtkNew<vtkMassProperties> massProperties;
-  triangleFilter->SetInputData(tubeNode->GetCappedTubeWorld());
-  triangleFilter->Update();
-  massProperties->SetInputData(triangleFilter->GetOutput());
-  massProperties->Update();
   
   if (this->GetName() == std::string("area"))
   {
-    measurement = massProperties->GetSurfaceArea();
+    measurement = area;
   }
   else
   if (this->GetName() == std::string("volume"))
   {
-    measurement = massProperties->GetVolume();
+    measurement = volume;
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -319,16 +453,17 @@ void vtkMRMLMeasurementShape::ComputeCone()
   vtkMRMLMarkupsShapeNode * coneNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!coneNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  coneNode->GetNthControlPointPositionWorld(0, p1);
-  coneNode->GetNthControlPointPositionWorld(1, p2);
-  coneNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = this->GetControlPointsWorld(coneNode);
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   const double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   const double height = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p3));
   const double slant = std::sqrt(vtkMath::Distance2BetweenPoints(p2, p3));
@@ -365,10 +500,10 @@ void vtkMRMLMeasurementShape::ComputeCone()
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -378,16 +513,17 @@ void vtkMRMLMeasurementShape::ComputeCylinder()
   vtkMRMLMarkupsShapeNode * cylinderNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!cylinderNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  cylinderNode->GetNthControlPointPositionWorld(0, p1);
-  cylinderNode->GetNthControlPointPositionWorld(1, p2);
-  cylinderNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = this->GetControlPointsWorld(cylinderNode);
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   const double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   const double height = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p3));
   
@@ -406,16 +542,22 @@ void vtkMRMLMeasurementShape::ComputeCylinder()
     measurement = (2 * vtkMath::Pi() * radius * height);
   }
   else
+  if (this->GetName() == std::string("totalArea"))
+  {
+    // Closed surface, as rendered with caps.
+    measurement = (2 * vtkMath::Pi() * radius * height) + (2 * vtkMath::Pi() * radius * radius);
+  }
+  else
   if (this->GetName() == std::string("volume"))
   {
     measurement = (vtkMath::Pi() * radius * radius * height);
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -425,16 +567,17 @@ void vtkMRMLMeasurementShape::ComputeArc()
   vtkMRMLMarkupsShapeNode * arcNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!arcNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
   
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  arcNode->GetNthControlPointPositionWorld(0, p1);
-  arcNode->GetNthControlPointPositionWorld(1, p2);
-  arcNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = this->GetControlPointsWorld(arcNode);
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   const double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   
   double radiusVector1[3] = { 0.0 };
@@ -459,10 +602,10 @@ void vtkMRMLMeasurementShape::ComputeArc()
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -472,15 +615,18 @@ void vtkMRMLMeasurementShape::ComputeEllipsoid()
   vtkMRMLMarkupsShapeNode * ellipsoidNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!ellipsoidNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
+    return;
+  }
+  // Only area and volume need the mesh.
+  double area = 0.0;
+  double volume = 0.0;
+  if (this->ReadsGeometry()
+    && !vtkMRMLMeasurementShape::ComputeMassProperties(this->GetGeometryWorld(ellipsoidNode), area, volume))
+  {
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  vtkNew<vtkTriangleFilter> triangleFilter;
-  vtkNew<vtkMassProperties> massProperties;
-  triangleFilter->SetInputData(ellipsoidNode->GetShapeWorld());
-  triangleFilter->Update();
-  massProperties->SetInputData(triangleFilter->GetOutput());
-  massProperties->Update();
   
   double xRadius = ellipsoidNode->GetParametricX();
   double yRadius = ellipsoidNode->GetParametricY();
@@ -514,19 +660,19 @@ void vtkMRMLMeasurementShape::ComputeEllipsoid()
   if (this->GetName() == std::string("volume"))
   {
     // Setting UVW values are not friendly to volume calculation.
-    measurement = massProperties->GetVolume();
+    measurement = volume;
   }
   else
     if (this->GetName() == std::string("area"))
     {
-      measurement = massProperties->GetSurfaceArea();
+      measurement = area;
     }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -536,15 +682,18 @@ void vtkMRMLMeasurementShape::ComputeToroid()
   vtkMRMLMarkupsShapeNode * toroidNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!toroidNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
+    return;
+  }
+  // Only area and volume need the mesh.
+  double area = 0.0;
+  double volume = 0.0;
+  if (this->ReadsGeometry()
+    && !vtkMRMLMeasurementShape::ComputeMassProperties(this->GetGeometryWorld(toroidNode), area, volume))
+  {
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  vtkNew<vtkTriangleFilter> triangleFilter;
-  vtkNew<vtkMassProperties> massProperties;
-  triangleFilter->SetInputData(toroidNode->GetShapeWorld());
-  triangleFilter->Update();
-  massProperties->SetInputData(triangleFilter->GetOutput());
-  massProperties->Update();
   
   double xRadius = toroidNode->GetParametricX();
   double yRadius = toroidNode->GetParametricY();
@@ -587,19 +736,19 @@ void vtkMRMLMeasurementShape::ComputeToroid()
   else
   if (this->GetName() == std::string("volume"))
   {
-    measurement = massProperties->GetVolume();
+    measurement = volume;
   }
   else
   if (this->GetName() == std::string("area"))
   {
-    measurement = massProperties->GetSurfaceArea();
+    measurement = area;
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -609,15 +758,18 @@ void vtkMRMLMeasurementShape::ComputeBohemianDome()
   vtkMRMLMarkupsShapeNode * bohemianDomeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!bohemianDomeNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
+    return;
+  }
+  // Only area and volume need the mesh.
+  double area = 0.0;
+  double volume = 0.0;
+  if (this->ReadsGeometry()
+    && !vtkMRMLMeasurementShape::ComputeMassProperties(this->GetGeometryWorld(bohemianDomeNode), area, volume))
+  {
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  vtkNew<vtkTriangleFilter> triangleFilter;
-  vtkNew<vtkMassProperties> massProperties;
-  triangleFilter->SetInputData(bohemianDomeNode->GetShapeWorld());
-  triangleFilter->Update();
-  massProperties->SetInputData(triangleFilter->GetOutput());
-  massProperties->Update();
   
   if (this->GetName() == std::string("a"))
   {
@@ -636,19 +788,19 @@ void vtkMRMLMeasurementShape::ComputeBohemianDome()
   else
   if (this->GetName() == std::string("volume"))
   {
-    measurement = massProperties->GetVolume(); // Fails; not called.
+    measurement = volume; // Fails; not called.
   }
   else
   if (this->GetName() == std::string("area"))
   {
-    measurement = massProperties->GetSurfaceArea();
+    measurement = area;
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -658,15 +810,18 @@ void vtkMRMLMeasurementShape::ComputeConicSpiral()
   vtkMRMLMarkupsShapeNode * conicSpiralNode = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!conicSpiralNode)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
+    return;
+  }
+  // Only area and volume need the mesh.
+  double area = 0.0;
+  double volume = 0.0;
+  if (this->ReadsGeometry()
+    && !vtkMRMLMeasurementShape::ComputeMassProperties(this->GetGeometryWorld(conicSpiralNode), area, volume))
+  {
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  vtkNew<vtkTriangleFilter> triangleFilter;
-  vtkNew<vtkMassProperties> massProperties;
-  triangleFilter->SetInputData(conicSpiralNode->GetShapeWorld());
-  triangleFilter->Update();
-  massProperties->SetInputData(triangleFilter->GetOutput());
-  massProperties->Update();
   
   if (this->GetName() == std::string("x"))
   {
@@ -690,14 +845,14 @@ void vtkMRMLMeasurementShape::ComputeConicSpiral()
   else
   if (this->GetName() == std::string("area"))
   {
-    measurement = massProperties->GetSurfaceArea();
+    measurement = area;
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -707,15 +862,18 @@ void vtkMRMLMeasurementShape::ComputeTransformScaledShape()
   vtkMRMLMarkupsShapeNode * node = vtkMRMLMarkupsShapeNode::SafeDownCast(this->InputMRMLNode);
   if (!node)
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
+    return;
+  }
+  // Only area and volume need the mesh.
+  double area = 0.0;
+  double volume = 0.0;
+  if (this->ReadsGeometry()
+    && !vtkMRMLMeasurementShape::ComputeMassProperties(this->GetGeometryWorld(node), area, volume))
+  {
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  vtkNew<vtkTriangleFilter> triangleFilter;
-  vtkNew<vtkMassProperties> massProperties;
-  triangleFilter->SetInputData(node->GetShapeWorld());
-  triangleFilter->Update();
-  massProperties->SetInputData(triangleFilter->GetOutput());
-  massProperties->Update();
   
   double xRadius = node->GetParametricX();
   double yRadius = node->GetParametricY();
@@ -738,17 +896,17 @@ void vtkMRMLMeasurementShape::ComputeTransformScaledShape()
   else
   if (this->GetName() == std::string("volume"))
   {
-    measurement = massProperties->GetVolume();
+    measurement = volume;
   }
   else
   if (this->GetName() == std::string("area"))
   {
-    measurement = massProperties->GetSurfaceArea();
+    measurement = area;
   }
   else
   {
-    this->SetValue(measurement, "#ERR");
+    this->SetShapeValue(measurement, "#ERR");
     return;
   }
-  this->SetValue(measurement, this->GetName().c_str());
+  this->SetShapeValue(measurement, this->GetName().c_str());
 }
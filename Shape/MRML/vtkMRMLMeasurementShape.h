@@ -7,6 +7,17 @@
 // Markups includes
 #include "vtkSlicerShapeModuleMRMLExport.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <string>
+
+class vtkMRMLMarkupsShapeNode;
+class vtkPoints;
+class vtkPolyData;
+
 class VTK_SLICER_SHAPE_MODULE_MRML_EXPORT vtkMRMLMeasurementShape : public vtkMRMLMeasurement
 {
 public:
@@ -20,6 +31,26 @@ public:
     { return vtkMRMLMeasurementShape::New(); }
     void Compute() override;
     
+    // Copies of what the measurements of a node read, independent of the node.
+    struct Input
+    {
+      vtkSmartPointer<vtkPoints> ControlPointsWorld;
+      // Only if requested; null without generated geometry.
+      vtkSmartPointer<vtkPolyData> GeometryWorld;
+    };
+    // Not thread safe : refreshes the cached world positions and, with 'geometry', generates and updates the geometry.
+    static Input CopyInput(vtkMRMLMarkupsShapeNode * shapeNode, bool geometry);
+    // Compute from 'input' only, without publishing, e.g. from a worker thread; see PublishValue().
+    void ComputeDeferred(const Input& input);
+    // Set the value kept by ComputeDeferred(), if any, firing the usual events.
+    void PublishValue();
+    // Last time the value was computed, published or not.
+    vtkMTimeType GetComputeTime() const { return this->ComputeTime.GetMTime(); }
+    // Consider the value current from now on, e.g. once its node was modified to publish it.
+    void MarkComputed() { this->ComputeTime.Modified(); }
+    // Whether this measurement is computed on the generated geometry; see vtkMRMLMarkupsShapeTraits.
+    bool ReadsGeometry() const;
+    
 protected:
     vtkMRMLMeasurementShape();
     ~vtkMRMLMeasurementShape() override;
@@ -39,6 +70,20 @@ protected:
     void ComputeToroid();
     void ComputeConicSpiral();
     void ComputeTransformScaledShape();
+    
+    // SetValue(), or keep the value while deferring.
+    void SetShapeValue(double value, const char * quantityCode);
+    // From the deferred input if any, else from the node.
+    vtkPoints * GetControlPointsWorld(vtkMRMLMarkupsShapeNode * shapeNode) const;
+    vtkPolyData * GetGeometryWorld(vtkMRMLMarkupsShapeNode * shapeNode) const;
+    // Surface area and volume of the generated 'mesh'; false without one.
+    static bool ComputeMassProperties(vtkPolyData * mesh, double& area, double& volume);
+    bool DeferValue = false;
+    const Input * DeferredInput = nullptr;
+    bool HasPendingValue = false;
+    double PendingValue = 0.0;
+    std::string PendingQuantityCode;
+    vtkTimeStamp ComputeTime;
 };
 
 #endif // VTKMRMLMEASUREMENTSHAPE_H
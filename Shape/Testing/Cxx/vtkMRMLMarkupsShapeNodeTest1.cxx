@@ -0,0 +1,153 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+// Shape includes
+#include "vtkMRMLMarkupsShapeNode.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkVector.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// A straight spline along x, from 0 to 100, one point per millimetre.
+void CreateSpline(vtkPolyData * spline)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(101);
+  for (int i = 0; i <= 100; i++)
+  {
+    lines->InsertCellPoint(points->InsertNextPoint(static_cast<double>(i), 0.0, 0.0));
+  }
+  spline->SetPoints(points);
+  spline->SetLines(lines);
+}
+
+//----------------------------------------------------------------------------
+// Four pairs, off the spline and not orthogonal to it.
+void AddControlPointPairs(vtkMRMLMarkupsShapeNode * shapeNode)
+{
+  shapeNode->AddControlPoint(vtkVector3d(10.0, 5.0, 1.0));
+  shapeNode->AddControlPoint(vtkVector3d(12.0, -5.0, 1.0));
+  shapeNode->AddControlPoint(vtkVector3d(30.0, 0.0, 3.0));
+  shapeNode->AddControlPoint(vtkVector3d(30.0, 1.0, -3.0));
+  shapeNode->AddControlPoint(vtkVector3d(50.0, 2.0, 2.0));
+  shapeNode->AddControlPoint(vtkVector3d(52.0, -2.0, -2.0));
+  shapeNode->AddControlPoint(vtkVector3d(70.0, 4.0, 0.0));
+  shapeNode->AddControlPoint(vtkVector3d(70.0, -4.0, 0.0));
+}
+
+//----------------------------------------------------------------------------
+// Each pair is centred on the closest spline point, orthogonal to the spline, and keeps its length.
+int TestSnapAllControlPoints()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsShapeNode> shapeNode;
+  scene->AddNode(shapeNode);
+  shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Tube);
+  AddControlPointPairs(shapeNode);
+  // The spline the representation would have generated; it is not regenerated while snapping.
+  vtkNew<vtkPolyData> spline;
+  CreateSpline(spline);
+  shapeNode->SetSplineWorld(spline);
+
+  double lengths[4] = { 0.0 };
+  double p1[3] = { 0.0 };
+  double p2[3] = { 0.0 };
+  for (int i = 0; i < 4; i++)
+  {
+    shapeNode->GetNthControlPointPositionWorld(2 * i, p1);
+    shapeNode->GetNthControlPointPositionWorld(2 * i + 1, p2);
+    lengths[i] = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+  }
+
+  CHECK_BOOL(shapeNode->SnapAllControlPointsToTubeSurface(), true);
+
+  const double centers[4] = { 11.0, 30.0, 51.0, 70.0 };
+  for (int i = 0; i < 4; i++)
+  {
+    shapeNode->GetNthControlPointPositionWorld(2 * i, p1);
+    shapeNode->GetNthControlPointPositionWorld(2 * i + 1, p2);
+    CHECK_DOUBLE_TOLERANCE((p1[0] + p2[0]) / 2.0, centers[i], 1e-6);
+    CHECK_DOUBLE_TOLERANCE((p1[1] + p2[1]) / 2.0, 0.0, 1e-6);
+    CHECK_DOUBLE_TOLERANCE((p1[2] + p2[2]) / 2.0, 0.0, 1e-6);
+    CHECK_DOUBLE_TOLERANCE(p1[0] - p2[0], 0.0, 1e-6);
+    CHECK_DOUBLE_TOLERANCE(std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2)), lengths[i], 1e-6);
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// A failure leaves every control point in place.
+int TestSnapAllControlPointsFailure()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsShapeNode> shapeNode;
+  scene->AddNode(shapeNode);
+  shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Tube);
+  AddControlPointPairs(shapeNode);
+  vtkNew<vtkPoints> positions;
+  shapeNode->GetControlPointPositionsWorld(positions);
+
+  // No spline.
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(shapeNode->SnapAllControlPointsToTubeSurface(), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Locked.
+  vtkNew<vtkPolyData> spline;
+  CreateSpline(spline);
+  shapeNode->SetSplineWorld(spline);
+  shapeNode->SetLocked(true);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(shapeNode->SnapAllControlPointsToTubeSurface(), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  double expected[3] = { 0.0 };
+  double actual[3] = { 0.0 };
+  for (int i = 0; i < shapeNode->GetNumberOfControlPoints(); i++)
+  {
+    positions->GetPoint(i, expected);
+    shapeNode->GetNthControlPointPositionWorld(i, actual);
+    CHECK_DOUBLE_TOLERANCE(std::sqrt(vtkMath::Distance2BetweenPoints(expected, actual)), 0.0, 1e-9);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsShapeNodeTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestSnapAllControlPoints());
+  CHECK_EXIT_SUCCESS(TestSnapAllControlPointsFailure());
+  return EXIT_SUCCESS;
+}
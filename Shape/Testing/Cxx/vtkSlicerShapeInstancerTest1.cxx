@@ -0,0 +1,167 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+// Shape includes
+#include "vtkMRMLMarkupsShapeNode.h"
+#include "vtkSlicerShapeInstancer.h"
+#include "vtkSlicerShapeLogic.h"
+#include "vtkSlicerShapeWidget.h"
+
+// Markups includes
+#include <vtkMRMLMarkupsDisplayNode.h>
+#include <vtkSlicerMarkupsLogic.h>
+
+// MRML includes
+#include <vtkMRMLApplicationLogic.h>
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkVector.h>
+#include <vtkWindowToImageFilter.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkMRMLMarkupsShapeNode * AddSphere(vtkMRMLScene * scene, const vtkVector3d& center, double radius,
+                                    const double color[3])
+{
+  vtkNew<vtkMRMLMarkupsShapeNode> shapeNode;
+  scene->AddNode(shapeNode);
+  shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Sphere);
+  shapeNode->SetRadiusMode(vtkMRMLMarkupsShapeNode::Centered);
+  shapeNode->AddControlPoint(center);
+  shapeNode->AddControlPoint(vtkVector3d(center[0] + radius, center[1], center[2]));
+  shapeNode->CreateDefaultDisplayNodes();
+  vtkMRMLMarkupsDisplayNode * displayNode = vtkMRMLMarkupsDisplayNode::SafeDownCast(shapeNode->GetDisplayNode());
+  displayNode->SetColor(color[0], color[1], color[2]);
+  displayNode->SetSelectedColor(color[0], color[1], color[2]);
+  displayNode->SetFillOpacity(1.0);
+  return shapeNode;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkSlicerShapeWidget> CreateWidget(vtkMRMLMarkupsShapeNode * shapeNode,
+                                                   vtkMRMLViewNode * viewNode, vtkRenderer * renderer)
+{
+  vtkSmartPointer<vtkSlicerShapeWidget> widget = vtkSmartPointer<vtkSlicerShapeWidget>::New();
+  widget->CreateDefaultRepresentation(vtkMRMLMarkupsDisplayNode::SafeDownCast(shapeNode->GetDisplayNode()),
+                                      viewNode, renderer);
+  renderer->AddViewProp(widget->GetRepresentation());
+  return widget;
+}
+
+//----------------------------------------------------------------------------
+// Colour at the centre of the rendered window.
+void GetCenterColor(vtkRenderWindow * renderWindow, double color[3])
+{
+  vtkNew<vtkWindowToImageFilter> windowToImage;
+  windowToImage->SetInput(renderWindow);
+  windowToImage->Update();
+  vtkImageData * image = windowToImage->GetOutput();
+  int dimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(dimensions);
+  for (int i = 0; i < 3; i++)
+  {
+    color[i] = image->GetScalarComponentAsDouble(dimensions[0] / 2, dimensions[1] / 2, 0, i);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Spheres are drawn by one instancer per renderer, owned by that renderer.
+int TestInstancedSpheres()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  applicationLogic->SetMRMLScene(scene);
+  vtkNew<vtkSlicerMarkupsLogic> markupsLogic;
+  markupsLogic->SetMRMLApplicationLogic(applicationLogic);
+  applicationLogic->SetModuleLogic("Markups", markupsLogic);
+  markupsLogic->SetMRMLScene(scene);
+  vtkNew<vtkSlicerShapeLogic> shapeLogic;
+  shapeLogic->SetMRMLApplicationLogic(applicationLogic);
+  applicationLogic->SetModuleLogic("Shape", shapeLogic);
+  shapeLogic->SetMRMLScene(scene);
+  shapeLogic->SetSphereInstancing(true);
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode);
+  vtkNew<vtkRenderer> renderer;
+  renderer->SetBackground(0.0, 0.0, 0.0);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->SetSize(200, 200);
+  renderWindow->AddRenderer(renderer);
+
+  const double red[3] = { 1.0, 0.0, 0.0 };
+  const double green[3] = { 0.0, 1.0, 0.0 };
+  vtkMRMLMarkupsShapeNode * centerSphere = AddSphere(scene, vtkVector3d(0.0, 0.0, 0.0), 10.0, red);
+  vtkMRMLMarkupsShapeNode * sideSphere = AddSphere(scene, vtkVector3d(50.0, 0.0, 0.0), 5.0, green);
+  vtkSmartPointer<vtkSlicerShapeWidget> centerWidget = CreateWidget(centerSphere, viewNode, renderer);
+  vtkSmartPointer<vtkSlicerShapeWidget> sideWidget = CreateWidget(sideSphere, viewNode, renderer);
+
+  vtkSlicerShapeInstancer * instancer = vtkSlicerShapeInstancer::GetInstancer(renderer, false);
+  CHECK_NOT_NULL(instancer);
+  CHECK_INT(instancer->GetNumberOfInstances(), 2);
+  CHECK_STRING(instancer->GetInstanceNodeID(0), centerSphere->GetID());
+  CHECK_STRING(instancer->GetInstanceNodeID(1), sideSphere->GetID());
+
+  // Another view has its own instancer.
+  vtkNew<vtkRenderer> otherRenderer;
+  CHECK_NULL(vtkSlicerShapeInstancer::GetInstancer(otherRenderer, false));
+
+  // The centre sphere is drawn by the shared glyph mapper, in its colour.
+  renderer->ResetCamera();
+  renderWindow->Render();
+  double color[3] = { 0.0, 0.0, 0.0 };
+  GetCenterColor(renderWindow, color);
+  CHECK_BOOL(color[0] > 50.0, true);
+  CHECK_BOOL(color[0] > 2.0 * color[1], true);
+  CHECK_BOOL(color[0] > 2.0 * color[2], true);
+
+  // The instancer goes away with its last instance.
+  renderer->RemoveViewProp(centerWidget->GetRepresentation());
+  centerWidget = nullptr;
+  CHECK_INT(instancer->GetNumberOfInstances(), 1);
+  CHECK_STRING(instancer->GetInstanceNodeID(0), sideSphere->GetID());
+  renderWindow->Render();
+  renderer->RemoveViewProp(sideWidget->GetRepresentation());
+  sideWidget = nullptr;
+  CHECK_NULL(vtkSlicerShapeInstancer::GetInstancer(renderer, false));
+
+  shapeLogic->SetSphereInstancing(false);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerShapeInstancerTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestInstancedSpheres());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+// Shape includes
+#include "vtkMRMLMarkupsShapeNode.h"
+#include "vtkMRMLMeasurementShape.h"
+#include "vtkSlicerShapeLogic.h"
+
+// Markups includes
+#include <vtkSlicerMarkupsLogic.h>
+
+// MRML includes
+#include <vtkMRMLApplicationLogic.h>
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkVector.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkMRMLMeasurementShape * GetMeasurement(vtkMRMLMarkupsShapeNode * shapeNode, const char * name)
+{
+  return vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetMeasurement(name));
+}
+
+//----------------------------------------------------------------------------
+// A modified-only pass computes the measurements of changed nodes only.
+int TestModifiedOnlyMeasurements()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  applicationLogic->SetMRMLScene(scene);
+  vtkNew<vtkSlicerMarkupsLogic> markupsLogic;
+  markupsLogic->SetMRMLApplicationLogic(applicationLogic);
+  applicationLogic->SetModuleLogic("Markups", markupsLogic);
+  markupsLogic->SetMRMLScene(scene);
+  vtkNew<vtkSlicerShapeLogic> shapeLogic;
+  shapeLogic->SetMRMLApplicationLogic(applicationLogic);
+  applicationLogic->SetModuleLogic("Shape", shapeLogic);
+  shapeLogic->SetMRMLScene(scene);
+
+  vtkNew<vtkMRMLMarkupsShapeNode> shapeNode;
+  scene->AddNode(shapeNode);
+  shapeNode->SetShapeName(vtkMRMLMarkupsShapeNode::Sphere);
+  shapeNode->SetRadiusMode(vtkMRMLMarkupsShapeNode::Centered);
+  shapeNode->AddControlPoint(vtkVector3d(0.0, 0.0, 0.0));
+  shapeNode->AddControlPoint(vtkVector3d(10.0, 0.0, 0.0));
+  for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+  {
+    shapeNode->GetNthMeasurement(i)->SetEnabled(true);
+  }
+
+  CHECK_INT(shapeLogic->UpdateShapeMeasurements(false), 1);
+  CHECK_DOUBLE_TOLERANCE(GetMeasurement(shapeNode, "radius")->GetValue(), 10.0, 1e-6);
+  // Nothing changed since.
+  CHECK_INT(shapeLogic->UpdateShapeMeasurements(true), 0);
+
+  // A control point.
+  shapeNode->SetNthControlPointPosition(1, 20.0, 0.0, 0.0);
+  shapeLogic->UpdateShapeMeasurements(true);
+  CHECK_DOUBLE_TOLERANCE(GetMeasurement(shapeNode, "radius")->GetValue(), 20.0, 1e-6);
+  CHECK_INT(shapeLogic->UpdateShapeMeasurements(true), 0);
+
+  // A shape parameter.
+  shapeNode->SetRadiusMode(vtkMRMLMarkupsShapeNode::Circumferential);
+  shapeLogic->UpdateShapeMeasurements(true);
+  CHECK_DOUBLE_TOLERANCE(GetMeasurement(shapeNode, "radius")->GetValue(), 10.0, 1e-6);
+  CHECK_INT(shapeLogic->UpdateShapeMeasurements(true), 0);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerShapeLogicTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestModifiedOnlyMeasurements());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerAdaptiveSplineSampler.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkLine.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerAdaptiveSplineSampler);
+
+//------------------------------------------------------------------------------
+vtkSlicerAdaptiveSplineSampler::vtkSlicerAdaptiveSplineSampler()
+{
+  this->SetRadiusArrayName("TubeRadius");
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerAdaptiveSplineSampler::~vtkSlicerAdaptiveSplineSampler()
+{
+  this->SetRadiusArrayName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerAdaptiveSplineSampler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "RadiusArrayName: "
+     << (this->RadiusArrayName ? this->RadiusArrayName : "(none)") << "\n";
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerAdaptiveSplineSampler::RequestData(vtkInformation* vtkNotUsed(request),
+                                                vtkInformationVector** inputVector,
+                                                vtkInformationVector* outputVector)
+{
+  vtkPolyData * input = vtkPolyData::GetData(inputVector[0]);
+  vtkPolyData * output = vtkPolyData::GetData(outputVector);
+  if (!input || !output)
+  {
+    vtkErrorMacro("Invalid input or output.");
+    return 0;
+  }
+  vtkPoints * inputPoints = input->GetPoints();
+  const vtkIdType numberOfPoints = inputPoints ? inputPoints->GetNumberOfPoints() : 0;
+  if (this->Tolerance <= 0.0 || numberOfPoints < 3)
+  {
+    output->ShallowCopy(input);
+    return 1;
+  }
+  vtkPointData * inputPointData = input->GetPointData();
+  vtkDataArray * radii = this->RadiusArrayName
+                          ? inputPointData->GetArray(this->RadiusArrayName)
+                          : nullptr;
+
+  /*
+   * Douglas-Peucker on the ordered points of the polyline. A span is split
+   * at its worst point as long as that point is farther than the tolerance
+   * from the chord, or its radius differs from the radius linearly
+   * interpolated along the chord by more than the tolerance. Bends and
+   * radius changes get dense samples, straight uniform segments get few.
+   */
+  const double tolerance2 = this->Tolerance * this->Tolerance;
+  std::vector<bool> keep(numberOfPoints, false);
+  keep.front() = true;
+  keep.back() = true;
+  std::vector<std::pair<vtkIdType, vtkIdType>> spans;
+  spans.emplace_back(0, numberOfPoints - 1);
+  double first[3] = { 0.0 };
+  double last[3] = { 0.0 };
+  double point[3] = { 0.0 };
+  double closestPoint[3] = { 0.0 };
+  while (!spans.empty())
+  {
+    const std::pair<vtkIdType, vtkIdType> span = spans.back();
+    spans.pop_back();
+    if (span.second - span.first < 2)
+    {
+      continue;
+    }
+    inputPoints->GetPoint(span.first, first);
+    inputPoints->GetPoint(span.second, last);
+    const double firstRadius = radii ? radii->GetComponent(span.first, 0) : 0.0;
+    const double lastRadius = radii ? radii->GetComponent(span.second, 0) : 0.0;
+
+    double maximumError2 = 0.0;
+    vtkIdType worstId = -1;
+    for (vtkIdType id = span.first + 1; id < span.second; id++)
+    {
+      inputPoints->GetPoint(id, point);
+      double t = 0.0;
+      double error2 = vtkLine::DistanceToLine(point, first, last, t, closestPoint);
+      if (radii)
+      {
+        t = std::min(std::max(t, 0.0), 1.0);
+        const double radiusError = radii->GetComponent(id, 0)
+                                  - (firstRadius + t * (lastRadius - firstRadius));
+        error2 = std::max(error2, radiusError * radiusError);
+      }
+      if (error2 > maximumError2)
+      {
+        maximumError2 = error2;
+        worstId = id;
+      }
+    }
+    if (worstId >= 0 && maximumError2 > tolerance2)
+    {
+      keep[worstId] = true;
+      spans.emplace_back(span.first, worstId);
+      spans.emplace_back(worstId, span.second);
+    }
+  }
+
+  const vtkIdType numberOfKeptPoints = std::count(keep.begin(), keep.end(), true);
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(inputPoints->GetDataType());
+  outputPoints->Allocate(numberOfKeptPoints);
+  vtkPointData * outputPointData = output->GetPointData();
+  outputPointData->CopyAllocate(inputPointData, numberOfKeptPoints);
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(numberOfKeptPoints);
+  for (vtkIdType id = 0; id < numberOfPoints; id++)
+  {
+    if (!keep[id])
+    {
+      continue;
+    }
+    const vtkIdType outputId = outputPoints->InsertNextPoint(inputPoints->GetPoint(id));
+    outputPointData->CopyData(inputPointData, id, outputId);
+    lines->InsertCellPoint(outputId);
+  }
+  output->SetPoints(outputPoints);
+  output->SetLines(lines);
+  vtkDebugMacro("Kept " << numberOfKeptPoints << " of " << numberOfPoints << " spline points.");
+
+  return 1;
+}
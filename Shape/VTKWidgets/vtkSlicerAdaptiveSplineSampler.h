@@ -0,0 +1,75 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtksliceradaptivesplinesampler_h_
+#define __vtksliceradaptivesplinesampler_h_
+
+#include "vtkSlicerShapeModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+
+/**
+ * @class   vtkSlicerAdaptiveSplineSampler
+ * @brief   Remove polyline points that are not needed within a tolerance
+ *
+ * The input is a densely and uniformly sampled polyline, e.g. the output of
+ * vtkParametricFunctionSource on a vtkParametricSpline. Points are kept
+ * where the line bends or where the radius array changes faster than the
+ * tolerance allows, and dropped along straight segments of constant radius.
+ * All point data arrays are carried over, so they stay aligned with the
+ * output points.
+ *
+ * A zero tolerance passes the input through unchanged.
+*/
+class VTK_SLICER_SHAPE_MODULE_VTKWIDGETS_EXPORT vtkSlicerAdaptiveSplineSampler
+: public vtkPolyDataAlgorithm
+{
+public:
+  static vtkSlicerAdaptiveSplineSampler* New();
+  vtkTypeMacro(vtkSlicerAdaptiveSplineSampler, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  // Maximum distance in mm between the input and the output polylines.
+  // It also bounds the error on the interpolated radius.
+  vtkSetClampMacro(Tolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Tolerance, double);
+
+  // Point array holding the radius. If not found, only the distance is checked.
+  vtkSetStringMacro(RadiusArrayName);
+  vtkGetStringMacro(RadiusArrayName);
+
+protected:
+  vtkSlicerAdaptiveSplineSampler();
+  ~vtkSlicerAdaptiveSplineSampler() override;
+
+  int RequestData(vtkInformation* request,
+                  vtkInformationVector** inputVector,
+                  vtkInformationVector* outputVector) override;
+
+  double Tolerance = 0.0;
+  char * RadiusArrayName = nullptr;
+
+private:
+  vtkSlicerAdaptiveSplineSampler(const vtkSlicerAdaptiveSplineSampler&) = delete;
+  void operator=(const vtkSlicerAdaptiveSplineSampler&) = delete;
+};
+
+#endif // __vtksliceradaptivesplinesampler_h_
@@ -0,0 +1,277 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerAdaptiveTubeFilter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerAdaptiveTubeFilter);
+
+//------------------------------------------------------------------------------
+void vtkSlicerAdaptiveTubeFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ChordError: " << this->ChordError << "\n";
+  os << indent << "MinimumNumberOfSides: " << this->MinimumNumberOfSides << "\n";
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerAdaptiveTubeFilter::GetNumberOfSidesForRadius(double radius) const
+{
+  const int maximumNumberOfSides = std::max(this->NumberOfSides, this->MinimumNumberOfSides);
+  if (this->ChordError <= 0.0)
+  {
+    return maximumNumberOfSides;
+  }
+  if (radius <= this->ChordError)
+  {
+    return this->MinimumNumberOfSides;
+  }
+  // The sagitta of a side spanning an angle 2a is r * (1 - cos(a)).
+  const double halfAngle = std::acos(1.0 - this->ChordError / radius);
+  const int numberOfSides = static_cast<int>(std::ceil(vtkMath::Pi() / halfAngle));
+  return std::min(std::max(numberOfSides, this->MinimumNumberOfSides), maximumNumberOfSides);
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerAdaptiveTubeFilter::RequestData(vtkInformation* request,
+                                             vtkInformationVector** inputVector,
+                                             vtkInformationVector* outputVector)
+{
+  vtkPolyData * input = vtkPolyData::GetData(inputVector[0]);
+  vtkPolyData * output = vtkPolyData::GetData(outputVector);
+  if (!input || !output)
+  {
+    vtkErrorMacro("Invalid input or output.");
+    return 0;
+  }
+  vtkPointData * inputPointData = input->GetPointData();
+  vtkDataArray * radii = inputPointData->GetScalars();
+  if (this->ChordError <= 0.0 || this->VaryRadius != VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR
+    || !radii || !input->GetPoints() || !input->GetLines())
+  {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+
+  vtkPoints * inputPoints = input->GetPoints();
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(VTK_DOUBLE);
+  vtkNew<vtkDoubleArray> normals;
+  normals->SetName("TubeNormals");
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkCellArray> polys;
+  vtkPointData * outputPointData = output->GetPointData();
+  outputPointData->CopyNormalsOff();
+  outputPointData->CopyAllocate(inputPointData);
+
+  // Adds a point with its normal, and the point data of the input point it comes from.
+  auto insertPoint = [&](const double* point, const double* normal, vtkIdType inputId) -> vtkIdType
+  {
+    const vtkIdType outputId = outputPoints->InsertNextPoint(point);
+    normals->InsertNextTuple(normal);
+    outputPointData->CopyData(inputPointData, inputId, outputId);
+    return outputId;
+  };
+
+  vtkIdType numberOfLinePoints = 0;
+  const vtkIdType * linePointIds = nullptr;
+  std::vector<vtkIdType> ids;
+  std::vector<vtkIdType> ringStarts;
+  std::vector<int> ringSides;
+  for (input->GetLines()->InitTraversal(); input->GetLines()->GetNextCell(numberOfLinePoints, linePointIds);)
+  {
+    // Skip coincident consecutive points, they have no tangent.
+    ids.clear();
+    for (vtkIdType i = 0; i < numberOfLinePoints; i++)
+    {
+      if (!ids.empty())
+      {
+        double previous[3] = { 0.0 };
+        double current[3] = { 0.0 };
+        inputPoints->GetPoint(ids.back(), previous);
+        inputPoints->GetPoint(linePointIds[i], current);
+        if (vtkMath::Distance2BetweenPoints(previous, current) <= VTK_DBL_EPSILON)
+        {
+          continue;
+        }
+      }
+      ids.push_back(linePointIds[i]);
+    }
+    const vtkIdType numberOfRings = static_cast<vtkIdType>(ids.size());
+    if (numberOfRings < 2)
+    {
+      continue;
+    }
+
+    ringStarts.assign(numberOfRings, 0);
+    ringSides.assign(numberOfRings, 0);
+    double normal[3] = { 0.0 };
+    double firstTangent[3] = { 0.0 };
+    double lastTangent[3] = { 0.0 };
+    for (vtkIdType ring = 0; ring < numberOfRings; ring++)
+    {
+      double center[3] = { 0.0 };
+      double before[3] = { 0.0 };
+      double after[3] = { 0.0 };
+      double tangent[3] = { 0.0 };
+      inputPoints->GetPoint(ids[ring], center);
+      inputPoints->GetPoint(ids[std::max<vtkIdType>(ring - 1, 0)], before);
+      inputPoints->GetPoint(ids[std::min<vtkIdType>(ring + 1, numberOfRings - 1)], after);
+      vtkMath::Subtract(after, before, tangent);
+      vtkMath::Normalize(tangent);
+
+      // Parallel transport of the normal keeps the rings from twisting.
+      double binormal[3] = { 0.0 };
+      if (ring == 0)
+      {
+        vtkMath::Perpendiculars(tangent, normal, binormal, 0.0);
+        std::copy(tangent, tangent + 3, firstTangent);
+      }
+      else
+      {
+        double projected[3] = { tangent[0], tangent[1], tangent[2] };
+        vtkMath::MultiplyScalar(projected, vtkMath::Dot(normal, tangent));
+        vtkMath::Subtract(normal, projected, normal);
+        if (vtkMath::Normalize(normal) <= VTK_DBL_EPSILON)
+        {
+          vtkMath::Perpendiculars(tangent, normal, binormal, 0.0);
+        }
+      }
+      vtkMath::Cross(tangent, normal, binormal);
+      std::copy(tangent, tangent + 3, lastTangent);
+
+      const double radius = std::max(std::abs(radii->GetComponent(ids[ring], 0)), VTK_DBL_EPSILON);
+      const int numberOfSides = this->GetNumberOfSidesForRadius(radius);
+      ringSides[ring] = numberOfSides;
+      ringStarts[ring] = outputPoints->GetNumberOfPoints();
+      for (int side = 0; side < numberOfSides; side++)
+      {
+        const double angle = 2.0 * vtkMath::Pi() * side / numberOfSides;
+        double direction[3] = { 0.0 };
+        double point[3] = { 0.0 };
+        for (int c = 0; c < 3; c++)
+        {
+          direction[c] = std::cos(angle) * normal[c] + std::sin(angle) * binormal[c];
+          point[c] = center[c] + radius * direction[c];
+        }
+        insertPoint(point, direction, ids[ring]);
+      }
+    }
+
+    /*
+     * Stitch each pair of rings. Both rings start at the same angle, so
+     * walking them together by angle fraction and advancing the one whose
+     * next vertex comes first gives a band of outward facing triangles,
+     * whatever their side counts.
+     */
+    for (vtkIdType ring = 0; ring < numberOfRings - 1; ring++)
+    {
+      const vtkIdType startA = ringStarts[ring];
+      const vtkIdType startB = ringStarts[ring + 1];
+      const int sidesA = ringSides[ring];
+      const int sidesB = ringSides[ring + 1];
+      int a = 0;
+      int b = 0;
+      while (a < sidesA || b < sidesB)
+      {
+        const bool advanceA = (b == sidesB)
+          || (a < sidesA && (a + 1) * static_cast<double>(sidesB) <= (b + 1) * static_cast<double>(sidesA));
+        vtkIdType triangle[3] = { 0 };
+        if (advanceA)
+        {
+          triangle[0] = startA + (a % sidesA);
+          triangle[1] = startA + ((a + 1) % sidesA);
+          triangle[2] = startB + (b % sidesB);
+          a++;
+        }
+        else
+        {
+          triangle[0] = startA + (a % sidesA);
+          triangle[1] = startB + ((b + 1) % sidesB);
+          triangle[2] = startB + (b % sidesB);
+          b++;
+        }
+        polys->InsertNextCell(3, triangle);
+      }
+    }
+
+    if (this->Capping)
+    {
+      // Caps get their own points so that they are shaded flat.
+      for (int end = 0; end < 2; end++)
+      {
+        const vtkIdType ring = (end == 0) ? 0 : numberOfRings - 1;
+        double capNormal[3] = { lastTangent[0], lastTangent[1], lastTangent[2] };
+        if (end == 0)
+        {
+          capNormal[0] = -firstTangent[0];
+          capNormal[1] = -firstTangent[1];
+          capNormal[2] = -firstTangent[2];
+        }
+        double center[3] = { 0.0 };
+        inputPoints->GetPoint(ids[ring], center);
+        const vtkIdType centerId = insertPoint(center, capNormal, ids[ring]);
+        const int numberOfSides = ringSides[ring];
+        const vtkIdType capStart = outputPoints->GetNumberOfPoints();
+        for (int side = 0; side < numberOfSides; side++)
+        {
+          double point[3] = { 0.0 };
+          outputPoints->GetPoint(ringStarts[ring] + side, point);
+          insertPoint(point, capNormal, ids[ring]);
+        }
+        for (int side = 0; side < numberOfSides; side++)
+        {
+          const vtkIdType current = capStart + side;
+          const vtkIdType next = capStart + (side + 1) % numberOfSides;
+          vtkIdType triangle[3] = { centerId, next, current };
+          if (end != 0)
+          {
+            std::swap(triangle[1], triangle[2]);
+          }
+          polys->InsertNextCell(3, triangle);
+        }
+      }
+    }
+  }
+
+  output->SetPoints(outputPoints);
+  output->SetPolys(polys);
+  outputPointData->SetNormals(normals);
+  output->Squeeze();
+
+  return 1;
+}
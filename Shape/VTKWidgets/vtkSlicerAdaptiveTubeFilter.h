@@ -0,0 +1,77 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtksliceradaptivetubefilter_h_
+#define __vtksliceradaptivetubefilter_h_
+
+#include "vtkSlicerShapeModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkTubeFilter.h>
+
+/**
+ * @class   vtkSlicerAdaptiveTubeFilter
+ * @brief   Tube filter whose number of sides follows the local radius
+ *
+ * With a positive ChordError, each ring gets the least number of sides
+ * keeping the distance between a facet and the true circle below
+ * ChordError, clamped to [MinimumNumberOfSides, NumberOfSides]. Adjacent
+ * rings with different side counts are stitched with triangles. A thin
+ * distal segment then gets far fewer facets than a wide sac.
+ *
+ * Only VaryRadiusByAbsoluteScalar is handled adaptively. With a zero
+ * ChordError, or any other radius mode, vtkTubeFilter is used as is.
+*/
+class VTK_SLICER_SHAPE_MODULE_VTKWIDGETS_EXPORT vtkSlicerAdaptiveTubeFilter
+: public vtkTubeFilter
+{
+public:
+  static vtkSlicerAdaptiveTubeFilter* New();
+  vtkTypeMacro(vtkSlicerAdaptiveTubeFilter, vtkTubeFilter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  // Maximum distance in mm between a facet and the circle it approximates.
+  vtkSetClampMacro(ChordError, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(ChordError, double);
+
+  // Lower bound of the number of sides of a ring. NumberOfSides is the upper bound.
+  vtkSetClampMacro(MinimumNumberOfSides, int, 3, VTK_INT_MAX);
+  vtkGetMacro(MinimumNumberOfSides, int);
+
+  // Number of sides needed for a radius.
+  int GetNumberOfSidesForRadius(double radius) const;
+
+protected:
+  vtkSlicerAdaptiveTubeFilter() = default;
+  ~vtkSlicerAdaptiveTubeFilter() override = default;
+
+  int RequestData(vtkInformation* request,
+                  vtkInformationVector** inputVector,
+                  vtkInformationVector* outputVector) override;
+
+  double ChordError = 0.0;
+  int MinimumNumberOfSides = 6;
+
+private:
+  vtkSlicerAdaptiveTubeFilter(const vtkSlicerAdaptiveTubeFilter&) = delete;
+  void operator=(const vtkSlicerAdaptiveTubeFilter&) = delete;
+};
+
+#endif // __vtksliceradaptivetubefilter_h_
@@ -0,0 +1,197 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerCylinderSource.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerCylinderSource);
+
+//------------------------------------------------------------------------------
+vtkSlicerCylinderSource::vtkSlicerCylinderSource()
+{
+  this->SetNumberOfInputPorts(0);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerCylinderSource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Resolution: " << this->Resolution << "\n";
+  os << indent << "Capping: " << this->Capping << "\n";
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerCylinderSource::RequestData(vtkInformation* vtkNotUsed(request),
+                                         vtkInformationVector** vtkNotUsed(inputVector),
+                                         vtkInformationVector* outputVector)
+{
+  vtkPolyData * output = vtkPolyData::GetData(outputVector);
+  if (!output)
+  {
+    vtkErrorMacro("Invalid output.");
+    return 0;
+  }
+  const int resolution = this->Resolution;
+  const vtkIdType numberOfPoints = 2 * resolution + (this->Capping ? 2 * (resolution + 1) : 0);
+
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numberOfPoints);
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(numberOfPoints);
+  vtkNew<vtkCellArray> polys;
+
+  // Side rings : 0 at x = 0, 1 at x = 1. Normals are radial.
+  for (int ring = 0; ring < 2; ring++)
+  {
+    for (int side = 0; side < resolution; side++)
+    {
+      const double angle = 2.0 * vtkMath::Pi() * side / resolution;
+      const double y = std::cos(angle);
+      const double z = std::sin(angle);
+      const vtkIdType id = ring * resolution + side;
+      points->SetPoint(id, static_cast<double>(ring), y, z);
+      normals->SetTuple3(id, 0.0, y, z);
+    }
+  }
+  for (int side = 0; side < resolution; side++)
+  {
+    const vtkIdType next = (side + 1) % resolution;
+    const vtkIdType quad[4] = { side, next, resolution + next, resolution + side };
+    polys->InsertNextCell(4, quad);
+  }
+
+  if (this->Capping)
+  {
+    // Each cap is a centre and a copy of its ring, with an axial normal.
+    for (int cap = 0; cap < 2; cap++)
+    {
+      const double axialNormal = (cap == 0) ? -1.0 : 1.0;
+      const vtkIdType centerId = 2 * resolution + cap * (resolution + 1);
+      points->SetPoint(centerId, static_cast<double>(cap), 0.0, 0.0);
+      normals->SetTuple3(centerId, axialNormal, 0.0, 0.0);
+      for (int side = 0; side < resolution; side++)
+      {
+        double point[3] = { 0.0 };
+        points->GetPoint(cap * resolution + side, point);
+        points->SetPoint(centerId + 1 + side, point);
+        normals->SetTuple3(centerId + 1 + side, axialNormal, 0.0, 0.0);
+      }
+      for (int side = 0; side < resolution; side++)
+      {
+        const vtkIdType current = centerId + 1 + side;
+        const vtkIdType next = centerId + 1 + (side + 1) % resolution;
+        // Wind the start cap the other way round so that both face outwards.
+        const vtkIdType triangle[3] = { centerId, (cap == 0) ? next : current, (cap == 0) ? current : next };
+        polys->InsertNextCell(3, triangle);
+      }
+    }
+  }
+
+  output->SetPoints(points);
+  output->SetPolys(polys);
+  output->GetPointData()->SetNormals(normals);
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerCylinderSource::GetPlaneIntersection(const double p1[3], const double p2[3], double radius,
+                                                   const double origin[3], const double normal[3],
+                                                   int resolution, vtkPolyData * ellipse)
+{
+  if (!ellipse || radius <= 0.0 || resolution < 3)
+  {
+    return false;
+  }
+  double axis[3] = { 0.0 };
+  vtkMath::Subtract(p2, p1, axis);
+  const double height = vtkMath::Normalize(axis);
+  double unitNormal[3] = { normal[0], normal[1], normal[2] };
+  if (height == 0.0 || vtkMath::Normalize(unitNormal) == 0.0)
+  {
+    return false;
+  }
+  const double cosine = vtkMath::Dot(unitNormal, axis);
+  if (std::abs(cosine) < 1e-6)
+  {
+    return false;
+  }
+  double u[3] = { 0.0 };
+  double v[3] = { 0.0 };
+  vtkMath::Perpendiculars(axis, u, v, 0.0);
+
+  /*
+   * Each generator line p1 + r * (cos(a) * u + sin(a) * v) + t * axis
+   * meets the plane at a single t. If every t lies within the height,
+   * the plane only crosses the lateral surface and the section is an ellipse.
+   */
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(resolution);
+  for (int i = 0; i < resolution; i++)
+  {
+    const double angle = 2.0 * vtkMath::Pi() * i / resolution;
+    double point[3] = { 0.0 };
+    for (int c = 0; c < 3; c++)
+    {
+      point[c] = p1[c] + radius * (std::cos(angle) * u[c] + std::sin(angle) * v[c]);
+    }
+    double toOrigin[3] = { 0.0 };
+    vtkMath::Subtract(origin, point, toOrigin);
+    const double t = vtkMath::Dot(unitNormal, toOrigin) / cosine;
+    if (t < 0.0 || t > height)
+    {
+      return false;
+    }
+    for (int c = 0; c < 3; c++)
+    {
+      point[c] += t * axis[c];
+    }
+    points->SetPoint(i, point);
+  }
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(resolution + 1);
+  for (int i = 0; i < resolution; i++)
+  {
+    lines->InsertCellPoint(i);
+  }
+  lines->InsertCellPoint(0);
+
+  ellipse->Initialize();
+  ellipse->SetPoints(points);
+  ellipse->SetLines(lines);
+  return true;
+}
@@ -0,0 +1,82 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkslicercylindersource_h_
+#define __vtkslicercylindersource_h_
+
+#include "vtkSlicerShapeModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+
+class vtkPolyData;
+
+/**
+ * @class   vtkSlicerCylinderSource
+ * @brief   Unit cylinder with shared side rings and exact normals
+ *
+ * The cylinder has a radius of 1 and runs along X from 0 to 1; it is
+ * meant to be placed with a transform. The two side rings are shared by
+ * all side quads and carry radial normals. Optional caps get their own
+ * points so that they are shaded flat. All facets face outwards.
+*/
+class VTK_SLICER_SHAPE_MODULE_VTKWIDGETS_EXPORT vtkSlicerCylinderSource
+: public vtkPolyDataAlgorithm
+{
+public:
+  static vtkSlicerCylinderSource* New();
+  vtkTypeMacro(vtkSlicerCylinderSource, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  // Number of sides.
+  vtkSetClampMacro(Resolution, int, 3, VTK_INT_MAX);
+  vtkGetMacro(Resolution, int);
+
+  vtkSetMacro(Capping, bool);
+  vtkGetMacro(Capping, bool);
+  vtkBooleanMacro(Capping, bool);
+
+  /*
+   * Intersection of a plane with the lateral surface of the cylinder of
+   * 'radius' from 'p1' to 'p2', as a closed polyline of 'resolution' points
+   * lying exactly on the ellipse. Returns false if the plane is parallel to
+   * the axis or crosses a cap, where the section is not an ellipse.
+   */
+  static bool GetPlaneIntersection(const double p1[3], const double p2[3], double radius,
+                                   const double origin[3], const double normal[3],
+                                   int resolution, vtkPolyData * ellipse);
+
+protected:
+  vtkSlicerCylinderSource();
+  ~vtkSlicerCylinderSource() override = default;
+
+  int RequestData(vtkInformation* request,
+                  vtkInformationVector** inputVector,
+                  vtkInformationVector* outputVector) override;
+
+  int Resolution = 20;
+  bool Capping = true;
+
+private:
+  vtkSlicerCylinderSource(const vtkSlicerCylinderSource&) = delete;
+  void operator=(const vtkSlicerCylinderSource&) = delete;
+};
+
+#endif // __vtkslicercylindersource_h_
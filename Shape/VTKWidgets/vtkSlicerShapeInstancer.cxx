@@ -0,0 +1,267 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerShapeInstancer.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRenderer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerShapeInstancer);
+vtkInformationKeyMacro(vtkSlicerShapeInstancer, INSTANCER, ObjectBase);
+
+bool vtkSlicerShapeInstancer::Enabled = false;
+
+//------------------------------------------------------------------------------
+vtkSlicerShapeInstancer::vtkSlicerShapeInstancer()
+{
+  this->SphereSource = vtkSmartPointer<vtkSphereSource>::New();
+  this->SphereSource->SetRadius(1.0);
+  this->InstanceData = vtkSmartPointer<vtkPolyData>::New();
+  
+  this->Mapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+  this->Mapper->SetSourceConnection(this->SphereSource->GetOutputPort());
+  this->Mapper->SetInputData(this->InstanceData);
+  this->Mapper->ScalingOn();
+  this->Mapper->SetScaleModeToScaleByMagnitude();
+  this->Mapper->SetScaleArray("Radius");
+  this->Mapper->OrientOff();
+  this->Mapper->SetSelectionIdArray("InstanceIds");
+  this->Mapper->ScalarVisibilityOn();
+  this->Mapper->SetScalarModeToUsePointFieldData();
+  this->Mapper->SelectColorArray("Colors");
+  this->Mapper->SetColorModeToDirectScalars();
+  
+  this->Actor = vtkSmartPointer<vtkActor>::New();
+  this->Actor->SetMapper(this->Mapper);
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerShapeInstancer::~vtkSlicerShapeInstancer() = default;
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeInstancer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkSlicerShapeInstancer::Enabled << "\n";
+  os << indent << "Number of instances: " << this->Instances.size() << "\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeInstancer::SetEnabled(bool enabled)
+{
+  vtkSlicerShapeInstancer::Enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerShapeInstancer::GetEnabled()
+{
+  return vtkSlicerShapeInstancer::Enabled;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerShapeInstancer * vtkSlicerShapeInstancer::GetInstancer(vtkRenderer * renderer, bool create)
+{
+  vtkInformation * information = renderer ? renderer->GetInformation() : nullptr;
+  if (!information)
+  {
+    return nullptr;
+  }
+  vtkSlicerShapeInstancer * instancer = vtkSlicerShapeInstancer::SafeDownCast(
+    information->Get(vtkSlicerShapeInstancer::INSTANCER()));
+  if (instancer || !create)
+  {
+    return instancer;
+  }
+  vtkNew<vtkSlicerShapeInstancer> newInstancer;
+  newInstancer->Renderer = renderer;
+  information->Set(vtkSlicerShapeInstancer::INSTANCER(), newInstancer);
+  return newInstancer;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeInstancer::SetInstance(vtkObject * owner, const char * nodeID,
+                                          const double center[3], double radius,
+                                          const double color[3], double opacity, int resolution)
+{
+  if (!owner)
+  {
+    return;
+  }
+  auto found = this->InstanceIndices.find(owner);
+  if (found == this->InstanceIndices.end())
+  {
+    this->InstanceIndices[owner] = this->Instances.size();
+    this->Instances.emplace_back();
+    found = this->InstanceIndices.find(owner);
+  }
+  Instance& instance = this->Instances[found->second];
+  instance.Owner = owner;
+  instance.NodeID = nodeID ? nodeID : "";
+  for (int i = 0; i < 3; i++)
+  {
+    instance.Center[i] = center[i];
+    instance.Color[i] = static_cast<unsigned char>(std::round(std::min(std::max(color[i], 0.0), 1.0) * 255.0));
+  }
+  instance.Color[3] = static_cast<unsigned char>(std::round(std::min(std::max(opacity, 0.0), 1.0) * 255.0));
+  instance.Radius = radius;
+  instance.Resolution = resolution;
+  this->InstancesModified = true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeInstancer::RemoveInstance(vtkObject * owner)
+{
+  auto found = this->InstanceIndices.find(owner);
+  if (found == this->InstanceIndices.end())
+  {
+    return;
+  }
+  // Move the last instance into the freed slot.
+  const size_t index = found->second;
+  this->InstanceIndices.erase(found);
+  if (index != this->Instances.size() - 1)
+  {
+    this->Instances[index] = this->Instances.back();
+    this->InstanceIndices[this->Instances[index].Owner] = index;
+  }
+  this->Instances.pop_back();
+  this->InstancesModified = true;
+  
+  if (this->Instances.empty())
+  {
+    // The caller may hold this pointer; it is only valid until this returns.
+    vtkSmartPointer<vtkSlicerShapeInstancer> keepAlive = this;
+    this->Renderer->GetInformation()->Remove(vtkSlicerShapeInstancer::INSTANCER());
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerShapeInstancer::HasInstance(vtkObject * owner) const
+{
+  return this->InstanceIndices.find(owner) != this->InstanceIndices.end();
+}
+
+//------------------------------------------------------------------------------
+const char * vtkSlicerShapeInstancer::GetInstanceNodeID(vtkIdType instanceId) const
+{
+  if (instanceId < 0 || instanceId >= static_cast<vtkIdType>(this->Instances.size()))
+  {
+    return nullptr;
+  }
+  return this->Instances[instanceId].NodeID.c_str();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerShapeInstancer::IsRenderingOwner(vtkObject * owner) const
+{
+  return !this->Instances.empty() && this->Instances.front().Owner == owner;
+}
+
+//------------------------------------------------------------------------------
+vtkActor * vtkSlicerShapeInstancer::GetActor()
+{
+  return this->Actor;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeInstancer::UpdateInstances()
+{
+  if (!this->InstancesModified)
+  {
+    return;
+  }
+  const vtkIdType numberOfInstances = static_cast<vtkIdType>(this->Instances.size());
+  vtkNew<vtkPoints> centers;
+  centers->SetNumberOfPoints(numberOfInstances);
+  vtkNew<vtkDoubleArray> radii;
+  radii->SetName("Radius");
+  radii->SetNumberOfTuples(numberOfInstances);
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetName("Colors");
+  colors->SetNumberOfComponents(4);
+  colors->SetNumberOfTuples(numberOfInstances);
+  vtkNew<vtkIdTypeArray> instanceIds;
+  instanceIds->SetName("InstanceIds");
+  instanceIds->SetNumberOfTuples(numberOfInstances);
+  int resolution = 3;
+  for (vtkIdType i = 0; i < numberOfInstances; i++)
+  {
+    const Instance& instance = this->Instances[i];
+    centers->SetPoint(i, instance.Center);
+    radii->SetValue(i, instance.Radius);
+    colors->SetTypedTuple(i, instance.Color);
+    instanceIds->SetValue(i, i);
+    resolution = std::max(resolution, instance.Resolution);
+  }
+  this->InstanceData->Initialize();
+  this->InstanceData->SetPoints(centers);
+  this->InstanceData->GetPointData()->AddArray(radii);
+  this->InstanceData->GetPointData()->AddArray(colors);
+  this->InstanceData->GetPointData()->AddArray(instanceIds);
+  // A single unit sphere is shared, at the finest resolution requested.
+  this->SphereSource->SetPhiResolution(resolution);
+  this->SphereSource->SetThetaResolution(resolution);
+  this->InstancesModified = false;
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerShapeInstancer::RenderOpaqueGeometry(vtkViewport * viewport)
+{
+  this->UpdateInstances();
+  return this->Actor->RenderOpaqueGeometry(viewport);
+}
+
+//------------------------------------------------------------------------------
+int vtkSlicerShapeInstancer::RenderTranslucentPolygonalGeometry(vtkViewport * viewport)
+{
+  this->UpdateInstances();
+  return this->Actor->RenderTranslucentPolygonalGeometry(viewport);
+}
+
+//------------------------------------------------------------------------------
+vtkTypeBool vtkSlicerShapeInstancer::HasTranslucentPolygonalGeometry()
+{
+  this->UpdateInstances();
+  return this->Actor->HasTranslucentPolygonalGeometry();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeInstancer::ReleaseGraphicsResources(vtkWindow * window)
+{
+  this->Actor->ReleaseGraphicsResources(window);
+}
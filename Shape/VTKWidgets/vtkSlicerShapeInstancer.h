@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkslicershapeinstancer_h_
+#define __vtkslicershapeinstancer_h_
+
+#include "vtkSlicerShapeModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkActor;
+class vtkGlyph3DMapper;
+class vtkInformationObjectBaseKey;
+class vtkPolyData;
+class vtkRenderer;
+class vtkSphereSource;
+class vtkViewport;
+class vtkWindow;
+
+/**
+ * @class   vtkSlicerShapeInstancer
+ * @brief   Draws all Sphere shapes of a renderer with a single glyph mapper
+ *
+ * Representations register their sphere as an instance with a centre,
+ * a radius and a colour, and hide their own actor. The instances of a
+ * renderer are drawn by one vtkGlyph3DMapper, in one actor that the
+ * first registered representation renders. Control points remain drawn
+ * and picked by each representation. The instancer is kept in the
+ * information of its renderer, so it lives and dies with that view.
+ *
+ * Instancing is global and off by default; see vtkSlicerShapeLogic.
+*/
+class VTK_SLICER_SHAPE_MODULE_VTKWIDGETS_EXPORT vtkSlicerShapeInstancer
+: public vtkObject
+{
+public:
+  static vtkSlicerShapeInstancer* New();
+  vtkTypeMacro(vtkSlicerShapeInstancer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+
+  // The instancer shared by all representations of a renderer; created on request.
+  static vtkSlicerShapeInstancer * GetInstancer(vtkRenderer * renderer, bool create = true);
+
+  // Add or update the instance of 'owner'.
+  void SetInstance(vtkObject * owner, const char * nodeID,
+                   const double center[3], double radius,
+                   const double color[3], double opacity, int resolution);
+  // Forget the instance of 'owner', if any. The instancer may be deleted.
+  void RemoveInstance(vtkObject * owner);
+  bool HasInstance(vtkObject * owner) const;
+  int GetNumberOfInstances() const { return static_cast<int>(this->Instances.size()); }
+
+  // Node of an instance, e.g. from the selection id array of a hardware selection.
+  const char * GetInstanceNodeID(vtkIdType instanceId) const;
+
+  // Only the first registered representation renders the shared actor.
+  bool IsRenderingOwner(vtkObject * owner) const;
+  vtkActor * GetActor();
+
+  int RenderOpaqueGeometry(vtkViewport * viewport);
+  int RenderTranslucentPolygonalGeometry(vtkViewport * viewport);
+  vtkTypeBool HasTranslucentPolygonalGeometry();
+  void ReleaseGraphicsResources(vtkWindow * window);
+
+protected:
+  vtkSlicerShapeInstancer();
+  ~vtkSlicerShapeInstancer() override;
+
+  // Rebuild the instance arrays if an instance changed.
+  void UpdateInstances();
+
+  struct Instance
+  {
+    vtkObject * Owner = nullptr;
+    std::string NodeID;
+    double Center[3] = { 0.0, 0.0, 0.0 };
+    double Radius = 0.0;
+    unsigned char Color[4] = { 0, 0, 0, 255 };
+    int Resolution = 8;
+  };
+  std::vector<Instance> Instances;
+  std::map<vtkObject*, size_t> InstanceIndices;
+  bool InstancesModified = false;
+
+  vtkSmartPointer<vtkSphereSource> SphereSource;
+  vtkSmartPointer<vtkPolyData> InstanceData;
+  vtkSmartPointer<vtkGlyph3DMapper> Mapper;
+  vtkSmartPointer<vtkActor> Actor;
+
+  // Holds this instancer in its information.
+  vtkRenderer * Renderer = nullptr;
+
+private:
+  // Key of the instancer in the information of its renderer.
+  static vtkInformationObjectBaseKey * INSTANCER();
+  static bool Enabled;
+
+  vtkSlicerShapeInstancer(const vtkSlicerShapeInstancer&) = delete;
+  void operator=(const vtkSlicerShapeInstancer&) = delete;
+};
+
+#endif // __vtkslicershapeinstancer_h_
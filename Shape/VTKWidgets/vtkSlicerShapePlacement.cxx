@@ -0,0 +1,95 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "vtkSlicerShapePlacement.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkTransform.h>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerShapePlacement);
+
+//------------------------------------------------------------------------------
+bool vtkSlicerShapePlacement::Place(vtkTransform * transform, const double center[3],
+                                    const double unitAxis[3], const double axis[3],
+                                    const double scale[3])
+{
+  if (!transform || scale[0] <= 0.0 || scale[1] <= 0.0 || scale[2] <= 0.0)
+  {
+    return false;
+  }
+  double direction[3] = { axis[0], axis[1], axis[2] };
+  if (vtkMath::Normalize(direction) == 0.0)
+  {
+    return false;
+  }
+  double reference[3] = { unitAxis[0], unitAxis[1], unitAxis[2] };
+  vtkMath::Normalize(reference);
+
+  double rotationAxis[3] = { 0.0 };
+  vtkMath::Cross(reference, direction, rotationAxis);
+  const double angle = vtkMath::DegreesFromRadians(vtkMath::AngleBetweenVectors(reference, direction));
+  if (vtkMath::Norm(rotationAxis) == 0.0 && vtkMath::Dot(reference, direction) < 0.0)
+  {
+    // Opposite directions : any perpendicular axis will do.
+    double unused[3] = { 0.0 };
+    vtkMath::Perpendiculars(reference, rotationAxis, unused, 0.0);
+  }
+
+  transform->Identity();
+  transform->PostMultiply();
+  transform->Scale(scale);
+  if (vtkMath::Norm(rotationAxis) != 0.0)
+  {
+    transform->RotateWXYZ(angle, rotationAxis);
+  }
+  transform->Translate(center);
+  transform->PreMultiply();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerShapePlacement::GetClosestPointOnCircle(const double center[3], const double normal[3],
+                                                      double radius, const double point[3],
+                                                      double closestPoint[3])
+{
+  double unitNormal[3] = { normal[0], normal[1], normal[2] };
+  if (vtkMath::Normalize(unitNormal) == 0.0)
+  {
+    return false;
+  }
+  // Project on the plane of the circle.
+  double radial[3] = { 0.0 };
+  vtkMath::Subtract(point, center, radial);
+  double axial[3] = { unitNormal[0], unitNormal[1], unitNormal[2] };
+  vtkMath::MultiplyScalar(axial, vtkMath::Dot(radial, unitNormal));
+  vtkMath::Subtract(radial, axial, radial);
+  if (vtkMath::Normalize(radial) == 0.0)
+  {
+    return false;
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    closestPoint[i] = center[i] + radius * radial[i];
+  }
+  return true;
+}
@@ -0,0 +1,73 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkslicershapeplacement_h_
+#define __vtkslicershapeplacement_h_
+
+#include "vtkSlicerShapeModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkTransform;
+
+/**
+ * @class   vtkSlicerShapePlacement
+ * @brief   Helpers to place unit primitives in world space
+ *
+ * Sphere, cone, cylinder, disk and ring are generated once per resolution
+ * at the origin, in unit size. Moving a control point then only updates
+ * the placement transform instead of re-executing the source.
+*/
+class VTK_SLICER_SHAPE_MODULE_VTKWIDGETS_EXPORT vtkSlicerShapePlacement
+: public vtkObject
+{
+public:
+  static vtkSlicerShapePlacement* New();
+  vtkTypeMacro(vtkSlicerShapePlacement, vtkObject);
+
+  /*
+   * Set 'transform' so that a primitive built at the origin along 'unitAxis'
+   * is scaled by 'scale', rotated to 'axis' and moved to 'center'.
+   * Returns false if 'axis' is a zero vector or a scale factor is not positive,
+   * as the shape would be degenerate.
+   */
+  static bool Place(vtkTransform * transform, const double center[3],
+                    const double unitAxis[3], const double axis[3],
+                    const double scale[3]);
+
+  /*
+   * Closest point to 'point' on the circle of 'radius' around 'center',
+   * in the plane of 'normal'. Returns false if 'point' is on the axis.
+   */
+  static bool GetClosestPointOnCircle(const double center[3], const double normal[3],
+                                      double radius, const double point[3],
+                                      double closestPoint[3]);
+
+protected:
+  vtkSlicerShapePlacement() = default;
+  ~vtkSlicerShapePlacement() override = default;
+
+private:
+  vtkSlicerShapePlacement(const vtkSlicerShapePlacement&) = delete;
+  void operator=(const vtkSlicerShapePlacement&) = delete;
+};
+
+#endif // __vtkslicershapeplacement_h_
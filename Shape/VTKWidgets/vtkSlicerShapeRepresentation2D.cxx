@@ -20,6 +20,8 @@
 
 #include "vtkSlicerShapeRepresentation2D.h"
 #include "vtkMRMLMarkupsShapeNode.h"
+#include "vtkMRMLMarkupsProfiler.h"
+#include "vtkSlicerShapePlacement.h"
 
 #include <vtkActor2D.h>
 #include <vtkGlyphSource2D.h>
@@ -30,6 +32,11 @@
 #include <vtkTupleInterpolator.h>
 #include <vtkPointData.h>
 #include <vtkMatrix4x4.h>
+#include <vtkPolyData.h>
+#include <vtkDataObject.h>
+
+// STD includes
+#include <algorithm>
 
 // TODO: Fix opacity of shape and intersection actors in Projection mode.
 //------------------------------------------------------------------------------
@@ -59,11 +66,10 @@ vtkSlicerShapeRepresentation2D::vtkSlicerShapeRepresentation2D()
   this->MiddlePointActor = vtkSmartPointer<vtkActor2D>::New();
   this->MiddlePointActor->SetMapper(this->MiddlePointDataMapper);
   
-  this->DiskSource = vtkSmartPointer<vtkDiskSource>::New();
-  this->RingSource = vtkSmartPointer<vtkDiskSource>::New();
-  this->SphereSource = vtkSmartPointer<vtkSphereSource>::New();
-  this->ConeSource = vtkSmartPointer<vtkConeSource>::New();
-  this->ConeSource->CappingOn();
+  // Shape specific sources are built on demand in BuildShapePipeline().
+  this->PrimitiveTransform = vtkSmartPointer<vtkTransform>::New();
+  this->PrimitiveTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  this->PrimitiveTransformer->SetTransform(this->PrimitiveTransform);
   
   this->RadiusSource = vtkSmartPointer<vtkLineSource>::New();
   this->RadiusMapper = vtkSmartPointer<vtkPolyDataMapper2D>::New();
@@ -80,37 +86,12 @@ vtkSlicerShapeRepresentation2D::vtkSlicerShapeRepresentation2D()
   this->ShapeActor->SetMapper(this->ShapeMapper);
   this->ShapeActor->SetProperty(this->ShapeProperty);
   
-  this->Spline = vtkSmartPointer<vtkParametricSpline>::New();
-  vtkNew<vtkPoints> points;
-  const double point[3] = { 0.0 };
-  points->InsertNextPoint(point);
-  this->Spline->SetPoints(points);
-  this->SplineFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
-  this->SplineFunctionSource->SetParametricFunction(this->Spline);
-  this->Tube = vtkSmartPointer<vtkTubeFilter>::New();
-  this->Tube->SetNumberOfSides(20);
-  this->Tube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
-  this->Tube->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
-  // To be consistent with 3D views. The cap is projected or intersected in slice views.
-  this->CappedTube = vtkSmartPointer<vtkTubeFilter>::New();
-  this->CappedTube->SetNumberOfSides(20);
-  this->CappedTube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
-  this->CappedTube->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
-  this->CappedTube->SetCapping(true);
-
   this->SplineMapper = vtkSmartPointer<vtkPolyDataMapper2D>::New();
   this->SplineActor = vtkSmartPointer<vtkActor2D>::New();
   this->SplineActor->SetMapper(this->SplineMapper);
   this->SplineActor->SetProperty(this->ShapeProperty);
 
-  this->CylinderAxis = vtkSmartPointer<vtkLineSource>::New();
-  this->CylinderSource = vtkSmartPointer<vtkTubeFilter>::New();
-  this->CylinderSource->SetNumberOfSides(20);
-  this->CylinderSource->SetInputConnection(this->CylinderAxis->GetOutputPort());
-  this->CylinderSource->SetCapping(true);
-  
-  this->ArcSource = vtkSmartPointer<vtkArcSource>::New();
-  this->ArcSource->UseNormalAndAngleOn();
+  this->CylinderCutWorld = vtkSmartPointer<vtkPolyData>::New();
   
   this->WorldPlane = vtkSmartPointer<vtkPlane>::New();
   this->WorldCutter = vtkSmartPointer<vtkCutter>::New();
@@ -125,19 +106,6 @@ vtkSlicerShapeRepresentation2D::vtkSlicerShapeRepresentation2D()
   this->SplineWorldCutActor = vtkSmartPointer<vtkActor2D>::New();
   this->SplineWorldCutActor->SetMapper(this->SplineWorldCutMapper);
   
-  this->Ellipsoid = vtkSmartPointer<vtkParametricSuperEllipsoid>::New();
-  this->Toroid = vtkSmartPointer<vtkParametricSuperToroid>::New();
-  this->BohemianDome = vtkSmartPointer<vtkParametricBohemianDome>::New();
-  this->Bour = vtkSmartPointer<vtkParametricBour>::New();
-  this->Boy = vtkSmartPointer<vtkParametricBoy>::New();
-  this->CrossCap = vtkSmartPointer<vtkParametricCrossCap>::New();
-  this->ConicSpiral = vtkSmartPointer<vtkParametricConicSpiral>::New();
-  this->Kuen = vtkSmartPointer<vtkParametricKuen>::New();
-  this->Mobius = vtkSmartPointer<vtkParametricMobius>::New();
-  this->PluckerConoid = vtkSmartPointer<vtkParametricPluckerConoid>::New();
-  this->Roman = vtkSmartPointer<vtkParametricRoman>::New();
-  this->ParametricFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
-  
   this->ParametricMiddlePointSource = vtkSmartPointer<vtkGlyphSource2D>::New();
   this->ParametricMiddlePointSource->SetCenter(0.0, 0.0, 0.0);
   this->ParametricMiddlePointSource->SetScale(5);
@@ -157,10 +125,203 @@ vtkSlicerShapeRepresentation2D::~vtkSlicerShapeRepresentation2D() = default;
 void vtkSlicerShapeRepresentation2D::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "Pipeline shape: " << this->PipelineShapeName << "\n";
+  os << indent << "Pipeline memory size: " << this->GetPipelineMemorySize() << " KiB\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation2D::BuildShapePipeline(vtkMRMLMarkupsShapeNode * shapeNode)
+{
+  const int shapeName = shapeNode->GetShapeName();
+  if (shapeNode->IsParametric())
+  {
+    this->ParametricFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
+  }
+  // Unit primitives : along Z for disk, ring and sphere, along X for cone and cylinder.
+  switch (shapeName)
+  {
+    case vtkMRMLMarkupsShapeNode::Sphere :
+      this->SphereSource = vtkSmartPointer<vtkSphereSource>::New();
+      this->SphereSource->SetRadius(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Ring :
+      this->RingSource = vtkSmartPointer<vtkDiskSource>::New();
+      this->RingSource->SetOuterRadius(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Disk :
+      this->DiskSource = vtkSmartPointer<vtkDiskSource>::New();
+      this->DiskSource->SetOuterRadius(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Tube :
+    {
+      this->Spline = vtkSmartPointer<vtkParametricSpline>::New();
+      vtkNew<vtkPoints> points;
+      const double point[3] = { 0.0 };
+      points->InsertNextPoint(point);
+      this->Spline->SetPoints(points);
+      this->SplineFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
+      this->SplineFunctionSource->SetParametricFunction(this->Spline);
+      // Drops spline points that straight and constant radius segments don't need.
+      this->SplineSampler = vtkSmartPointer<vtkSlicerAdaptiveSplineSampler>::New();
+      this->SplineSampler->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
+      this->Tube = vtkSmartPointer<vtkSlicerAdaptiveTubeFilter>::New();
+      this->Tube->SetNumberOfSides(20);
+      this->Tube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
+      this->Tube->SetInputConnection(this->SplineSampler->GetOutputPort());
+      // To be consistent with 3D views. The cap is projected or intersected in slice views.
+      this->CappedTube = vtkSmartPointer<vtkSlicerAdaptiveTubeFilter>::New();
+      this->CappedTube->SetNumberOfSides(20);
+      this->CappedTube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
+      this->CappedTube->SetInputConnection(this->SplineSampler->GetOutputPort());
+      this->CappedTube->SetCapping(true);
+      // These feed the slice pipeline with geometry read from a sidecar file; see UpdateTubeFromMRML().
+      this->CachedTubeProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+      this->CachedSplineProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+      break;
+    }
+    case vtkMRMLMarkupsShapeNode::Cone :
+      this->ConeSource = vtkSmartPointer<vtkConeSource>::New();
+      this->ConeSource->CappingOn();
+      this->ConeSource->SetRadius(1.0);
+      this->ConeSource->SetHeight(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Cylinder :
+      this->CylinderSource = vtkSmartPointer<vtkSlicerCylinderSource>::New();
+      this->CylinderSource->SetResolution(20);
+      this->CylinderSource->SetCapping(true);
+      break;
+    case vtkMRMLMarkupsShapeNode::Arc :
+      this->ArcSource = vtkSmartPointer<vtkArcSource>::New();
+      this->ArcSource->UseNormalAndAngleOn();
+      break;
+    case vtkMRMLMarkupsShapeNode::Ellipsoid :
+      this->Ellipsoid = vtkSmartPointer<vtkParametricSuperEllipsoid>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Ellipsoid);
+      break;
+    case vtkMRMLMarkupsShapeNode::Toroid :
+      this->Toroid = vtkSmartPointer<vtkParametricSuperToroid>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Toroid);
+      break;
+    case vtkMRMLMarkupsShapeNode::BohemianDome :
+      this->BohemianDome = vtkSmartPointer<vtkParametricBohemianDome>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->BohemianDome);
+      break;
+    case vtkMRMLMarkupsShapeNode::Bour :
+      this->Bour = vtkSmartPointer<vtkParametricBour>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Bour);
+      break;
+    case vtkMRMLMarkupsShapeNode::Boy :
+      this->Boy = vtkSmartPointer<vtkParametricBoy>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Boy);
+      break;
+    case vtkMRMLMarkupsShapeNode::CrossCap :
+      this->CrossCap = vtkSmartPointer<vtkParametricCrossCap>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->CrossCap);
+      break;
+    case vtkMRMLMarkupsShapeNode::ConicSpiral :
+      this->ConicSpiral = vtkSmartPointer<vtkParametricConicSpiral>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->ConicSpiral);
+      break;
+    case vtkMRMLMarkupsShapeNode::Kuen :
+      this->Kuen = vtkSmartPointer<vtkParametricKuen>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Kuen);
+      break;
+    case vtkMRMLMarkupsShapeNode::Mobius :
+      this->Mobius = vtkSmartPointer<vtkParametricMobius>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Mobius);
+      break;
+    case vtkMRMLMarkupsShapeNode::PluckerConoid :
+      this->PluckerConoid = vtkSmartPointer<vtkParametricPluckerConoid>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->PluckerConoid);
+      break;
+    case vtkMRMLMarkupsShapeNode::Roman :
+      this->Roman = vtkSmartPointer<vtkParametricRoman>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Roman);
+      break;
+    default:
+      break;
+  }
+  this->PipelineShapeName = shapeName;
+  vtkDebugMacro("Built pipeline for shape " << shapeNode->GetShapeNameAsString(shapeName) << ".");
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation2D::ReleaseShapePipeline()
+{
+  if (this->PipelineShapeName < 0)
+  {
+    return;
+  }
+  // Shared consumers would otherwise keep the released sources alive.
+  this->PrimitiveTransformer->RemoveAllInputConnections(0);
+  this->ParametricTransformer->RemoveAllInputConnections(0);
+  this->ShapeWorldToSliceTransformer->RemoveAllInputConnections(0);
+  this->ShapeCutWorldToSliceTransformer->RemoveAllInputConnections(0);
+  this->WorldCutter->RemoveAllInputConnections(0);
+  this->SplineWorldToSliceTransformer->RemoveAllInputConnections(0);
+  this->SplineWorldCutter->RemoveAllInputConnections(0);
+  this->CylinderCutWorld->Initialize();
+  
+  this->DiskSource = nullptr;
+  this->RingSource = nullptr;
+  this->SphereSource = nullptr;
+  this->ConeSource = nullptr;
+  this->CylinderSource = nullptr;
+  this->ArcSource = nullptr;
+  this->Spline = nullptr;
+  this->SplineFunctionSource = nullptr;
+  this->SplineSampler = nullptr;
+  this->Tube = nullptr;
+  this->CappedTube = nullptr;
+  this->CachedTubeProducer = nullptr;
+  this->CachedSplineProducer = nullptr;
+  this->Ellipsoid = nullptr;
+  this->Toroid = nullptr;
+  this->BohemianDome = nullptr;
+  this->Bour = nullptr;
+  this->Boy = nullptr;
+  this->CrossCap = nullptr;
+  this->ConicSpiral = nullptr;
+  this->Kuen = nullptr;
+  this->Mobius = nullptr;
+  this->PluckerConoid = nullptr;
+  this->Roman = nullptr;
+  this->ParametricFunctionSource = nullptr;
+  this->PipelineShapeName = -1;
+}
+
+//------------------------------------------------------------------------------
+unsigned long vtkSlicerShapeRepresentation2D::GetPipelineMemorySize()
+{
+  vtkAlgorithm * algorithms[] = {
+    this->DiskSource, this->RingSource, this->SphereSource, this->ConeSource,
+    this->CylinderSource, this->ArcSource, this->SplineFunctionSource, this->SplineSampler,
+    this->Tube, this->CappedTube, this->ParametricFunctionSource,
+    this->PrimitiveTransformer, this->ParametricTransformer,
+    this->ShapeWorldToSliceTransformer, this->ShapeCutWorldToSliceTransformer, this->WorldCutter,
+    this->SplineWorldToSliceTransformer, this->SplineCutWorldToSliceTransformer, this->SplineWorldCutter,
+    this->RadiusSource, this->MiddlePointSource, this->ParametricMiddlePointSource
+  };
+  unsigned long size = this->CylinderCutWorld->GetActualMemorySize();
+  for (vtkAlgorithm * algorithm : algorithms)
+  {
+    // Sources that are not built, or have not executed yet, hold nothing.
+    if (!algorithm || algorithm->GetNumberOfOutputPorts() < 1)
+    {
+      continue;
+    }
+    vtkDataObject * output = algorithm->GetOutputDataObject(0);
+    if (output)
+    {
+      size += output->GetActualMemorySize();
+    }
+  }
+  return size;
 }
 // -----------------------------------------------------------------------------
 void vtkSlicerShapeRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData /*=nullptr*/)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Update2D");
   // NOTE: the WorldCutter is a determinant in many functions.
   Superclass::UpdateFromMRML(caller, event, callData);
 
@@ -171,6 +332,11 @@ void vtkSlicerShapeRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigne
   {
     return;
   }
+  if (shapeNode->GetShapeName() != this->PipelineShapeName)
+  {
+    this->ReleaseShapePipeline();
+    this->BuildShapePipeline(shapeNode);
+  }
 
   this->RadiusMapper->SetScalarVisibility(shapeNode->GetScalarVisibility());
   this->ShapeMapper->SetScalarVisibility(shapeNode->GetScalarVisibility());
@@ -185,6 +351,11 @@ void vtkSlicerShapeRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigne
   this->WorldCutActor->SetVisibility(false);
   this->SplineActor->SetVisibility(false);
   this->SplineWorldCutActor->SetVisibility(false);
+  // The geometry of a hidden node is generated once shown in this view.
+  if (!this->GetVisibility())
+  {
+    return;
+  }
 
   if (!shapeNode->IsParametric())
   {
@@ -224,6 +395,13 @@ void vtkSlicerShapeRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigne
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation2D::UpdateTimed(vtkAlgorithm * algorithm, const char * phase)
+{
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), phase);
+  algorithm->Update();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerShapeRepresentation2D::SetMarkupsNode(vtkMRMLMarkupsNode *markupsNode)
 {
@@ -469,9 +647,10 @@ void vtkSlicerShapeRepresentation2D::UpdateDiskFromMRML(vtkMRMLNode* caller, uns
   double p1World[3] = { 0.0 };
   double p2World[3] = { 0.0 };
   double p3World[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
-  shapeNode->GetNthControlPointPositionWorld(2, p3World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
+  controlPointsWorld->GetPoint(2, p3World);
         
   // Calculate normal relative to p1World
   double normalWorld[3] = { 0.0 };
@@ -501,20 +680,28 @@ void vtkSlicerShapeRepresentation2D::UpdateDiskFromMRML(vtkMRMLNode* caller, uns
     farthestDisplayPoint[2] = p2[2];
   }
           
-  this->DiskSource->SetCenter(p1World);
-  this->DiskSource->SetNormal(normalWorld);
-  this->DiskSource->SetOuterRadius(outerRadius);
-  this->DiskSource->SetInnerRadius(innerRadius);
+  // Only the ratio of the radii is left to the source, the size is in the transform.
+  const double scale[3] = { outerRadius, outerRadius, outerRadius };
+  const double zAxis[3] = { 0.0, 0.0, 1.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, p1World, zAxis, normalWorld, scale))
+  {
+    this->ShapeActor->SetVisibility(false);
+    this->TextActor->SetVisibility(false);
+    this->WorldCutActor->SetVisibility(false);
+    return;
+  }
+  this->DiskSource->SetInnerRadius(innerRadius / outerRadius);
   // Show projections on demand.
   this->WorldCutActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Intersection);
   this->ShapeActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Projection);
 
   this->DiskSource->SetCircumferentialResolution((int) shapeNode->GetResolution());
-  this->DiskSource->Update();
+  this->PrimitiveTransformer->SetInputConnection(this->DiskSource->GetOutputPort());
+  this->PrimitiveTransformer->Update();
   
   // Update shape and map from world to slice.
-  this->ShapeWorldToSliceTransformer->SetInputConnection(this->DiskSource->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->ShapeWorldToSliceTransformer->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -530,11 +717,11 @@ void vtkSlicerShapeRepresentation2D::UpdateDiskFromMRML(vtkMRMLNode* caller, uns
   // Cut the invisible 3D representation.
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
-  this->WorldCutter->SetInputConnection(this->DiskSource->GetOutputPort());
-  this->WorldCutter->Update();
+  this->WorldCutter->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->WorldCutter, "Cut");
   // Transform to slice representation and show.
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -576,8 +763,7 @@ void vtkSlicerShapeRepresentation2D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   this->TextActor->SetVisibility(true);
   this->WorldCutActor->SetVisibility(true);
   
-  this->ShapeMapper->SetInputConnection(this->RingSource->GetOutputPort());
-  
+
   // Display coordinates.
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
@@ -590,9 +776,10 @@ void vtkSlicerShapeRepresentation2D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   double p1World[3] = { 0.0 };
   double p2World[3] = { 0.0 };
   double p3World[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
-  shapeNode->GetNthControlPointPositionWorld(2, p3World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
+  controlPointsWorld->GetPoint(2, p3World);
   
   // Normal relative to p1
   double normalWorld[3] = { 0.0 };
@@ -603,14 +790,12 @@ void vtkSlicerShapeRepresentation2D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   vtkMath::Cross(rp2World, rp3World, normalWorld);
   
   double lineLengthWorld = std::sqrt(vtkMath::Distance2BetweenPoints(p1World, p2World)); 
+  double radiusWorld = lineLengthWorld;
+  double centerWorld[3] = { p1World[0], p1World[1], p1World[2] };
         
   // Centered mode.
   if (shapeNode->GetRadiusMode() == vtkMRMLMarkupsShapeNode::Centered)
   {       
-    this->RingSource->SetCenter(p1World);
-    this->RingSource->SetNormal(normalWorld);
-    this->RingSource->SetOuterRadius(lineLengthWorld);
-    this->RingSource->SetInnerRadius((lineLengthWorld - this->ViewScaleFactorMmPerPixel) );
     
     this->MiddlePointSource->SetCenter(p1[0], p1[1], 0.0);
     this->MiddlePointSource->Update();
@@ -622,15 +807,10 @@ void vtkSlicerShapeRepresentation2D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   // Circumferential mode : center is half way between p1 and p2.
   else
   {
-    double radiusWorld = lineLengthWorld / 2.0;
-    double centerWorld[3] = { (p1World[0] + p2World[0]) / 2.0,
-                        (p1World[1] + p2World[1]) / 2.0,
-                        (p1World[2] + p2World[2]) / 2.0 };
-      
-    this->RingSource->SetCenter(centerWorld);
-    this->RingSource->SetNormal(normalWorld);
-    this->RingSource->SetOuterRadius(radiusWorld);
-    this->RingSource->SetInnerRadius(radiusWorld - this->ViewScaleFactorMmPerPixel);
+    radiusWorld = lineLengthWorld / 2.0;
+    centerWorld[0] = (p1World[0] + p2World[0]) / 2.0;
+    centerWorld[1] = (p1World[1] + p2World[1]) / 2.0;
+    centerWorld[2] = (p1World[2] + p2World[2]) / 2.0;
     
     double middlePointPos[2] = { (p1[0] + p2[0]) / 2.0, (p1[1] + p2[1]) / 2.0 };
     this->MiddlePointSource->SetCenter(middlePointPos[0], middlePointPos[1], 0.0);
@@ -644,12 +824,25 @@ void vtkSlicerShapeRepresentation2D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   // Show the projection. SliceViewCutActor is also visible, but will blend with the projection. 
   this->ShapeActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Projection);
   
+  const double scale[3] = { radiusWorld, radiusWorld, radiusWorld };
+  const double zAxis[3] = { 0.0, 0.0, 1.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, centerWorld, zAxis, normalWorld, scale))
+  {
+    this->MiddlePointActor->SetVisibility(false);
+    this->ShapeActor->SetVisibility(false);
+    this->RadiusActor->SetVisibility(false);
+    this->TextActor->SetVisibility(false);
+    this->WorldCutActor->SetVisibility(false);
+    return;
+  }
+  this->RingSource->SetInnerRadius((radiusWorld - this->ViewScaleFactorMmPerPixel) / radiusWorld);
   this->RingSource->SetCircumferentialResolution((int) shapeNode->GetResolution());
-  this->RingSource->Update();
+  this->PrimitiveTransformer->SetInputConnection(this->RingSource->GetOutputPort());
+  this->PrimitiveTransformer->Update();
   
   // Update shape and map from world to slice.
-  this->ShapeWorldToSliceTransformer->SetInputConnection(this->RingSource->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->ShapeWorldToSliceTransformer->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -664,10 +857,10 @@ void vtkSlicerShapeRepresentation2D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   }
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
-  this->WorldCutter->SetInputConnection(this->RingSource->GetOutputPort());
-  this->WorldCutter->Update();
+  this->WorldCutter->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->WorldCutter, "Cut");
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -708,8 +901,6 @@ void vtkSlicerShapeRepresentation2D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   this->RadiusActor->SetVisibility(true);
   this->TextActor->SetVisibility(true);
   
-  this->ShapeMapper->SetInputConnection(this->SphereSource->GetOutputPort());
-  this->WorldCutter->SetInputConnection(this->SphereSource->GetOutputPort());
   
   // Display coordinates.
   double p1[3] = { 0.0 };
@@ -720,16 +911,17 @@ void vtkSlicerShapeRepresentation2D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   // World coordinates.
   double p1World[3] = { 0.0 };
   double p2World[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
     
   double lineLengthWorld = std::sqrt(vtkMath::Distance2BetweenPoints(p1World, p2World));
+  double radiusWorld = lineLengthWorld;
+  double centerWorld[3] = { p1World[0], p1World[1], p1World[2] };
   
   // Centered mode.
   if (shapeNode->GetRadiusMode() == vtkMRMLMarkupsShapeNode::Centered)
   { 
-    this->SphereSource->SetCenter(p1World);
-    this->SphereSource->SetRadius(lineLengthWorld);
     
     this->MiddlePointSource->SetCenter(p1[0], p1[1], 0.0);
     this->MiddlePointSource->Update();
@@ -741,13 +933,10 @@ void vtkSlicerShapeRepresentation2D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   // Circumferential mode : center is half way between p1 and p2.
   else
   {
-    double radiusWorld = lineLengthWorld / 2.0;
-    double centerWorld[3] = { (p1World[0] + p2World[0]) / 2.0,
-                        (p1World[1] + p2World[1]) / 2.0,
-                        (p1World[2] + p2World[2]) / 2.0 };
-      
-    this->SphereSource->SetCenter(centerWorld);
-    this->SphereSource->SetRadius(radiusWorld);
+    radiusWorld = lineLengthWorld / 2.0;
+    centerWorld[0] = (p1World[0] + p2World[0]) / 2.0;
+    centerWorld[1] = (p1World[1] + p2World[1]) / 2.0;
+    centerWorld[2] = (p1World[2] + p2World[2]) / 2.0;
     
     double middlePointPos[2] = { (p1[0] + p2[0]) / 2.0, (p1[1] + p2[1]) / 2.0 };
     this->MiddlePointSource->SetCenter(middlePointPos[0], middlePointPos[1], 0.0);
@@ -760,13 +949,26 @@ void vtkSlicerShapeRepresentation2D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   this->RadiusActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Intersection);
   this->WorldCutActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Intersection);
   
+  const double scale[3] = { radiusWorld, radiusWorld, radiusWorld };
+  const double zAxis[3] = { 0.0, 0.0, 1.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, centerWorld, zAxis, zAxis, scale))
+  {
+    this->ShapeActor->SetVisibility(false);
+    this->MiddlePointActor->SetVisibility(false);
+    this->WorldCutActor->SetVisibility(false);
+    this->RadiusActor->SetVisibility(false);
+    this->TextActor->SetVisibility(false);
+    return;
+  }
+  // The unit sphere is only regenerated when the resolution changes.
   this->SphereSource->SetPhiResolution(shapeNode->GetResolution());
   this->SphereSource->SetThetaResolution(shapeNode->GetResolution());
-  this->SphereSource->Update();
+  this->PrimitiveTransformer->SetInputConnection(this->SphereSource->GetOutputPort());
+  this->PrimitiveTransformer->Update();
   
   // Update shape and map from world to slice.
-  this->ShapeWorldToSliceTransformer->SetInputConnection(this->SphereSource->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->ShapeWorldToSliceTransformer->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -781,10 +983,10 @@ void vtkSlicerShapeRepresentation2D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   }
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
-  this->WorldCutter->SetInputConnection(this->SphereSource->GetOutputPort());
-  this->WorldCutter->Update();
+  this->WorldCutter->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->WorldCutter, "Cut");
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -833,82 +1035,26 @@ void vtkSlicerShapeRepresentation2D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
     return;
   }
 
-  if (!shapeNode->GetDisplayCappedTube())
+  vtkAlgorithmOutput * tubePort = nullptr;
+  vtkAlgorithmOutput * splinePort = nullptr;
+  if (shapeNode->ValidateCachedGeometry())
   {
-    this->ShapeMapper->SetInputConnection(this->Tube->GetOutputPort());
-    this->WorldCutter->SetInputConnection(this->Tube->GetOutputPort());
+    // Geometry read from the storage node's sidecar file still matches the control points.
+    this->CachedTubeProducer->SetOutput(shapeNode->GetDisplayCappedTube()
+      ? shapeNode->GetCachedCappedTubeWorld() : shapeNode->GetCachedTubeWorld());
+    this->CachedSplineProducer->SetOutput(shapeNode->GetCachedSplineWorld());
+    tubePort = this->CachedTubeProducer->GetOutputPort();
+    splinePort = this->CachedSplineProducer->GetOutputPort();
   }
   else
   {
-    this->ShapeMapper->SetInputConnection(this->CappedTube->GetOutputPort());
-    this->WorldCutter->SetInputConnection(this->CappedTube->GetOutputPort());
-  }
-  
-  // This is not the number of pairs.
-  int numberOfPairedControlPoints = (shapeNode->GetNumberOfControlPoints() % 2)
-                            ? shapeNode->GetNumberOfControlPoints() - 1
-                            : shapeNode->GetNumberOfControlPoints();
-  
-  vtkNew<vtkPoints> splinePoints;
-  vtkNew<vtkTupleInterpolator> interpolatedRadius;
-  interpolatedRadius->SetInterpolationTypeToLinear();
-  interpolatedRadius->SetNumberOfComponents(1);
-  int interpolatorIndex = 0;
-  for (int i = 0; i < numberOfPairedControlPoints; i = i + 2)
-  {
-    double middlePoint[3] = { 0.0 };
-    double p1[3] = { 0.0 };
-    double p2[3] = { 0.0 };
-    shapeNode->GetNthControlPointPositionWorld(i, p1);
-    shapeNode->GetNthControlPointPositionWorld(i + 1, p2);
-    middlePoint[0] = (p1[0] + p2[0]) / 2.0;
-    middlePoint[1] = (p1[1] + p2[1]) / 2.0;
-    middlePoint[2] = (p1[2] + p2[2]) / 2.0;
-    splinePoints->InsertNextPoint(middlePoint);
-    
-    double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2)) / 2.0;
-    interpolatedRadius->AddTuple(interpolatorIndex, &radius);
-    //interpolatedRadius->AddTuple(i + 1, &radius);
-    interpolatorIndex++;
+    this->GenerateTube(shapeNode);
+    tubePort = shapeNode->GetDisplayCappedTube()
+      ? this->CappedTube->GetOutputPort() : this->Tube->GetOutputPort();
+    splinePort = this->SplineSampler->GetOutputPort();
   }
-  int numberOfIntervals = (numberOfPairedControlPoints / 2) - (int) shapeNode->GetSplineNewInterpolationInterval();
-
-  const int splineResolution = shapeNode->GetSplineResolution();
-  this->Spline->SetPoints(splinePoints);
-  this->SplineFunctionSource->SetUResolution(splineResolution * numberOfIntervals);
-  this->SplineFunctionSource->SetVResolution(splineResolution * numberOfIntervals);
-  this->SplineFunctionSource->SetWResolution(splineResolution * numberOfIntervals);
-  this->SplineFunctionSource->Update();
-  vtkPolyData * splinePolyData = this->SplineFunctionSource->GetOutput();
-  int numberOfPoints = splinePolyData->GetNumberOfPoints();
+  this->WorldCutter->SetInputConnection(tubePort);
   
-  // https://kitware.github.io/vtk-examples/site/Cxx/VisualizationAlgorithms/TubesFromSplines/
-  vtkSmartPointer<vtkDoubleArray> tubeRadius = vtkSmartPointer<vtkDoubleArray>::New();
-  tubeRadius->SetNumberOfTuples(numberOfPoints);
-  tubeRadius->SetName("TubeRadius");
-  double tMin = interpolatedRadius->GetMinimumT();
-  double tMax = interpolatedRadius->GetMaximumT();
-  double r;
-  for (unsigned int i = 0; i < numberOfPoints; ++i)
-  {
-    double t = (tMax - tMin) / (numberOfPoints - 1) * i + tMin;
-    interpolatedRadius->InterpolateTuple(t, &r);
-    tubeRadius->SetTuple1(i, r);
-  }
-  
-  splinePolyData->GetPointData()->AddArray(tubeRadius);
-  splinePolyData->GetPointData()->SetActiveScalars("TubeRadius");
-  
-  if (!shapeNode->GetDisplayCappedTube())
-  {
-    this->Tube->SetNumberOfSides(shapeNode->GetResolution());
-    this->Tube->Update();
-  }
-  else
-  {
-    this->CappedTube->SetNumberOfSides(shapeNode->GetResolution());
-    this->CappedTube->Update();
-  }
   
   this->ShapeActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Projection);
   this->WorldCutActor->SetVisibility(shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Intersection);
@@ -918,20 +1064,13 @@ void vtkSlicerShapeRepresentation2D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
                             && shapeNode->GetDrawMode2D() == vtkMRMLMarkupsShapeNode::Intersection);
   
   // Update shape and map from world to slice.
-  if (!shapeNode->GetDisplayCappedTube())
-  {
-    this->ShapeWorldToSliceTransformer->SetInputConnection(this->Tube->GetOutputPort());
-  }
-  else
-  {
-    this->ShapeWorldToSliceTransformer->SetInputConnection(this->CappedTube->GetOutputPort());
-  }
-  this->ShapeWorldToSliceTransformer->Update();
+  this->ShapeWorldToSliceTransformer->SetInputConnection(tubePort);
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
 
-  this->SplineWorldToSliceTransformer->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
-  this->SplineWorldToSliceTransformer->Update();
+  this->SplineWorldToSliceTransformer->SetInputConnection(splinePort);
+  this->UpdateTimed(this->SplineWorldToSliceTransformer, "SplineWorldToSlice");
   this->SplineMapper->SetInputConnection(this->SplineWorldToSliceTransformer->GetOutputPort());
   this->SplineMapper->Update();
 
@@ -946,16 +1085,16 @@ void vtkSlicerShapeRepresentation2D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
   }
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
-  this->WorldCutter->Update();
+  this->UpdateTimed(this->WorldCutter, "Cut");
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
 
-  this->SplineWorldCutter->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
-  this->SplineWorldCutter->Update();
+  this->SplineWorldCutter->SetInputConnection(splinePort);
+  this->UpdateTimed(this->SplineWorldCutter, "SplineCut");
   this->SplineCutWorldToSliceTransformer->SetInputConnection(this->SplineWorldCutter->GetOutputPort());
-  this->SplineCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->SplineCutWorldToSliceTransformer, "SplineCutWorldToSlice");
   this->SplineWorldCutMapper->SetInputConnection(this->SplineCutWorldToSliceTransformer->GetOutputPort());
   this->SplineWorldCutMapper->Update();
   
@@ -992,6 +1131,83 @@ void vtkSlicerShapeRepresentation2D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
   this->SplineWorldCutActor->SetProperty(this->ShapeProperty);
 }
 
+//-----------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation2D::GenerateTube(vtkMRMLMarkupsShapeNode * shapeNode)
+{
+  // This is not the number of pairs.
+  int numberOfPairedControlPoints = (shapeNode->GetNumberOfControlPoints() % 2)
+                            ? shapeNode->GetNumberOfControlPoints() - 1
+                            : shapeNode->GetNumberOfControlPoints();
+  
+  vtkNew<vtkPoints> splinePoints;
+  vtkNew<vtkTupleInterpolator> interpolatedRadius;
+  interpolatedRadius->SetInterpolationTypeToLinear();
+  interpolatedRadius->SetNumberOfComponents(1);
+  int interpolatorIndex = 0;
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  for (int i = 0; i < numberOfPairedControlPoints; i = i + 2)
+  {
+    double middlePoint[3] = { 0.0 };
+    double p1[3] = { 0.0 };
+    double p2[3] = { 0.0 };
+    controlPointsWorld->GetPoint(i, p1);
+    controlPointsWorld->GetPoint(i + 1, p2);
+    middlePoint[0] = (p1[0] + p2[0]) / 2.0;
+    middlePoint[1] = (p1[1] + p2[1]) / 2.0;
+    middlePoint[2] = (p1[2] + p2[2]) / 2.0;
+    splinePoints->InsertNextPoint(middlePoint);
+    
+    double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2)) / 2.0;
+    interpolatedRadius->AddTuple(interpolatorIndex, &radius);
+    //interpolatedRadius->AddTuple(i + 1, &radius);
+    interpolatorIndex++;
+  }
+  int numberOfIntervals = (numberOfPairedControlPoints / 2) - (int) shapeNode->GetSplineNewInterpolationInterval();
+
+  const int splineResolution = shapeNode->GetSplineResolution();
+  this->Spline->SetPoints(splinePoints);
+  this->SplineFunctionSource->SetUResolution(splineResolution * numberOfIntervals);
+  this->SplineFunctionSource->SetVResolution(splineResolution * numberOfIntervals);
+  this->SplineFunctionSource->SetWResolution(splineResolution * numberOfIntervals);
+  this->UpdateTimed(this->SplineFunctionSource, "Spline");
+  vtkPolyData * splinePolyData = this->SplineFunctionSource->GetOutput();
+  int numberOfPoints = splinePolyData->GetNumberOfPoints();
+  
+  // https://kitware.github.io/vtk-examples/site/Cxx/VisualizationAlgorithms/TubesFromSplines/
+  vtkSmartPointer<vtkDoubleArray> tubeRadius = vtkSmartPointer<vtkDoubleArray>::New();
+  tubeRadius->SetNumberOfTuples(numberOfPoints);
+  tubeRadius->SetName("TubeRadius");
+  double tMin = interpolatedRadius->GetMinimumT();
+  double tMax = interpolatedRadius->GetMaximumT();
+  double r;
+  for (unsigned int i = 0; i < numberOfPoints; ++i)
+  {
+    double t = (tMax - tMin) / (numberOfPoints - 1) * i + tMin;
+    interpolatedRadius->InterpolateTuple(t, &r);
+    tubeRadius->SetTuple1(i, r);
+  }
+  
+  splinePolyData->GetPointData()->AddArray(tubeRadius);
+  splinePolyData->GetPointData()->SetActiveScalars("TubeRadius");
+  // The radius array was added after the source executed; resample explicitly.
+  this->SplineSampler->SetTolerance(shapeNode->GetSplineTolerance());
+  this->SplineSampler->Modified();
+  this->UpdateTimed(this->SplineSampler, "SplineSampling");
+  
+  if (!shapeNode->GetDisplayCappedTube())
+  {
+    this->Tube->SetNumberOfSides(shapeNode->GetResolution());
+    this->Tube->SetChordError(shapeNode->GetTubeChordError());
+    this->UpdateTimed(this->Tube, "Tube");
+  }
+  else
+  {
+    this->CappedTube->SetNumberOfSides(shapeNode->GetResolution());
+    this->CappedTube->SetChordError(shapeNode->GetTubeChordError());
+    this->UpdateTimed(this->CappedTube, "CappedTube");
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerShapeRepresentation2D::UpdateConeFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData)
 {
@@ -1005,16 +1221,15 @@ void vtkSlicerShapeRepresentation2D::UpdateConeFromMRML(vtkMRMLNode* caller, uns
   this->TextActor->SetVisibility(true);
   this->WorldCutActor->SetVisibility(true);
   
-  this->ShapeMapper->SetInputConnection(this->ConeSource->GetOutputPort());
   
   double p1World[3] = { 0.0 };
   double p2World[3] = { 0.0 };
   double p3World[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
-  shapeNode->GetNthControlPointPositionWorld(2, p3World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
+  controlPointsWorld->GetPoint(2, p3World);
   
-  this->ShapeMapper->SetInputConnection(this->ConeSource->GetOutputPort());
   
   double height = std::sqrt(vtkMath::Distance2BetweenPoints(p1World, p3World));
   double directionWorld[3] = { 0.0 };
@@ -1028,16 +1243,22 @@ void vtkSlicerShapeRepresentation2D::UpdateConeFromMRML(vtkMRMLNode* caller, uns
   
   double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1World, p2World));
   
-  this->ConeSource->SetCenter(centerWorld);
-  this->ConeSource->SetRadius(radius);
-  this->ConeSource->SetHeight(height);
-  this->ConeSource->SetDirection(directionWorld);
+  const double scale[3] = { height, radius, radius };
+  const double xAxis[3] = { 1.0, 0.0, 0.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, centerWorld, xAxis, directionWorld, scale))
+  {
+    this->ShapeActor->SetVisibility(false);
+    this->TextActor->SetVisibility(false);
+    this->WorldCutActor->SetVisibility(false);
+    return;
+  }
   this->ConeSource->SetResolution(shapeNode->GetResolution());
-  this->ConeSource->Update();
+  this->PrimitiveTransformer->SetInputConnection(this->ConeSource->GetOutputPort());
+  this->PrimitiveTransformer->Update();
   
   // Update shape and map from world to slice.
-  this->ShapeWorldToSliceTransformer->SetInputConnection(this->ConeSource->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->ShapeWorldToSliceTransformer->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -1052,10 +1273,10 @@ void vtkSlicerShapeRepresentation2D::UpdateConeFromMRML(vtkMRMLNode* caller, uns
   }
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
-  this->WorldCutter->SetInputConnection(this->ConeSource->GetOutputPort());
-  this->WorldCutter->Update();
+  this->WorldCutter->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->WorldCutter, "Cut");
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -1096,27 +1317,34 @@ void vtkSlicerShapeRepresentation2D::UpdateCylinderFromMRML(vtkMRMLNode* caller,
   this->TextActor->SetVisibility(true);
   this->WorldCutActor->SetVisibility(true);
   
-  this->ShapeMapper->SetInputConnection(this->CylinderSource->GetOutputPort());
-  
   double p1World[3] = { 0.0 };
   double p2World[3] = { 0.0 };
   double p3World[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
-  shapeNode->GetNthControlPointPositionWorld(2, p3World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
+  controlPointsWorld->GetPoint(2, p3World);
   
-  this->CylinderAxis->SetPoint1(p1World);
-  this->CylinderAxis->SetPoint2(p3World);
-  this->CylinderAxis->Update();
   double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1World, p2World));
-  
-  this->CylinderSource->SetRadius(radius);
-  this->CylinderSource->SetNumberOfSides(shapeNode->GetResolution());
-  this->CylinderSource->Update();
+  double height = std::sqrt(vtkMath::Distance2BetweenPoints(p1World, p3World));
+  double directionWorld[3] = { 0.0 };
+  vtkMath::Subtract(p3World, p1World, directionWorld);
+  const double scale[3] = { height, radius, radius };
+  const double xAxis[3] = { 1.0, 0.0, 0.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, p1World, xAxis, directionWorld, scale))
+  {
+    this->ShapeActor->SetVisibility(false);
+    this->TextActor->SetVisibility(false);
+    this->WorldCutActor->SetVisibility(false);
+    return;
+  }
+  this->CylinderSource->SetResolution(shapeNode->GetResolution());
+  this->PrimitiveTransformer->SetInputConnection(this->CylinderSource->GetOutputPort());
+  this->PrimitiveTransformer->Update();
   
   // Update shape and map from world to slice.
-  this->ShapeWorldToSliceTransformer->SetInputConnection(this->CylinderSource->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->ShapeWorldToSliceTransformer->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -1131,10 +1359,23 @@ void vtkSlicerShapeRepresentation2D::UpdateCylinderFromMRML(vtkMRMLNode* caller,
   }
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
-  this->WorldCutter->SetInputConnection(this->CylinderSource->GetOutputPort());
-  this->WorldCutter->Update();
-  this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  /*
+   * A slice crossing the lateral surface only cuts an exact ellipse; use it
+   * rather than the faceted mesh. The caps need the mesh cut.
+   */
+  const int ellipseResolution = std::max(4 * shapeNode->GetResolution(), 64);
+  if (vtkSlicerCylinderSource::GetPlaneIntersection(p1World, p3World, radius, origin, normal,
+                                                     ellipseResolution, this->CylinderCutWorld))
+  {
+    this->ShapeCutWorldToSliceTransformer->SetInputData(this->CylinderCutWorld);
+  }
+  else
+  {
+    this->WorldCutter->SetInputConnection(this->PrimitiveTransformer->GetOutputPort());
+    this->UpdateTimed(this->WorldCutter, "Cut");
+    this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
+  }
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -1184,9 +1425,10 @@ void vtkSlicerShapeRepresentation2D::UpdateArcFromMRML(vtkMRMLNode* caller, unsi
   double p1World[3] = { 0.0 };
   double p2World[3] = { 0.0 };
   double p3World[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
-  shapeNode->GetNthControlPointPositionWorld(2, p3World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
+  controlPointsWorld->GetPoint(2, p3World);
   
   this->ShapeMapper->SetInputConnection(this->ArcSource->GetOutputPort());
   
@@ -1207,7 +1449,7 @@ void vtkSlicerShapeRepresentation2D::UpdateArcFromMRML(vtkMRMLNode* caller, unsi
   
   // Update shape and map from world to slice.
   this->ShapeWorldToSliceTransformer->SetInputConnection(this->ArcSource->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -1222,9 +1464,9 @@ void vtkSlicerShapeRepresentation2D::UpdateArcFromMRML(vtkMRMLNode* caller, unsi
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
   this->WorldCutter->SetInputConnection(this->ArcSource->GetOutputPort());
-  this->WorldCutter->Update();
+  this->UpdateTimed(this->WorldCutter, "Cut");
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -1262,44 +1504,11 @@ void vtkSlicerShapeRepresentation2D::UpdateParametricFromMRML(vtkMRMLNode* calle
     return;
   }
   
-  switch (shapeNode->GetShapeName())
+  // The function of the node's shape is set once, in BuildShapePipeline().
+  if (!this->ParametricFunctionSource || !this->ParametricFunctionSource->GetParametricFunction())
   {
-    case vtkMRMLMarkupsShapeNode::Ellipsoid:
-      this->ParametricFunctionSource->SetParametricFunction(this->Ellipsoid);
-      break;
-    case vtkMRMLMarkupsShapeNode::Toroid:
-      this->ParametricFunctionSource->SetParametricFunction(this->Toroid);
-      break;
-    case vtkMRMLMarkupsShapeNode::BohemianDome:
-      this->ParametricFunctionSource->SetParametricFunction(this->BohemianDome);
-      break;
-    case vtkMRMLMarkupsShapeNode::Bour:
-      this->ParametricFunctionSource->SetParametricFunction(this->Bour);
-      break;
-    case vtkMRMLMarkupsShapeNode::Boy:
-      this->ParametricFunctionSource->SetParametricFunction(this->Boy);
-      break;
-    case vtkMRMLMarkupsShapeNode::CrossCap:
-      this->ParametricFunctionSource->SetParametricFunction(this->CrossCap);
-      break;
-    case vtkMRMLMarkupsShapeNode::ConicSpiral:
-      this->ParametricFunctionSource->SetParametricFunction(this->ConicSpiral);
-      break;
-    case vtkMRMLMarkupsShapeNode::Kuen:
-      this->ParametricFunctionSource->SetParametricFunction(this->Kuen);
-      break;
-    case vtkMRMLMarkupsShapeNode::Mobius:
-      this->ParametricFunctionSource->SetParametricFunction(this->Mobius);
-      break;
-    case vtkMRMLMarkupsShapeNode::PluckerConoid:
-      this->ParametricFunctionSource->SetParametricFunction(this->PluckerConoid);
-      break;
-    case vtkMRMLMarkupsShapeNode::Roman:
-      this->ParametricFunctionSource->SetParametricFunction(this->Roman);
-      break;
-    default:
-      vtkErrorMacro("Unfit shape.");
-      return;
+    vtkErrorMacro("Unfit shape.");
+    return;
   }
   
   double p1World[3] = { 0.0 };
@@ -1308,10 +1517,11 @@ void vtkSlicerShapeRepresentation2D::UpdateParametricFromMRML(vtkMRMLNode* calle
   double p4World[3] = { 0.0 };
   double directionWorld[3] = { 0.0 };
   double centerWorld[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1World);
-  shapeNode->GetNthControlPointPositionWorld(1, p2World);
-  shapeNode->GetNthControlPointPositionWorld(2, p3World);
-  shapeNode->GetNthControlPointPositionWorld(3, p4World);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1World);
+  controlPointsWorld->GetPoint(1, p2World);
+  controlPointsWorld->GetPoint(2, p3World);
+  controlPointsWorld->GetPoint(3, p4World);
   
   double center[3] = { 0.0 };
   double p1[3] = { 0.0 };
@@ -1434,7 +1644,7 @@ void vtkSlicerShapeRepresentation2D::UpdateParametricFromMRML(vtkMRMLNode* calle
   
   // Update shape and map from world to slice.
   this->ShapeWorldToSliceTransformer->SetInputConnection(this->ParametricTransformer->GetOutputPort());
-  this->ShapeWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeWorldToSliceTransformer, "WorldToSlice");
   this->ShapeMapper->SetInputConnection(this->ShapeWorldToSliceTransformer->GetOutputPort());
   this->ShapeMapper->Update();
   
@@ -1450,9 +1660,9 @@ void vtkSlicerShapeRepresentation2D::UpdateParametricFromMRML(vtkMRMLNode* calle
   this->WorldPlane->SetOrigin(origin);
   this->WorldPlane->SetNormal(normal);
   this->WorldCutter->SetInputConnection(this->ParametricTransformer->GetOutputPort());
-  this->WorldCutter->Update();
+  this->UpdateTimed(this->WorldCutter, "Cut");
   this->ShapeCutWorldToSliceTransformer->SetInputConnection(this->WorldCutter->GetOutputPort());
-  this->ShapeCutWorldToSliceTransformer->Update();
+  this->UpdateTimed(this->ShapeCutWorldToSliceTransformer, "CutWorldToSlice");
   this->WorldCutMapper->SetInputConnection(this->ShapeCutWorldToSliceTransformer->GetOutputPort());
   this->WorldCutMapper->Update();
   
@@ -44,6 +44,9 @@
 
 // Markups VTKWidgets includes
 #include "vtkSlicerMarkupsWidgetRepresentation2D.h"
+#include "vtkSlicerAdaptiveSplineSampler.h"
+#include "vtkSlicerAdaptiveTubeFilter.h"
+#include "vtkSlicerCylinderSource.h"
 
 // VTK includes
 #include <vtkSmartPointer.h>
@@ -53,6 +56,7 @@
 #include <vtkSampleImplicitFunctionFilter.h>
 #include <vtkCutter.h>
 #include <vtkTubeFilter.h>
+#include <vtkTrivialProducer.h>
 #include <vtkParametricSpline.h>
 #include <vtkParametricSuperEllipsoid.h>
 #include <vtkParametricSuperToroid.h>
@@ -75,6 +79,7 @@
 class vtkGlyphSource2D;
 class vtkPolyDataMapper2D;
 class vtkActor2D;
+class vtkMRMLMarkupsShapeNode;
 
 /**
  * @class   vtkSlicerShapeRepresentation2D
@@ -103,6 +108,9 @@ public:
   int RenderOpaqueGeometry(vtkViewport *viewport) override;
   int RenderTranslucentPolygonalGeometry(vtkViewport *viewport) override;
   vtkTypeBool HasTranslucentPolygonalGeometry() override;
+  
+  /// Memory held by the outputs of the current shape pipeline, in kibibytes.
+  unsigned long GetPipelineMemorySize();
 
 protected:
   vtkSlicerShapeRepresentation2D();
@@ -117,6 +125,13 @@ protected:
   void UpdateCylinderFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData=nullptr);
   void UpdateArcFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData=nullptr);
   void UpdateParametricFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData=nullptr);
+  
+  // Only the sources of the node's current shape are built; see UpdateFromMRML().
+  void BuildShapePipeline(vtkMRMLMarkupsShapeNode * shapeNode);
+  void ReleaseShapePipeline();
+  int PipelineShapeName = -1;
+  // Update an algorithm, timed as a phase of the node; see vtkMRMLMarkupsProfiler.
+  void UpdateTimed(vtkAlgorithm * algorithm, const char * phase);
 
   vtkSmartPointer<vtkGlyphSource2D> MiddlePointSource;
   vtkSmartPointer<vtkPolyDataMapper2D> MiddlePointDataMapper;
@@ -140,14 +155,23 @@ protected:
   vtkSmartPointer<vtkDiskSource> RingSource;
   vtkSmartPointer<vtkSphereSource> SphereSource;
   vtkSmartPointer<vtkConeSource> ConeSource;
-  vtkSmartPointer<vtkTubeFilter> CylinderSource; // Regular tube.
-  vtkSmartPointer<vtkLineSource> CylinderAxis;
+  vtkSmartPointer<vtkSlicerCylinderSource> CylinderSource;
+  vtkSmartPointer<vtkPolyData> CylinderCutWorld; // Exact ellipse.
+  // The above are built once in unit size at the origin and placed with this transform.
+  vtkSmartPointer<vtkTransform> PrimitiveTransform;
+  vtkSmartPointer<vtkTransformPolyDataFilter> PrimitiveTransformer;
   vtkSmartPointer<vtkArcSource> ArcSource;
   
   vtkSmartPointer<vtkParametricSpline> Spline;
   vtkSmartPointer<vtkParametricFunctionSource> SplineFunctionSource;
-  vtkSmartPointer<vtkTubeFilter> Tube; // Variable radius tube.
-  vtkSmartPointer<vtkTubeFilter> CappedTube;
+  vtkSmartPointer<vtkSlicerAdaptiveSplineSampler> SplineSampler;
+  vtkSmartPointer<vtkSlicerAdaptiveTubeFilter> Tube; // Variable radius tube.
+  vtkSmartPointer<vtkSlicerAdaptiveTubeFilter> CappedTube;
+  // Serve the node's cached geometry instead of the above; see vtkMRMLMarkupsShapeNode::ValidateCachedGeometry().
+  vtkSmartPointer<vtkTrivialProducer> CachedTubeProducer;
+  vtkSmartPointer<vtkTrivialProducer> CachedSplineProducer;
+  // Build the spline and the displayed tube from the control points.
+  void GenerateTube(vtkMRMLMarkupsShapeNode * shapeNode);
   
   vtkSmartPointer<vtkParametricSuperEllipsoid> Ellipsoid;
   vtkSmartPointer<vtkParametricSuperToroid> Toroid;
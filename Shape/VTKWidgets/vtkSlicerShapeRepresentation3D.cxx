@@ -21,11 +21,12 @@
 #include "vtkSlicerShapeRepresentation3D.h"
 
 #include "vtkMRMLMarkupsShapeNode.h"
+#include "vtkMRMLMarkupsProfiler.h"
+#include "vtkSlicerShapePlacement.h"
+#include "vtkSlicerShapeInstancer.h"
 
 // VTK includes
 #include <vtkActor.h>
-#include <vtkCutter.h>
-#include <vtkPlane.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkTupleInterpolator.h>
@@ -35,6 +36,7 @@
 #include <vtkCamera.h>
 #include <vtkTextActor.h>
 #include <vtkMatrix4x4.h>
+#include <vtkDataObject.h>
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerShapeRepresentation3D);
@@ -42,14 +44,14 @@ vtkStandardNewMacro(vtkSlicerShapeRepresentation3D);
 //------------------------------------------------------------------------------
 vtkSlicerShapeRepresentation3D::vtkSlicerShapeRepresentation3D()
 {
-  this->DiskSource = vtkSmartPointer<vtkDiskSource>::New();
-  this->RingSource = vtkSmartPointer<vtkDiskSource>::New();
+  // Shape specific sources are built on demand in BuildShapePipeline().
   this->RadiusSource = vtkSmartPointer<vtkLineSource>::New();
-  this->SphereSource = vtkSmartPointer<vtkSphereSource>::New();
-  this->ConeSource = vtkSmartPointer<vtkConeSource>::New();
-  this->ConeSource->CappingOn();
-  this->ArcSource = vtkSmartPointer<vtkArcSource>::New();
-  this->ArcSource->UseNormalAndAngleOn();
+  this->DeferredGeometryCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->DeferredGeometryCallback->SetClientData(reinterpret_cast<void *>(this));
+  this->DeferredGeometryCallback->SetCallback(vtkSlicerShapeRepresentation3D::OnDeferredGeometryRequested);
+  this->PrimitiveTransform = vtkSmartPointer<vtkTransform>::New();
+  this->PrimitiveTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  this->PrimitiveTransformer->SetTransform(this->PrimitiveTransform);
   
   this->ShapeMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
   this->ShapeProperty = vtkSmartPointer<vtkProperty>::New();
@@ -70,48 +72,10 @@ vtkSlicerShapeRepresentation3D::vtkSlicerShapeRepresentation3D()
   this->RadiusActor->SetMapper(this->RadiusMapper);
   this->RadiusActor->SetProperty(this->GetControlPointsPipeline(Unselected)->Property);
   
-  this->Spline = vtkSmartPointer<vtkParametricSpline>::New();
-  vtkNew<vtkPoints> points;
-  const double point[3] = { 0.0 };
-  points->InsertNextPoint(point);
-  this->Spline->SetPoints(points);
-  this->SplineFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
-  this->SplineFunctionSource->SetParametricFunction(this->Spline);
   this->SplineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  this->SplineMapper->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
   this->SplineActor = vtkSmartPointer<vtkActor>::New();
   this->SplineActor->SetMapper(this->SplineMapper);
   this->SplineActor->SetProperty(this->ShapeProperty);
-  // This is for display. Viewing a closed tube is not natural while dealing with arteries.
-  this->Tube = vtkSmartPointer<vtkTubeFilter>::New();
-  this->Tube->SetNumberOfSides(20);
-  this->Tube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
-  this->Tube->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
-  // This is to calculate volume with vtkMassProperties, it needs a closed polydata.
-  this->CappedTube = vtkSmartPointer<vtkTubeFilter>::New();
-  this->CappedTube->SetNumberOfSides(20);
-  this->CappedTube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
-  this->CappedTube->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
-  this->CappedTube->SetCapping(true);
-  
-  this->CylinderAxis = vtkSmartPointer<vtkLineSource>::New();
-  this->CylinderSource = vtkSmartPointer<vtkTubeFilter>::New();
-  this->CylinderSource->SetNumberOfSides(20);
-  this->CylinderSource->SetInputConnection(this->CylinderAxis->GetOutputPort());
-  this->CylinderSource->SetCapping(true);
-
-  this->Ellipsoid = vtkSmartPointer<vtkParametricSuperEllipsoid>::New();
-  this->Toroid = vtkSmartPointer<vtkParametricSuperToroid>::New();
-  this->BohemianDome = vtkSmartPointer<vtkParametricBohemianDome>::New();
-  this->Bour = vtkSmartPointer<vtkParametricBour>::New();
-  this->Boy = vtkSmartPointer<vtkParametricBoy>::New();
-  this->CrossCap = vtkSmartPointer<vtkParametricCrossCap>::New();
-  this->ConicSpiral = vtkSmartPointer<vtkParametricConicSpiral>::New();
-  this->Kuen = vtkSmartPointer<vtkParametricKuen>::New();
-  this->Mobius = vtkSmartPointer<vtkParametricMobius>::New();
-  this->PluckerConoid = vtkSmartPointer<vtkParametricPluckerConoid>::New();
-  this->Roman = vtkSmartPointer<vtkParametricRoman>::New();
-  this->ParametricFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
   
   this->ParametricMiddlePointSource = vtkSmartPointer<vtkSphereSource>::New();
   this->ParametricMiddlePointMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -126,12 +90,210 @@ vtkSlicerShapeRepresentation3D::vtkSlicerShapeRepresentation3D()
 //------------------------------------------------------------------------------
 vtkSlicerShapeRepresentation3D::~vtkSlicerShapeRepresentation3D()
 {
+  this->RemoveShapeInstance();
 }
 
 //------------------------------------------------------------------------------
 void vtkSlicerShapeRepresentation3D::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "Pipeline shape: " << this->PipelineShapeName << "\n";
+  os << indent << "Pipeline memory size: " << this->GetPipelineMemorySize() << " KiB\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation3D::BuildShapePipeline(vtkMRMLMarkupsShapeNode * shapeNode)
+{
+  const int shapeName = shapeNode->GetShapeName();
+  if (shapeNode->IsParametric())
+  {
+    this->ParametricFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
+  }
+  // Unit primitives : along Z for disk, ring and sphere, along X for cone and cylinder.
+  switch (shapeName)
+  {
+    case vtkMRMLMarkupsShapeNode::Sphere :
+      this->SphereSource = vtkSmartPointer<vtkSphereSource>::New();
+      this->SphereSource->SetRadius(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Ring :
+      this->RingSource = vtkSmartPointer<vtkDiskSource>::New();
+      this->RingSource->SetOuterRadius(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Disk :
+      this->DiskSource = vtkSmartPointer<vtkDiskSource>::New();
+      this->DiskSource->SetOuterRadius(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Tube :
+    {
+      this->Spline = vtkSmartPointer<vtkParametricSpline>::New();
+      vtkNew<vtkPoints> points;
+      const double point[3] = { 0.0 };
+      points->InsertNextPoint(point);
+      this->Spline->SetPoints(points);
+      this->SplineFunctionSource = vtkSmartPointer<vtkParametricFunctionSource>::New();
+      this->SplineFunctionSource->SetParametricFunction(this->Spline);
+      // Drops spline points that straight and constant radius segments don't need.
+      this->SplineSampler = vtkSmartPointer<vtkSlicerAdaptiveSplineSampler>::New();
+      this->SplineSampler->SetInputConnection(this->SplineFunctionSource->GetOutputPort());
+      this->SplineMapper->SetInputConnection(this->SplineSampler->GetOutputPort());
+      // This is for display. Viewing a closed tube is not natural while dealing with arteries.
+      this->Tube = vtkSmartPointer<vtkSlicerAdaptiveTubeFilter>::New();
+      this->Tube->SetNumberOfSides(20);
+      this->Tube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
+      this->Tube->SetInputConnection(this->SplineSampler->GetOutputPort());
+      // This is to calculate volume with vtkMassProperties, it needs a closed polydata.
+      this->CappedTube = vtkSmartPointer<vtkSlicerAdaptiveTubeFilter>::New();
+      this->CappedTube->SetNumberOfSides(20);
+      this->CappedTube->SetVaryRadiusToVaryRadiusByAbsoluteScalar();
+      this->CappedTube->SetInputConnection(this->SplineSampler->GetOutputPort());
+      this->CappedTube->SetCapping(true);
+      // These feed the mappers with geometry read from a sidecar file; see UpdateTubeFromMRML().
+      this->CachedTubeProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+      this->CachedCappedTubeProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+      this->CachedSplineProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+      break;
+    }
+    case vtkMRMLMarkupsShapeNode::Cone :
+      this->ConeSource = vtkSmartPointer<vtkConeSource>::New();
+      this->ConeSource->CappingOn();
+      this->ConeSource->SetRadius(1.0);
+      this->ConeSource->SetHeight(1.0);
+      break;
+    case vtkMRMLMarkupsShapeNode::Cylinder :
+      this->CylinderSource = vtkSmartPointer<vtkSlicerCylinderSource>::New();
+      this->CylinderSource->SetResolution(20);
+      this->CylinderSource->SetCapping(true);
+      break;
+    case vtkMRMLMarkupsShapeNode::Arc :
+      this->ArcSource = vtkSmartPointer<vtkArcSource>::New();
+      this->ArcSource->UseNormalAndAngleOn();
+      break;
+    case vtkMRMLMarkupsShapeNode::Ellipsoid :
+      this->Ellipsoid = vtkSmartPointer<vtkParametricSuperEllipsoid>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Ellipsoid);
+      break;
+    case vtkMRMLMarkupsShapeNode::Toroid :
+      this->Toroid = vtkSmartPointer<vtkParametricSuperToroid>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Toroid);
+      break;
+    case vtkMRMLMarkupsShapeNode::BohemianDome :
+      this->BohemianDome = vtkSmartPointer<vtkParametricBohemianDome>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->BohemianDome);
+      break;
+    case vtkMRMLMarkupsShapeNode::Bour :
+      this->Bour = vtkSmartPointer<vtkParametricBour>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Bour);
+      break;
+    case vtkMRMLMarkupsShapeNode::Boy :
+      this->Boy = vtkSmartPointer<vtkParametricBoy>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Boy);
+      break;
+    case vtkMRMLMarkupsShapeNode::CrossCap :
+      this->CrossCap = vtkSmartPointer<vtkParametricCrossCap>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->CrossCap);
+      break;
+    case vtkMRMLMarkupsShapeNode::ConicSpiral :
+      this->ConicSpiral = vtkSmartPointer<vtkParametricConicSpiral>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->ConicSpiral);
+      break;
+    case vtkMRMLMarkupsShapeNode::Kuen :
+      this->Kuen = vtkSmartPointer<vtkParametricKuen>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Kuen);
+      break;
+    case vtkMRMLMarkupsShapeNode::Mobius :
+      this->Mobius = vtkSmartPointer<vtkParametricMobius>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Mobius);
+      break;
+    case vtkMRMLMarkupsShapeNode::PluckerConoid :
+      this->PluckerConoid = vtkSmartPointer<vtkParametricPluckerConoid>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->PluckerConoid);
+      break;
+    case vtkMRMLMarkupsShapeNode::Roman :
+      this->Roman = vtkSmartPointer<vtkParametricRoman>::New();
+      this->ParametricFunctionSource->SetParametricFunction(this->Roman);
+      break;
+    default:
+      break;
+  }
+  this->PipelineShapeName = shapeName;
+  vtkDebugMacro("Built pipeline for shape " << shapeNode->GetShapeNameAsString(shapeName) << ".");
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation3D::ReleaseShapePipeline(vtkMRMLMarkupsShapeNode * shapeNode)
+{
+  if (this->PipelineShapeName < 0)
+  {
+    return;
+  }
+  // The node holds plain pointers to outputs of the released sources.
+  if (shapeNode && this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
+  {
+    shapeNode->SetShapeWorld(nullptr);
+    shapeNode->SetCappedTubeWorld(nullptr);
+    shapeNode->SetSplineWorld(nullptr);
+  }
+  // Shared consumers would otherwise keep the released sources alive.
+  this->ShapeMapper->RemoveAllInputConnections(0);
+  this->SplineMapper->RemoveAllInputConnections(0);
+  this->PrimitiveTransformer->RemoveAllInputConnections(0);
+  this->ParametricTransformer->RemoveAllInputConnections(0);
+  
+  this->DiskSource = nullptr;
+  this->RingSource = nullptr;
+  this->SphereSource = nullptr;
+  this->ConeSource = nullptr;
+  this->CylinderSource = nullptr;
+  this->ArcSource = nullptr;
+  this->Spline = nullptr;
+  this->SplineFunctionSource = nullptr;
+  this->SplineSampler = nullptr;
+  this->Tube = nullptr;
+  this->CappedTube = nullptr;
+  this->CachedTubeProducer = nullptr;
+  this->CachedCappedTubeProducer = nullptr;
+  this->CachedSplineProducer = nullptr;
+  this->Ellipsoid = nullptr;
+  this->Toroid = nullptr;
+  this->BohemianDome = nullptr;
+  this->Bour = nullptr;
+  this->Boy = nullptr;
+  this->CrossCap = nullptr;
+  this->ConicSpiral = nullptr;
+  this->Kuen = nullptr;
+  this->Mobius = nullptr;
+  this->PluckerConoid = nullptr;
+  this->Roman = nullptr;
+  this->ParametricFunctionSource = nullptr;
+  this->PipelineShapeName = -1;
+}
+
+//------------------------------------------------------------------------------
+unsigned long vtkSlicerShapeRepresentation3D::GetPipelineMemorySize()
+{
+  vtkAlgorithm * algorithms[] = {
+    this->DiskSource, this->RingSource, this->SphereSource, this->ConeSource,
+    this->CylinderSource, this->ArcSource, this->SplineFunctionSource, this->SplineSampler,
+    this->Tube, this->CappedTube, this->ParametricFunctionSource,
+    this->PrimitiveTransformer, this->ParametricTransformer,
+    this->RadiusSource, this->MiddlePointSource, this->ParametricMiddlePointSource
+  };
+  unsigned long size = 0;
+  for (vtkAlgorithm * algorithm : algorithms)
+  {
+    // Sources that are not built, or have not executed yet, hold nothing.
+    if (!algorithm || algorithm->GetNumberOfOutputPorts() < 1)
+    {
+      continue;
+    }
+    vtkDataObject * output = algorithm->GetOutputDataObject(0);
+    if (output)
+    {
+      size += output->GetActualMemorySize();
+    }
+  }
+  return size;
 }
 
 //------------------------------------------------------------------------------
@@ -143,6 +305,11 @@ void vtkSlicerShapeRepresentation3D::GetActors(vtkPropCollection* pc)
   this->ParametricMiddlePointActor->GetActors(pc);
   this->RadiusActor->GetActors(pc);
   this->SplineActor->GetActors(pc);
+  vtkSlicerShapeInstancer * instancer = this->GetShapeInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+  {
+    instancer->GetActor()->GetActors(pc);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -154,6 +321,11 @@ void vtkSlicerShapeRepresentation3D::ReleaseGraphicsResources(vtkWindow* win)
   this->ParametricMiddlePointActor->ReleaseGraphicsResources(win);
   this->RadiusActor->ReleaseGraphicsResources(win);
   this->SplineActor->ReleaseGraphicsResources(win);
+  vtkSlicerShapeInstancer * instancer = this->GetShapeInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+  {
+    instancer->ReleaseGraphicsResources(win);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -207,6 +379,11 @@ int vtkSlicerShapeRepresentation3D::RenderOpaqueGeometry(vtkViewport* viewport)
   {
     count += this->SplineActor->RenderOpaqueGeometry(viewport);
   }
+  vtkSlicerShapeInstancer * instancer = this->GetShapeInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+  {
+    count += instancer->RenderOpaqueGeometry(viewport);
+  }
 
   return count;
 }
@@ -240,6 +417,12 @@ int vtkSlicerShapeRepresentation3D::RenderTranslucentPolygonalGeometry(vtkViewpo
     this->SplineActor->SetPropertyKeys(this->GetPropertyKeys());
     count += this->SplineActor->RenderTranslucentPolygonalGeometry(viewport);
   }
+  vtkSlicerShapeInstancer * instancer = this->GetShapeInstancer();
+  if (instancer && instancer->IsRenderingOwner(this))
+  {
+    instancer->GetActor()->SetPropertyKeys(this->GetPropertyKeys());
+    count += instancer->RenderTranslucentPolygonalGeometry(viewport);
+  }
 
   return count;
 }
@@ -276,6 +459,12 @@ vtkTypeBool vtkSlicerShapeRepresentation3D::HasTranslucentPolygonalGeometry()
   {
     return true;
   }
+  vtkSlicerShapeInstancer * instancer = this->GetShapeInstancer();
+  if (instancer && instancer->IsRenderingOwner(this) &&
+    instancer->HasTranslucentPolygonalGeometry())
+  {
+    return true;
+  }
 
   return false;
 }
@@ -285,6 +474,7 @@ void vtkSlicerShapeRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller,
                                                            unsigned long event,
                                                            void *callData /*=nullptr*/)
 {
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), "Update3D");
   this->Superclass::UpdateFromMRML(caller, event, callData);
 
   this->NeedToRenderOn();
@@ -297,6 +487,11 @@ void vtkSlicerShapeRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller,
   {
     return;
   }
+  if (shapeNode->GetShapeName() != this->PipelineShapeName)
+  {
+    this->ReleaseShapePipeline(shapeNode);
+    this->BuildShapePipeline(shapeNode);
+  }
 
   this->ShapeMapper->SetScalarVisibility(shapeNode->GetScalarVisibility());
   this->RadiusMapper->SetScalarVisibility(shapeNode->GetScalarVisibility());
@@ -308,6 +503,24 @@ void vtkSlicerShapeRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller,
   this->RadiusActor->SetVisibility(false);
   this->TextActor->SetVisibility(false);
   this->SplineActor->SetVisibility(false);
+  // Set again by UpdateSphereFromMRML if the sphere is still instanced.
+  this->ShapeInstanced = false;
+  
+  // The geometry of a hidden node is generated once shown, or once requested from the node.
+  const bool firstView = (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()));
+  if (!this->GetVisibility() && !this->GeometryRequested)
+  {
+    if (firstView)
+    {
+      shapeNode->SetDeferredGeometryCommand(this->DeferredGeometryCallback);
+    }
+    this->RemoveShapeInstance();
+    return;
+  }
+  if (firstView)
+  {
+    shapeNode->SetDeferredGeometryCommand(nullptr);
+  }
 
   if (!shapeNode->IsParametric())
   {
@@ -347,6 +560,45 @@ void vtkSlicerShapeRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller,
   {
     this->UpdateParametricFromMRML(caller, event, callData);
   }
+  if (!this->ShapeInstanced)
+  {
+    this->RemoveShapeInstance();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation3D::OnDeferredGeometryRequested(vtkObject * vtkNotUsed(caller),
+                                                                 unsigned long vtkNotUsed(event),
+                                                                 void * clientData, void * vtkNotUsed(callData))
+{
+  vtkSlicerShapeRepresentation3D * self = reinterpret_cast<vtkSlicerShapeRepresentation3D*>(clientData);
+  self->GeometryRequested = true;
+  self->UpdateFromMRML(nullptr, 0);
+  self->GeometryRequested = false;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation3D::UpdateTimed(vtkAlgorithm * algorithm, const char * phase)
+{
+  vtkMRMLMarkupsProfiler::Scope timer(this->GetMarkupsNode(), phase);
+  algorithm->Update();
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerShapeInstancer * vtkSlicerShapeRepresentation3D::GetShapeInstancer() const
+{
+  return vtkSlicerShapeInstancer::GetInstancer(this->InstancedRenderer, false);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation3D::RemoveShapeInstance()
+{
+  vtkSlicerShapeInstancer * instancer = this->GetShapeInstancer();
+  if (instancer)
+  {
+    instancer->RemoveInstance(this);
+  }
+  this->InstancedRenderer = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -421,9 +673,10 @@ void vtkSlicerShapeRepresentation3D::UpdateDiskFromMRML(vtkMRMLNode* caller,
   double p1[3] = { 0.0 }; // center
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
-  shapeNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   
   // Relative to center
   double rp2[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
@@ -437,13 +690,21 @@ void vtkSlicerShapeRepresentation3D::UpdateDiskFromMRML(vtkMRMLNode* caller,
     return;
   }
   
-  this->DiskSource->SetCenter(p1);
-  this->DiskSource->SetNormal(normal);
-  this->DiskSource->SetOuterRadius(innerRadius);
-  this->DiskSource->SetInnerRadius(outerRadius);
+  // Only the ratio of the radii is left to the source, the size is in the transform.
+  const double diskScale = std::max(innerRadius, outerRadius);
+  const double scale[3] = { diskScale, diskScale, diskScale };
+  const double zAxis[3] = { 0.0, 0.0, 1.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, p1, zAxis, normal, scale))
+  {
+    vtkDebugMacro("Degenerate disk.");
+    return;
+  }
+  this->DiskSource->SetOuterRadius(innerRadius / diskScale);
+  this->DiskSource->SetInnerRadius(outerRadius / diskScale);
   
   this->DiskSource->SetCircumferentialResolution((int) shapeNode->GetResolution());
   this->DiskSource->Update();
+  this->ShapeActor->SetUserTransform(this->PrimitiveTransform);
   
   this->ShapeActor->SetVisibility(shapeNode->GetNumberOfDefinedControlPoints(true) == shapeNode->GetRequiredNumberOfControlPoints());
   this->TextActor->SetVisibility(shapeNode->GetNumberOfDefinedControlPoints(true) == shapeNode->GetRequiredNumberOfControlPoints());
@@ -464,7 +725,8 @@ void vtkSlicerShapeRepresentation3D::UpdateDiskFromMRML(vtkMRMLNode* caller,
   
   if (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
   {
-    shapeNode->SetShapeWorld(this->DiskSource->GetOutput());
+    this->PrimitiveTransformer->SetInputConnection(this->DiskSource->GetOutputPort());
+    shapeNode->SetShapeWorldProducer(this->PrimitiveTransformer);
   }
   
   this->ShapeActor->SetVisibility(true);
@@ -489,9 +751,10 @@ void vtkSlicerShapeRepresentation3D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
   double center[3] = {0.0};
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
-  shapeNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   center[0] = (p1[0] + p2[0]) / 2.0;
   center[1] = (p1[1] + p2[1]) / 2.0;
   center[2] = (p1[2] + p2[2]) / 2.0;
@@ -499,6 +762,7 @@ void vtkSlicerShapeRepresentation3D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   this->ShapeMapper->SetInputConnection(this->RingSource->GetOutputPort());
   
   double lineLength = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+  double outerRadius = lineLength;
   double normal[3] = { 0.0 };
   
   // Centered mode : p1 is center, line length is radius.
@@ -514,10 +778,7 @@ void vtkSlicerShapeRepresentation3D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
       vtkDebugMacro("Got zero normal.");
       return;
     }
-    this->RingSource->SetCenter(p1);
-    this->RingSource->SetNormal(normal);
-    this->RingSource->SetOuterRadius(lineLength);
-    this->RingSource->SetInnerRadius(lineLength - this->ViewScaleFactorMmPerPixel);
+    vtkMath::Assign(p1, center);
     this->RadiusSource->SetPoint1(p1);
     
     this->MiddlePointActor->SetVisibility(false);
@@ -525,27 +786,33 @@ void vtkSlicerShapeRepresentation3D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   // Circumferentiale mode : center is half way between p1 and p2, radius is half of line length.
   else
   {
-    double radius = lineLength / 2.0;
+    outerRadius = lineLength / 2.0;
     
     // relative to center
     double rp2[3] = { p2[0] - center[0], p2[1] - center[1], p2[2] - center[2] };
     double rp3[3] = { p3[0] - center[0], p3[1] - center[1], p3[2] - center[2] };
     
     vtkMath::Cross(rp2, rp3, normal);
-    this->RingSource->SetCenter(center);
-    this->RingSource->SetNormal(normal);
-    this->RingSource->SetOuterRadius(radius);
-    this->RingSource->SetInnerRadius(radius - this->ViewScaleFactorMmPerPixel);
     this->RadiusSource->SetPoint1(center);
     
     this->MiddlePointActor->SetVisibility(true);
   }
   
+  const double scale[3] = { outerRadius, outerRadius, outerRadius };
+  const double zAxis[3] = { 0.0, 0.0, 1.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, center, zAxis, normal, scale))
+  {
+    vtkDebugMacro("Degenerate ring.");
+    return;
+  }
+  this->RingSource->SetInnerRadius((outerRadius - this->ViewScaleFactorMmPerPixel) / outerRadius);
   this->RingSource->SetCircumferentialResolution((int) shapeNode->GetResolution());
   this->RingSource->Update();
+  this->ShapeActor->SetUserTransform(this->PrimitiveTransform);
   if (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
   {
-    shapeNode->SetShapeWorld(this->RingSource->GetOutput());
+    this->PrimitiveTransformer->SetInputConnection(this->RingSource->GetOutputPort());
+    shapeNode->SetShapeWorldProducer(this->PrimitiveTransformer);
   }
   
   this->RadiusSource->SetPoint2(p2);
@@ -559,11 +826,16 @@ void vtkSlicerShapeRepresentation3D::UpdateRingFromMRML(vtkMRMLNode* caller, uns
   
   // Stick p3 on ring.
   this->DoUpdateFromMRML = false;
-  vtkIdType closestIdOnRing = this->RingSource->GetOutput()->FindPoint(p3);
+  // Search in unit space, the placement preserves proximity.
+  double unitP3[3] = { 0.0 };
+  this->PrimitiveTransform->GetLinearInverse()->TransformPoint(p3, unitP3);
+  vtkIdType closestIdOnRing = this->RingSource->GetOutput()->FindPoint(unitP3);
   if (closestIdOnRing >= 0)
   {
-    double * closestPointOnRing = this->RingSource->GetOutput()->GetPoint(closestIdOnRing);
-    if (p3[0] != closestPointOnRing[0] || p3[1] != closestPointOnRing[1] || p3[2] != closestPointOnRing[2])
+    double closestPointOnRing[3] = { 0.0 };
+    this->PrimitiveTransform->TransformPoint(this->RingSource->GetOutput()->GetPoint(closestIdOnRing), closestPointOnRing);
+    // Tolerate rounding from the placement, lest views snap the point back and forth.
+    if (vtkMath::Distance2BetweenPoints(p3, closestPointOnRing) > 1e-12 * outerRadius * outerRadius)
     {
       if (shapeNode->GetNumberOfDefinedControlPoints() == shapeNode->GetRequiredNumberOfControlPoints() && shapeNode->GetModifiedSinceRead())
       {
@@ -594,8 +866,9 @@ void vtkSlicerShapeRepresentation3D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double center[3] = {0.0};
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
   center[0] = (p1[0] + p2[0]) / 2.0;
   center[1] = (p1[1] + p2[1]) / 2.0;
   center[2] = (p1[2] + p2[2]) / 2.0;
@@ -604,29 +877,37 @@ void vtkSlicerShapeRepresentation3D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   double lineLength = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   
   // Centered mode : p1 is center, line length is radius.
+  double radius = lineLength;
   if (shapeNode->GetRadiusMode() == vtkMRMLMarkupsShapeNode::Centered)
   {
-    this->SphereSource->SetCenter(p1);
-    this->SphereSource->SetRadius(lineLength);
+    vtkMath::Assign(p1, center);
     this->RadiusSource->SetPoint1(p1);
     this->MiddlePointActor->SetVisibility(false);
   }
   // Circumferential mode : center is half way between p1 and p2, radius is half of line length.
   else
   {
-    double radius = lineLength / 2.0;
+    radius = lineLength / 2.0;
     
-    this->SphereSource->SetCenter(center);
-    this->SphereSource->SetRadius(radius);
     this->RadiusSource->SetPoint1(center);
     this->MiddlePointActor->SetVisibility(true);
   }
+  const double scale[3] = { radius, radius, radius };
+  const double zAxis[3] = { 0.0, 0.0, 1.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, center, zAxis, zAxis, scale))
+  {
+    vtkDebugMacro("Degenerate sphere.");
+    return;
+  }
+  // The unit sphere is only regenerated when the resolution changes.
   this->SphereSource->SetPhiResolution(shapeNode->GetResolution());
   this->SphereSource->SetThetaResolution(shapeNode->GetResolution());
   this->SphereSource->Update();
+  this->ShapeActor->SetUserTransform(this->PrimitiveTransform);
   if (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
   {
-    shapeNode->SetShapeWorld(this->SphereSource->GetOutput());
+    this->PrimitiveTransformer->SetInputConnection(this->SphereSource->GetOutputPort());
+    shapeNode->SetShapeWorldProducer(this->PrimitiveTransformer);
   }
   
   this->RadiusSource->SetPoint2(p2);
@@ -647,7 +928,21 @@ void vtkSlicerShapeRepresentation3D::UpdateSphereFromMRML(vtkMRMLNode* caller, u
   this->TextActorPositionWorld[1] = p2[1];
   this->TextActorPositionWorld[2] = p2[2];
 
-  this->ShapeActor->SetVisibility(true);
+  // Batched spheres are drawn by the renderer's instancer rather than by ShapeActor.
+  vtkRenderer * renderer = this->GetRenderer();
+  if (vtkSlicerShapeInstancer::GetEnabled() && renderer && this->GetVisibility())
+  {
+    if (this->InstancedRenderer && this->InstancedRenderer != renderer)
+    {
+      this->RemoveShapeInstance();
+    }
+    vtkSlicerShapeInstancer::GetInstancer(renderer)->SetInstance(this, shapeNode->GetID(), center, radius,
+                                                                  this->ShapeProperty->GetColor(), fillOpacity,
+                                                                  shapeNode->GetResolution());
+    this->InstancedRenderer = renderer;
+    this->ShapeInstanced = true;
+  }
+  this->ShapeActor->SetVisibility(!this->ShapeInstanced);
   this->RadiusActor->SetVisibility(true);
   this->TextActor->SetVisibility(true);
 }
@@ -669,16 +964,72 @@ void vtkSlicerShapeRepresentation3D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
     return;
   }
   
-  if (!shapeNode->GetDisplayCappedTube())
-  {
-    this->ShapeMapper->SetInputConnection(this->Tube->GetOutputPort());
+  this->SplineActor->SetVisibility(shapeNode->GetSplineVisibility());
+  
+  const bool firstView = (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()));
+  if (shapeNode->ValidateCachedGeometry())
+  {
+    // Geometry read from the storage node's sidecar file still matches the control points.
+    this->CachedTubeProducer->SetOutput(shapeNode->GetCachedTubeWorld());
+    this->CachedCappedTubeProducer->SetOutput(shapeNode->GetCachedCappedTubeWorld());
+    this->CachedSplineProducer->SetOutput(shapeNode->GetCachedSplineWorld());
+    this->ShapeMapper->SetInputConnection(shapeNode->GetDisplayCappedTube()
+      ? this->CachedCappedTubeProducer->GetOutputPort() : this->CachedTubeProducer->GetOutputPort());
+    this->SplineMapper->SetInputConnection(this->CachedSplineProducer->GetOutputPort());
+    if (firstView)
+    {
+      shapeNode->SetShapeWorld(shapeNode->GetCachedTubeWorld());
+      shapeNode->SetCappedTubeWorld(shapeNode->GetCachedCappedTubeWorld());
+      shapeNode->SetSplineWorld(shapeNode->GetCachedSplineWorld());
+    }
   }
   else
   {
-    this->ShapeMapper->SetInputConnection(this->CappedTube->GetOutputPort());
+    if (!shapeNode->GetDisplayCappedTube())
+    {
+      this->ShapeMapper->SetInputConnection(this->Tube->GetOutputPort());
+    }
+    else
+    {
+      this->ShapeMapper->SetInputConnection(this->CappedTube->GetOutputPort());
+    }
+    this->SplineMapper->SetInputConnection(this->SplineSampler->GetOutputPort());
+    this->GenerateTube(shapeNode);
+    if (firstView)
+    {
+      shapeNode->SetShapeWorld(this->Tube->GetOutput());
+      shapeNode->SetCappedTubeWorld(this->CappedTube->GetOutput());
+      shapeNode->SetSplineWorld(this->SplineFunctionSource->GetOutput());
+      // Regenerated : the cached geometry is stale from now on.
+      shapeNode->ClearCachedGeometry();
+    }
   }
-  this->SplineActor->SetVisibility(shapeNode->GetSplineVisibility());
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  
+  int controlPointType = this->GetAllControlPointsSelected() ? Selected : Unselected;
+  this->ShapeActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
+  this->TextActor->SetTextProperty(this->GetControlPointsPipeline(controlPointType)->TextProperty);
+  
+  double opacity = this->MarkupsDisplayNode->GetOpacity();
+  double fillOpacity = opacity * this->MarkupsDisplayNode->GetFillOpacity();
+  this->ShapeProperty->DeepCopy(this->GetControlPointsPipeline(controlPointType)->Property);
+  this->ShapeProperty->SetOpacity(fillOpacity);
+  this->ShapeActor->SetProperty(this->ShapeProperty);
+  
+  double p1[3] = { 0.0 };
+  controlPointsWorld->GetPoint(0, p1);
+  this->TextActorPositionWorld[0] = p1[0];
+  this->TextActorPositionWorld[1] = p1[1];
+  this->TextActorPositionWorld[2] = p1[2];
+  this->TextActor->SetVisibility(true);
+
+  this->ShapeActor->SetVisibility(true);
+}
+
 
+//------------------------------------------------------------------------------
+void vtkSlicerShapeRepresentation3D::GenerateTube(vtkMRMLMarkupsShapeNode * shapeNode)
+{
   int numberOfPairedControlPoints = (shapeNode->GetNumberOfControlPoints() % 2)
                             ? shapeNode->GetNumberOfControlPoints() - 1
                             : shapeNode->GetNumberOfControlPoints();
@@ -688,6 +1039,7 @@ void vtkSlicerShapeRepresentation3D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
   interpolatedRadius->SetInterpolationTypeToLinear();
   interpolatedRadius->SetNumberOfComponents(1);
   int interpolatorIndex = 0;
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
 
   // This is not the number of pairs.
   for (int i = 0; i < numberOfPairedControlPoints; i = i + 2)
@@ -695,8 +1047,8 @@ void vtkSlicerShapeRepresentation3D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
     double middlePoint[3] = { 0.0 };
     double p1[3] = { 0.0 };
     double p2[3] = { 0.0 };
-    shapeNode->GetNthControlPointPositionWorld(i, p1);
-    shapeNode->GetNthControlPointPositionWorld(i + 1, p2);
+    controlPointsWorld->GetPoint(i, p1);
+    controlPointsWorld->GetPoint(i + 1, p2);
     middlePoint[0] = (p1[0] + p2[0]) / 2.0;
     middlePoint[1] = (p1[1] + p2[1]) / 2.0;
     middlePoint[2] = (p1[2] + p2[2]) / 2.0;
@@ -714,7 +1066,7 @@ void vtkSlicerShapeRepresentation3D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
   this->SplineFunctionSource->SetUResolution(splineResolution * numberOfIntervals);
   this->SplineFunctionSource->SetVResolution(splineResolution * numberOfIntervals);
   this->SplineFunctionSource->SetWResolution(splineResolution * numberOfIntervals);
-  this->SplineFunctionSource->Update();
+  this->UpdateTimed(this->SplineFunctionSource, "Spline");
   vtkPolyData * splinePolyData = this->SplineFunctionSource->GetOutput();
   int numberOfPoints = splinePolyData->GetNumberOfPoints();
   
@@ -734,40 +1086,19 @@ void vtkSlicerShapeRepresentation3D::UpdateTubeFromMRML(vtkMRMLNode* caller, uns
   
   splinePolyData->GetPointData()->AddArray(tubeRadius);
   splinePolyData->GetPointData()->SetActiveScalars("TubeRadius");
+  // The radius array was added after the source executed; resample explicitly.
+  this->SplineSampler->SetTolerance(shapeNode->GetSplineTolerance());
+  this->SplineSampler->Modified();
+  this->UpdateTimed(this->SplineSampler, "SplineSampling");
   
   this->Tube->SetNumberOfSides(shapeNode->GetResolution());
-  this->Tube->Update();
+  this->Tube->SetChordError(shapeNode->GetTubeChordError());
+  this->UpdateTimed(this->Tube, "Tube");
   this->CappedTube->SetNumberOfSides(shapeNode->GetResolution());
-  this->CappedTube->Update();
-  
-  if (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
-  {
-    shapeNode->SetShapeWorld(this->Tube->GetOutput());
-    shapeNode->SetCappedTubeWorld(this->CappedTube->GetOutput());
-    shapeNode->SetSplineWorld(this->SplineFunctionSource->GetOutput());
-  }
-  
-  int controlPointType = this->GetAllControlPointsSelected() ? Selected : Unselected;
-  this->ShapeActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
-  this->TextActor->SetTextProperty(this->GetControlPointsPipeline(controlPointType)->TextProperty);
-  
-  double opacity = this->MarkupsDisplayNode->GetOpacity();
-  double fillOpacity = opacity * this->MarkupsDisplayNode->GetFillOpacity();
-  this->ShapeProperty->DeepCopy(this->GetControlPointsPipeline(controlPointType)->Property);
-  this->ShapeProperty->SetOpacity(fillOpacity);
-  this->ShapeActor->SetProperty(this->ShapeProperty);
-  
-  double p1[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  this->TextActorPositionWorld[0] = p1[0];
-  this->TextActorPositionWorld[1] = p1[1];
-  this->TextActorPositionWorld[2] = p1[2];
-  this->TextActor->SetVisibility(true);
-
-  this->ShapeActor->SetVisibility(true);
+  this->CappedTube->SetChordError(shapeNode->GetTubeChordError());
+  this->UpdateTimed(this->CappedTube, "CappedTube");
 }
 
-
 //---------------------------- Cone -------------------------------------------
 void vtkSlicerShapeRepresentation3D::UpdateConeFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData)
 {
@@ -786,9 +1117,10 @@ void vtkSlicerShapeRepresentation3D::UpdateConeFromMRML(vtkMRMLNode* caller, uns
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
-  shapeNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   
   this->ShapeMapper->SetInputConnection(this->ConeSource->GetOutputPort());
   
@@ -804,16 +1136,21 @@ void vtkSlicerShapeRepresentation3D::UpdateConeFromMRML(vtkMRMLNode* caller, uns
   
   double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
   
-  this->ConeSource->SetCenter(center);
-  this->ConeSource->SetRadius(radius);
-  this->ConeSource->SetHeight(height);
-  this->ConeSource->SetDirection(direction);
+  const double scale[3] = { height, radius, radius };
+  const double xAxis[3] = { 1.0, 0.0, 0.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, center, xAxis, direction, scale))
+  {
+    vtkDebugMacro("Degenerate cone.");
+    return;
+  }
   this->ConeSource->SetResolution(shapeNode->GetResolution());
   this->ConeSource->Update();
+  this->ShapeActor->SetUserTransform(this->PrimitiveTransform);
   
   if (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
   {
-    shapeNode->SetShapeWorld(this->ConeSource->GetOutput());
+    this->PrimitiveTransformer->SetInputConnection(this->ConeSource->GetOutputPort());
+    shapeNode->SetShapeWorldProducer(this->PrimitiveTransformer);
   }
   
   bool visibility = shapeNode->GetNumberOfDefinedControlPoints(true) == shapeNode->GetRequiredNumberOfControlPoints();
@@ -830,26 +1167,13 @@ void vtkSlicerShapeRepresentation3D::UpdateConeFromMRML(vtkMRMLNode* caller, uns
   this->ShapeProperty->SetOpacity(fillOpacity);
   this->ShapeActor->SetProperty(this->ShapeProperty);
   
-  // Stick p2 on rim : place a sphere at the base, cut it and find point.
+  // Stick p2 on rim : the closest point on the base circle.
   this->DoUpdateFromMRML = false;
-  vtkNew<vtkSphereSource> baseSphere;
-  baseSphere->SetCenter(p1);
-  baseSphere->SetRadius(radius);
-  baseSphere->SetPhiResolution(360);
-  baseSphere->SetThetaResolution(360);
-  baseSphere->Update();
-  vtkNew<vtkPlane> basePlane;
-  basePlane->SetOrigin(p1);
-  basePlane->SetNormal(direction);
-  vtkNew<vtkCutter> baseCutter;
-  baseCutter->SetInputConnection(baseSphere->GetOutputPort());
-  baseCutter->SetCutFunction(basePlane);
-  baseCutter->Update();
-  vtkIdType closestIdOnRim = baseCutter->GetOutput()->FindPoint(p2);
-  if (closestIdOnRim >= 0)
-  {
-    double * closestPointOnRim = baseCutter->GetOutput()->GetPoint(closestIdOnRim);
-    if (p2[0] != closestPointOnRim[0] || p2[1] != closestPointOnRim[1] || p2[2] != closestPointOnRim[2])
+  double closestPointOnRim[3] = { 0.0 };
+  if (vtkSlicerShapePlacement::GetClosestPointOnCircle(p1, direction, radius, p2, closestPointOnRim))
+  {
+    // Tolerate rounding, lest views snap the point back and forth.
+    if (vtkMath::Distance2BetweenPoints(p2, closestPointOnRim) > 1e-12 * radius * radius)
     {
       if (shapeNode->GetNumberOfDefinedControlPoints() == shapeNode->GetRequiredNumberOfControlPoints() && shapeNode->GetModifiedSinceRead())
       {
@@ -885,24 +1209,32 @@ void vtkSlicerShapeRepresentation3D::UpdateCylinderFromMRML(vtkMRMLNode* caller,
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
-  shapeNode->GetNthControlPointPositionWorld(2, p3);
-  
-  this->CylinderAxis->SetPoint1(p1);
-  this->CylinderAxis->SetPoint2(p3);
-  this->CylinderAxis->Update();
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   
   this->ShapeMapper->SetInputConnection(this->CylinderSource->GetOutputPort());
   
   double radius = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
-  this->CylinderSource->SetRadius(radius);
-  this->CylinderSource->SetNumberOfSides(shapeNode->GetResolution());
+  double height = std::sqrt(vtkMath::Distance2BetweenPoints(p1, p3));
+  double direction[3] = { 0.0 };
+  vtkMath::Subtract(p3, p1, direction); // Points towards p3
+  const double scale[3] = { height, radius, radius };
+  const double xAxis[3] = { 1.0, 0.0, 0.0 };
+  if (!vtkSlicerShapePlacement::Place(this->PrimitiveTransform, p1, xAxis, direction, scale))
+  {
+    vtkDebugMacro("Degenerate cylinder.");
+    return;
+  }
+  this->CylinderSource->SetResolution(shapeNode->GetResolution());
   this->CylinderSource->Update();
+  this->ShapeActor->SetUserTransform(this->PrimitiveTransform);
   
   if (this->GetViewNode() == this->GetFirstViewNode(shapeNode->GetScene()))
   {
-    shapeNode->SetShapeWorld(this->CylinderSource->GetOutput());
+    this->PrimitiveTransformer->SetInputConnection(this->CylinderSource->GetOutputPort());
+    shapeNode->SetShapeWorldProducer(this->PrimitiveTransformer);
   }
   
   bool visibility = shapeNode->GetNumberOfDefinedControlPoints(true) == shapeNode->GetRequiredNumberOfControlPoints();
@@ -919,28 +1251,13 @@ void vtkSlicerShapeRepresentation3D::UpdateCylinderFromMRML(vtkMRMLNode* caller,
   this->ShapeProperty->SetOpacity(fillOpacity);
   this->ShapeActor->SetProperty(this->ShapeProperty);
   
-  // Stick p2 on rim : place a sphere at the base, cut it and find point.
+  // Stick p2 on rim : the closest point on the base circle.
   this->DoUpdateFromMRML = false;
-  double direction[3] = { 0.0 };
-  vtkMath::Subtract(p3, p1, direction); // Points towards p3
-  vtkNew<vtkSphereSource> baseSphere;
-  baseSphere->SetCenter(p1);
-  baseSphere->SetRadius(radius);
-  baseSphere->SetPhiResolution(360);
-  baseSphere->SetThetaResolution(360);
-  baseSphere->Update();
-  vtkNew<vtkPlane> basePlane;
-  basePlane->SetOrigin(p1);
-  basePlane->SetNormal(direction);
-  vtkNew<vtkCutter> baseCutter;
-  baseCutter->SetInputConnection(baseSphere->GetOutputPort());
-  baseCutter->SetCutFunction(basePlane);
-  baseCutter->Update();
-  vtkIdType closestIdOnRim = baseCutter->GetOutput()->FindPoint(p2);
-  if (closestIdOnRim >= 0)
-  {
-    double * closestPointOnRim = baseCutter->GetOutput()->GetPoint(closestIdOnRim);
-    if (p2[0] != closestPointOnRim[0] || p2[1] != closestPointOnRim[1] || p2[2] != closestPointOnRim[2])
+  double closestPointOnRim[3] = { 0.0 };
+  if (vtkSlicerShapePlacement::GetClosestPointOnCircle(p1, direction, radius, p2, closestPointOnRim))
+  {
+    // Tolerate rounding, lest views snap the point back and forth.
+    if (vtkMath::Distance2BetweenPoints(p2, closestPointOnRim) > 1e-12 * radius * radius)
     {
       if (shapeNode->GetNumberOfDefinedControlPoints() == shapeNode->GetRequiredNumberOfControlPoints() && shapeNode->GetModifiedSinceRead())
       {
@@ -982,9 +1299,10 @@ void vtkSlicerShapeRepresentation3D::UpdateArcFromMRML(vtkMRMLNode* caller, unsi
   double p1[3] = { 0.0 };
   double p2[3] = { 0.0 };
   double p3[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
-  shapeNode->GetNthControlPointPositionWorld(2, p3);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
   
   this->ShapeMapper->SetInputConnection(this->ArcSource->GetOutputPort());
   
@@ -1034,7 +1352,7 @@ void vtkSlicerShapeRepresentation3D::UpdateArcFromMRML(vtkMRMLNode* caller, unsi
     {
       this->DoUpdateFromMRML = false;
       shapeNode->SetNthControlPointPositionWorld(2, arcEndPoint);
-      shapeNode->GetNthControlPointPositionWorld(2, p3);
+      shapeNode->GetControlPointPositionsWorldBuffer()->GetPoint(2, p3);
       this->DoUpdateFromMRML = true;
     }
   }
@@ -1060,7 +1378,7 @@ void vtkSlicerShapeRepresentation3D::UpdateArcFromMRML(vtkMRMLNode* caller, unsi
     {
       this->DoUpdateFromMRML = false;
       shapeNode->SetNthControlPointPositionWorld(0, inPlaneCentreProjection);
-      shapeNode->GetNthControlPointPositionWorld(0, p1);
+      shapeNode->GetControlPointPositionsWorldBuffer()->GetPoint(0, p1);
       this->DoUpdateFromMRML = true;
     }
   }
@@ -1096,45 +1414,11 @@ void vtkSlicerShapeRepresentation3D::UpdateParametricFromMRML(vtkMRMLNode* calle
   {
     return;
   }
-  // Set the respective parametric function in the function source.
-  switch (shapeNode->GetShapeName())
+  // The function of the node's shape is set once, in BuildShapePipeline().
+  if (!this->ParametricFunctionSource || !this->ParametricFunctionSource->GetParametricFunction())
   {
-    case vtkMRMLMarkupsShapeNode::Ellipsoid:
-      this->ParametricFunctionSource->SetParametricFunction(this->Ellipsoid);
-      break;
-    case vtkMRMLMarkupsShapeNode::Toroid:
-      this->ParametricFunctionSource->SetParametricFunction(this->Toroid);
-      break;
-    case vtkMRMLMarkupsShapeNode::BohemianDome:
-      this->ParametricFunctionSource->SetParametricFunction(this->BohemianDome);
-      break;
-    case vtkMRMLMarkupsShapeNode::Bour:
-      this->ParametricFunctionSource->SetParametricFunction(this->Bour);
-      break;
-    case vtkMRMLMarkupsShapeNode::Boy:
-      this->ParametricFunctionSource->SetParametricFunction(this->Boy);
-      break;
-    case vtkMRMLMarkupsShapeNode::CrossCap:
-      this->ParametricFunctionSource->SetParametricFunction(this->CrossCap);
-      break;
-    case vtkMRMLMarkupsShapeNode::ConicSpiral:
-      this->ParametricFunctionSource->SetParametricFunction(this->ConicSpiral);
-      break;
-    case vtkMRMLMarkupsShapeNode::Kuen:
-      this->ParametricFunctionSource->SetParametricFunction(this->Kuen);
-      break;
-    case vtkMRMLMarkupsShapeNode::Mobius:
-      this->ParametricFunctionSource->SetParametricFunction(this->Mobius);
-      break;
-    case vtkMRMLMarkupsShapeNode::PluckerConoid:
-      this->ParametricFunctionSource->SetParametricFunction(this->PluckerConoid);
-      break;
-    case vtkMRMLMarkupsShapeNode::Roman:
-      this->ParametricFunctionSource->SetParametricFunction(this->Roman);
-      break;
-    default:
-      vtkErrorMacro("Unfit shape.");
-      return;
+    vtkErrorMacro("Unfit shape.");
+    return;
   }
     
   if (shapeNode->GetNumberOfDefinedControlPoints(true) != shapeNode->GetRequiredNumberOfControlPoints())
@@ -1150,10 +1434,11 @@ void vtkSlicerShapeRepresentation3D::UpdateParametricFromMRML(vtkMRMLNode* calle
   double p4[3] = { 0.0 };
   double direction[3] = { 0.0 }; // p4, centre
   double center[3] = { 0.0 };
-  shapeNode->GetNthControlPointPositionWorld(0, p1);
-  shapeNode->GetNthControlPointPositionWorld(1, p2);
-  shapeNode->GetNthControlPointPositionWorld(2, p3);
-  shapeNode->GetNthControlPointPositionWorld(3, p4);
+  vtkPoints * controlPointsWorld = shapeNode->GetControlPointPositionsWorldBuffer();
+  controlPointsWorld->GetPoint(0, p1);
+  controlPointsWorld->GetPoint(1, p2);
+  controlPointsWorld->GetPoint(2, p3);
+  controlPointsWorld->GetPoint(3, p4);
   
   if (shapeNode->GetRadiusMode() == vtkMRMLMarkupsShapeNode::Centered)
   {
@@ -25,13 +25,18 @@
 
 // Markups VTKWidgets includes
 #include "vtkSlicerMarkupsWidgetRepresentation3D.h"
+#include "vtkSlicerAdaptiveSplineSampler.h"
+#include "vtkSlicerAdaptiveTubeFilter.h"
+#include "vtkSlicerCylinderSource.h"
 
 // VTK includes
+#include <vtkCallbackCommand.h>
 #include <vtkWeakPointer.h>
 #include <vtkDiskSource.h>
 #include <vtkLineSource.h>
 #include <vtkSphereSource.h>
 #include <vtkTubeFilter.h>
+#include <vtkTrivialProducer.h>
 #include <vtkParametricSpline.h>
 #include <vtkParametricSuperEllipsoid.h>
 #include <vtkParametricSuperToroid.h>
@@ -54,6 +59,8 @@
 //------------------------------------------------------------------------------
 class vtkCutter;
 class vtkPlane;
+class vtkMRMLMarkupsShapeNode;
+class vtkSlicerShapeInstancer;
 
 /**
  * @class   vtkSlicerShapeRepresentation3D
@@ -83,6 +90,9 @@ public:
   int RenderOpaqueGeometry(vtkViewport* viewport) override;
   int RenderTranslucentPolygonalGeometry(vtkViewport* viewport) override;
   vtkTypeBool HasTranslucentPolygonalGeometry() override;
+  
+  /// Memory held by the outputs of the current shape pipeline, in kibibytes.
+  unsigned long GetPipelineMemorySize();
 
 protected:
   vtkSlicerShapeRepresentation3D();
@@ -92,6 +102,13 @@ protected:
   vtkSmartPointer<vtkActor> MiddlePointActor;
   vtkSmartPointer<vtkSphereSource> MiddlePointSource;
   void BuildMiddlePoint();
+  // Update an algorithm, timed as a phase of the node; see vtkMRMLMarkupsProfiler.
+  void UpdateTimed(vtkAlgorithm * algorithm, const char * phase);
+  
+  // Set in the node while it is hidden; see vtkMRMLMarkupsShapeNode::SetDeferredGeometryCommand().
+  vtkSmartPointer<vtkCallbackCommand> DeferredGeometryCallback;
+  static void OnDeferredGeometryRequested(vtkObject * caller, unsigned long event, void * clientData, void * callData);
+  bool GeometryRequested = false;
   
   vtkSmartPointer<vtkPolyDataMapper> ParametricMiddlePointMapper;
   vtkSmartPointer<vtkActor> ParametricMiddlePointActor;
@@ -101,8 +118,11 @@ protected:
   vtkSmartPointer<vtkDiskSource> RingSource;
   vtkSmartPointer<vtkSphereSource> SphereSource;
   vtkSmartPointer<vtkConeSource> ConeSource;
-  vtkSmartPointer<vtkTubeFilter> CylinderSource; // Regular tube.
-  vtkSmartPointer<vtkLineSource> CylinderAxis;
+  vtkSmartPointer<vtkSlicerCylinderSource> CylinderSource;
+  // The above are built once in unit size at the origin and placed with this transform.
+  vtkSmartPointer<vtkTransform> PrimitiveTransform;
+  // Produces the world copy on demand, see vtkMRMLMarkupsShapeNode::GetShapeWorld().
+  vtkSmartPointer<vtkTransformPolyDataFilter> PrimitiveTransformer;
   vtkSmartPointer<vtkArcSource> ArcSource;
   
   vtkSmartPointer<vtkLineSource> RadiusSource;
@@ -111,10 +131,17 @@ protected:
   
   vtkSmartPointer<vtkParametricSpline> Spline;
   vtkSmartPointer<vtkParametricFunctionSource> SplineFunctionSource;
+  vtkSmartPointer<vtkSlicerAdaptiveSplineSampler> SplineSampler;
   vtkSmartPointer<vtkPolyDataMapper> SplineMapper;
   vtkSmartPointer<vtkActor> SplineActor;
-  vtkSmartPointer<vtkTubeFilter> Tube; // Variable radius tube.
-  vtkSmartPointer<vtkTubeFilter> CappedTube;
+  vtkSmartPointer<vtkSlicerAdaptiveTubeFilter> Tube; // Variable radius tube.
+  vtkSmartPointer<vtkSlicerAdaptiveTubeFilter> CappedTube;
+  // Serve the node's cached geometry instead of the above; see vtkMRMLMarkupsShapeNode::ValidateCachedGeometry().
+  vtkSmartPointer<vtkTrivialProducer> CachedTubeProducer;
+  vtkSmartPointer<vtkTrivialProducer> CachedCappedTubeProducer;
+  vtkSmartPointer<vtkTrivialProducer> CachedSplineProducer;
+  // Build the spline and both tubes from the control points.
+  void GenerateTube(vtkMRMLMarkupsShapeNode * shapeNode);
   
   vtkSmartPointer<vtkParametricSuperEllipsoid> Ellipsoid;
   vtkSmartPointer<vtkParametricSuperToroid> Toroid;
@@ -146,6 +173,17 @@ protected:
   
   // Set shape, spline and closed tube pointers in markups node from the first view only.
   vtkObject * GetFirstViewNode(vtkMRMLScene * scene) const;
+  
+  // Only the sources of the node's current shape are built; see UpdateFromMRML().
+  void BuildShapePipeline(vtkMRMLMarkupsShapeNode * shapeNode);
+  void ReleaseShapePipeline(vtkMRMLMarkupsShapeNode * shapeNode);
+  int PipelineShapeName = -1;
+  
+  // Spheres may be drawn by a vtkSlicerShapeInstancer shared by the renderer.
+  vtkSlicerShapeInstancer * GetShapeInstancer() const;
+  void RemoveShapeInstance();
+  vtkWeakPointer<vtkRenderer> InstancedRenderer;
+  bool ShapeInstanced = false;
 
 private:
   vtkSlicerShapeRepresentation3D(const vtkSlicerShapeRepresentation3D&) = delete;
@@ -33,6 +33,17 @@
 #include <QAction>
 #include <QWidgetAction>
 #include <QSpinBox>
+#include <QTimer>
+#include <QMap>
+#include <QSignalBlocker>
+#include <QToolButton>
+
+// CTK includes
+#include <ctkSliderWidget.h>
+#include <ctkRangeWidget.h>
+
+// STD includes
+#include <algorithm>
 
 // --------------------------------------------------------------------------
 class qMRMLMarkupsShapeWidgetPrivate:
@@ -51,6 +62,60 @@ public:
   vtkWeakPointer<vtkMRMLMarkupsShapeNode> MarkupsShapeNode;
   QMenu * TubeOptionMenu = nullptr;
 
+  // Slider values waiting to be pushed to the node, keyed by PendingParameter.
+  QMap<int, double> PendingParameters;
+  QTimer * UpdateTimer = nullptr;
+
+  // Parameters as last shown by the controls.
+  struct ParameterSnapshot
+  {
+    int ShapeName = -1;
+    int RadiusMode = -1;
+    int DrawMode2D = -1;
+    double Resolution = 0.0;
+    vtkMRMLNode * ResliceNode = nullptr;
+    bool ScalarVisibility = false;
+
+    int ParametricScalarMode = -1;
+    double ParametricN = 0.0;
+    double ParametricN1 = 0.0;
+    double ParametricN2 = 0.0;
+    double ParametricRadius = 0.0;
+    double ParametricRingRadius = 0.0;
+    double ParametricCrossSectionRadius = 0.0;
+    std::pair<double, double> ParametricRangeU = {0.0, 0.0};
+    std::pair<double, double> ParametricRangeV = {0.0, 0.0};
+    std::pair<double, double> ParametricRangeW = {0.0, 0.0};
+    double ParametricMinimumU = 0.0;
+    double ParametricMaximumU = 0.0;
+    double ParametricMinimumV = 0.0;
+    double ParametricMaximumV = 0.0;
+    double ParametricMinimumW = 0.0;
+    double ParametricMaximumW = 0.0;
+    bool ParametricClockwiseOrdering = false;
+    bool ParametricJoinU = false;
+    bool ParametricJoinV = false;
+    bool ParametricJoinW = false;
+    bool ParametricTwistU = false;
+    bool ParametricTwistV = false;
+    bool ParametricTwistW = false;
+  };
+  ParameterSnapshot Snapshot;
+  // False until the controls are filled for the current node.
+  bool SnapshotValid = false;
+
+  void takeSnapshot(ParameterSnapshot& snapshot) const;
+  void updateSlider(ctkSliderWidget * slider, int parameter,
+                    double value, double& lastValue, bool force);
+  void updateRangeWidget(ctkRangeWidget * rangeWidget,
+                         int minimumParameter, int maximumParameter,
+                         const std::pair<double, double>& range,
+                         double minimumValue, double maximumValue,
+                         std::pair<double, double>& lastRange,
+                         double& lastMinimumValue, double& lastMaximumValue,
+                         bool force);
+  void updateToolButton(QToolButton * button, bool value, bool& lastValue, bool force);
+
   enum TubeMenuAction
   {
     ActionCapTube = 0,
@@ -58,6 +123,26 @@ public:
     ActionSplineVisibility,
     ActionSnapControlPoints
   };
+
+  enum PendingParameter
+  {
+    Resolution = 0,
+    SplineResolution,
+    SplineTolerance,
+    TubeChordError,
+    ParametricN,
+    ParametricN1,
+    ParametricN2,
+    ParametricRadius,
+    ParametricRingRadius,
+    ParametricCrossSectionRadius,
+    ParametricMinimumU,
+    ParametricMaximumU,
+    ParametricMinimumV,
+    ParametricMaximumV,
+    ParametricMinimumW,
+    ParametricMaximumW
+  };
 };
 
 // --------------------------------------------------------------------------
@@ -143,6 +228,13 @@ void qMRMLMarkupsShapeWidgetPrivate::setupUi(qMRMLMarkupsShapeWidget* widget)
   this->parametricsMainCollapsibleButton->setVisible(false);
   this->parametricsMoreCollapsibleButton->setCollapsed(true);
 
+  // Roughly one node update per rendered frame while dragging.
+  this->UpdateTimer = new QTimer(widget);
+  this->UpdateTimer->setSingleShot(true);
+  this->UpdateTimer->setInterval(33);
+  QObject::connect(this->UpdateTimer, SIGNAL(timeout()),
+                   q, SLOT(applyPendingParameters()));
+
   QObject::connect(this->shapeNameComboBox, SIGNAL(currentIndexChanged(int)),
                    q, SLOT(onShapeChanged(int)));
   QObject::connect(this->radiusModeComboBox, SIGNAL(currentIndexChanged(int)),
@@ -206,6 +298,28 @@ void qMRMLMarkupsShapeWidgetPrivate::setupUi(qMRMLMarkupsShapeWidget* widget)
                    q, SLOT(onParametricsTwistWToogled(bool)));
   QObject::connect(this->parametricsClockwiseOrderingToolButton, SIGNAL(clicked(bool)),
                    q, SLOT(onParametricsClockwiseOrderingToogled(bool)));
+
+  // Don't wait for the timer when the user lets go of a slider.
+  QObject::connect(this->resolutionSliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricNSliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricN1SliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricN2SliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricRadiusSliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricRingRadiusSliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricCrossSectionRadiusSliderWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricsURangeWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricsVRangeWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
+  QObject::connect(this->parametricsWRangeWidget->slider(), SIGNAL(sliderReleased()),
+                   q, SLOT(applyPendingParameters()));
 }
 
 // --------------------------------------------------------------------------
@@ -227,6 +341,218 @@ void qMRMLMarkupsShapeWidget::setup()
   Q_D(qMRMLMarkupsShapeWidget);
   d->setupUi(this);
 }
+
+// --------------------------------------------------------------------------
+int qMRMLMarkupsShapeWidget::updateInterval() const
+{
+  Q_D(const qMRMLMarkupsShapeWidget);
+  return d->UpdateTimer->interval();
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidget::setUpdateInterval(int msec)
+{
+  Q_D(qMRMLMarkupsShapeWidget);
+  d->UpdateTimer->setInterval(std::max(msec, 0));
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidget::queueParameter(int parameter, double value)
+{
+  Q_D(qMRMLMarkupsShapeWidget);
+
+  d->PendingParameters[parameter] = value;
+  if (d->UpdateTimer->interval() == 0)
+  {
+    this->applyPendingParameters();
+    return;
+  }
+  // Don't restart a running timer: updates keep flowing during a long drag.
+  if (!d->UpdateTimer->isActive())
+  {
+    d->UpdateTimer->start();
+  }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidget::applyPendingParameters()
+{
+  Q_D(qMRMLMarkupsShapeWidget);
+
+  d->UpdateTimer->stop();
+  if (d->PendingParameters.isEmpty())
+  {
+    return;
+  }
+  QMap<int, double> parameters;
+  parameters.swap(d->PendingParameters);
+  if (!d->MarkupsShapeNode)
+  {
+    return;
+  }
+
+  // A single Modified() for all values collected since the last update.
+  MRMLNodeModifyBlocker blocker(d->MarkupsShapeNode);
+  vtkMRMLMarkupsShapeNode * shapeNode = d->MarkupsShapeNode;
+  QMap<int, double>::const_iterator it = parameters.constBegin();
+  for (; it != parameters.constEnd(); ++it)
+  {
+    const double value = it.value();
+    switch (it.key())
+    {
+      case qMRMLMarkupsShapeWidgetPrivate::Resolution:
+        shapeNode->SetResolution(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::SplineResolution:
+        shapeNode->SetSplineResolution((int) value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::SplineTolerance:
+        shapeNode->SetSplineTolerance(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::TubeChordError:
+        shapeNode->SetTubeChordError(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricN:
+        shapeNode->SetParametricN(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricN1:
+        shapeNode->SetParametricN1(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricN2:
+        shapeNode->SetParametricN2(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricRadius:
+        shapeNode->SetParametricRadius(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricRingRadius:
+        shapeNode->SetParametricRingRadius(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricCrossSectionRadius:
+        shapeNode->SetParametricCrossSectionRadius(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumU:
+        shapeNode->SetParametricMinimumU(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumU:
+        shapeNode->SetParametricMaximumU(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumV:
+        shapeNode->SetParametricMinimumV(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumV:
+        shapeNode->SetParametricMaximumV(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumW:
+        shapeNode->SetParametricMinimumW(value);
+        break;
+      case qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumW:
+        shapeNode->SetParametricMaximumW(value);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidgetPrivate::takeSnapshot(ParameterSnapshot& snapshot) const
+{
+  vtkMRMLMarkupsShapeNode * shapeNode = this->MarkupsShapeNode;
+  snapshot.ShapeName = shapeNode->GetShapeName();
+  snapshot.RadiusMode = shapeNode->GetRadiusMode();
+  snapshot.DrawMode2D = shapeNode->GetDrawMode2D();
+  snapshot.Resolution = shapeNode->GetResolution();
+  snapshot.ResliceNode = shapeNode->GetResliceNode();
+  snapshot.ScalarVisibility = shapeNode->GetScalarVisibility();
+  if (!shapeNode->IsParametric())
+  {
+    // Leave the parametric controls as they are.
+    return;
+  }
+  snapshot.ParametricScalarMode = shapeNode->GetParametricScalarMode();
+  snapshot.ParametricN = shapeNode->GetParametricN();
+  snapshot.ParametricN1 = shapeNode->GetParametricN1();
+  snapshot.ParametricN2 = shapeNode->GetParametricN2();
+  snapshot.ParametricRadius = shapeNode->GetParametricRadius();
+  snapshot.ParametricRingRadius = shapeNode->GetParametricRingRadius();
+  snapshot.ParametricCrossSectionRadius = shapeNode->GetParametricCrossSectionRadius();
+  snapshot.ParametricRangeU = shapeNode->GetParametricRangeU();
+  snapshot.ParametricRangeV = shapeNode->GetParametricRangeV();
+  snapshot.ParametricRangeW = shapeNode->GetParametricRangeW();
+  snapshot.ParametricMinimumU = shapeNode->GetParametricMinimumU();
+  snapshot.ParametricMaximumU = shapeNode->GetParametricMaximumU();
+  snapshot.ParametricMinimumV = shapeNode->GetParametricMinimumV();
+  snapshot.ParametricMaximumV = shapeNode->GetParametricMaximumV();
+  snapshot.ParametricMinimumW = shapeNode->GetParametricMinimumW();
+  snapshot.ParametricMaximumW = shapeNode->GetParametricMaximumW();
+  snapshot.ParametricClockwiseOrdering = shapeNode->GetParametricClockwiseOrdering();
+  snapshot.ParametricJoinU = shapeNode->GetParametricJoinU();
+  snapshot.ParametricJoinV = shapeNode->GetParametricJoinV();
+  snapshot.ParametricJoinW = shapeNode->GetParametricJoinW();
+  snapshot.ParametricTwistU = shapeNode->GetParametricTwistU();
+  snapshot.ParametricTwistV = shapeNode->GetParametricTwistV();
+  snapshot.ParametricTwistW = shapeNode->GetParametricTwistW();
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidgetPrivate::updateSlider(ctkSliderWidget * slider, int parameter,
+                                                  double value, double& lastValue, bool force)
+{
+  // A value waiting in the coalescing queue is newer than the node's one.
+  if (this->PendingParameters.contains(parameter)
+    || (!force && value == lastValue))
+  {
+    return;
+  }
+  QSignalBlocker blocker(slider);
+  slider->setValue(value);
+  lastValue = value;
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidgetPrivate::updateRangeWidget(ctkRangeWidget * rangeWidget,
+                                                       int minimumParameter, int maximumParameter,
+                                                       const std::pair<double, double>& range,
+                                                       double minimumValue, double maximumValue,
+                                                       std::pair<double, double>& lastRange,
+                                                       double& lastMinimumValue, double& lastMaximumValue,
+                                                       bool force)
+{
+  if (this->PendingParameters.contains(minimumParameter)
+    || this->PendingParameters.contains(maximumParameter))
+  {
+    return;
+  }
+  if (!force && range == lastRange
+    && minimumValue == lastMinimumValue && maximumValue == lastMaximumValue)
+  {
+    return;
+  }
+  QSignalBlocker blocker(rangeWidget);
+  // Set the range for the current shape, then the current values.
+  if (force || range != lastRange)
+  {
+    rangeWidget->setRange(range.first, range.second);
+  }
+  rangeWidget->setValues(minimumValue, maximumValue);
+  lastRange = range;
+  lastMinimumValue = minimumValue;
+  lastMaximumValue = maximumValue;
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidgetPrivate::updateToolButton(QToolButton * button, bool value,
+                                                      bool& lastValue, bool force)
+{
+  if (!force && value == lastValue)
+  {
+    return;
+  }
+  QSignalBlocker blocker(button);
+  button->setChecked(value);
+  lastValue = value;
+}
+
 // --------------------------------------------------------------------------
 void qMRMLMarkupsShapeWidget::updateWidgetFromMRML()
 {
@@ -235,64 +561,114 @@ void qMRMLMarkupsShapeWidget::updateWidgetFromMRML()
   if (!this->canManageMRMLMarkupsNode(d->MarkupsShapeNode))
     {
     d->shapeCollapsibleButton->setVisible(false);
+    d->SnapshotValid = false;
     return;
     }
 
   d->shapeCollapsibleButton->setVisible(true);
 
-  d->shapeNameComboBox->setCurrentIndex( d->MarkupsShapeNode->GetShapeName());
-  d->radiusModeComboBox->setCurrentIndex(d->MarkupsShapeNode->GetRadiusMode());
-  d->drawModeComboBox->setCurrentIndex(d->MarkupsShapeNode->GetDrawMode2D());
-  d->resolutionSliderWidget->setValue(d->MarkupsShapeNode->GetResolution());
-  d->resliceInputSelector->setCurrentNode(d->MarkupsShapeNode->GetResliceNode());
+  /*
+   * This is called on every node modification, including each control point
+   * move during a drag. Compare the displayed parameters with the last state
+   * and only touch the controls that differ, with their signals blocked.
+   * Moving control points does not change any of them, so nothing is done.
+   */
+  const bool force = !d->SnapshotValid;
+  qMRMLMarkupsShapeWidgetPrivate::ParameterSnapshot current = d->Snapshot;
+  d->takeSnapshot(current);
+  qMRMLMarkupsShapeWidgetPrivate::ParameterSnapshot& last = d->Snapshot;
+
+  const bool shapeChanged = force || current.ShapeName != last.ShapeName;
+  const bool radiusModeChanged = force || current.RadiusMode != last.RadiusMode;
+  if (shapeChanged)
+  {
+    QSignalBlocker blocker(d->shapeNameComboBox);
+    d->shapeNameComboBox->setCurrentIndex(current.ShapeName);
+  }
+  if (radiusModeChanged)
+  {
+    QSignalBlocker blocker(d->radiusModeComboBox);
+    d->radiusModeComboBox->setCurrentIndex(current.RadiusMode);
+  }
+  if (shapeChanged || radiusModeChanged)
+  {
+    this->updateShapeControlsVisibility();
+  }
+  if (force || current.DrawMode2D != last.DrawMode2D)
+  {
+    QSignalBlocker blocker(d->drawModeComboBox);
+    d->drawModeComboBox->setCurrentIndex(current.DrawMode2D);
+  }
+  if (force || current.ResliceNode != last.ResliceNode)
+  {
+    QSignalBlocker blocker(d->resliceInputSelector);
+    d->resliceInputSelector->setCurrentNode(current.ResliceNode);
+  }
   // Set tube checkable menu item status here.
   // d->displayCappedTubeToolButton->setChecked(d->MarkupsShapeNode->GetDisplayCappedTube());
-  d->parametricScalarVisibilityToolButton->setChecked(d->MarkupsShapeNode->GetScalarVisibility());
-  
+  if (force || current.ScalarVisibility != last.ScalarVisibility)
+  {
+    QSignalBlocker blocker(d->parametricScalarVisibilityToolButton);
+    d->parametricScalarVisibilityToolButton->setChecked(current.ScalarVisibility);
+  }
+  last.ShapeName = current.ShapeName;
+  last.RadiusMode = current.RadiusMode;
+  last.DrawMode2D = current.DrawMode2D;
+  last.ResliceNode = current.ResliceNode;
+  last.ScalarVisibility = current.ScalarVisibility;
+  d->updateSlider(d->resolutionSliderWidget, qMRMLMarkupsShapeWidgetPrivate::Resolution,
+                  current.Resolution, last.Resolution, force);
+  d->SnapshotValid = true;
+
   if (!d->MarkupsShapeNode->IsParametric())
   {
     return;
   }
-  
+
   // Object parameters.
-  d->parametricScalarModeComboBox->setCurrentIndex(d->parametricScalarModeComboBox->findData(d->MarkupsShapeNode->GetParametricScalarMode()));
-  d->parametricNSliderWidget->setValue(d->MarkupsShapeNode->GetParametricN());
-  d->parametricN1SliderWidget->setValue(d->MarkupsShapeNode->GetParametricN1());
-  d->parametricN2SliderWidget->setValue(d->MarkupsShapeNode->GetParametricN2());
-  d->parametricRadiusSliderWidget->setValue(d->MarkupsShapeNode->GetParametricRadius());
-  d->parametricRingRadiusSliderWidget->setValue(d->MarkupsShapeNode->GetParametricRingRadius());
-  d->parametricCrossSectionRadiusSliderWidget->setValue(d->MarkupsShapeNode->GetParametricCrossSectionRadius());
-  
+  if (force || current.ParametricScalarMode != last.ParametricScalarMode)
+  {
+    QSignalBlocker blocker(d->parametricScalarModeComboBox);
+    d->parametricScalarModeComboBox->setCurrentIndex(d->parametricScalarModeComboBox->findData(current.ParametricScalarMode));
+    last.ParametricScalarMode = current.ParametricScalarMode;
+  }
+  d->updateSlider(d->parametricNSliderWidget, qMRMLMarkupsShapeWidgetPrivate::ParametricN,
+                  current.ParametricN, last.ParametricN, force);
+  d->updateSlider(d->parametricN1SliderWidget, qMRMLMarkupsShapeWidgetPrivate::ParametricN1,
+                  current.ParametricN1, last.ParametricN1, force);
+  d->updateSlider(d->parametricN2SliderWidget, qMRMLMarkupsShapeWidgetPrivate::ParametricN2,
+                  current.ParametricN2, last.ParametricN2, force);
+  d->updateSlider(d->parametricRadiusSliderWidget, qMRMLMarkupsShapeWidgetPrivate::ParametricRadius,
+                  current.ParametricRadius, last.ParametricRadius, force);
+  d->updateSlider(d->parametricRingRadiusSliderWidget, qMRMLMarkupsShapeWidgetPrivate::ParametricRingRadius,
+                  current.ParametricRingRadius, last.ParametricRingRadius, force);
+  d->updateSlider(d->parametricCrossSectionRadiusSliderWidget, qMRMLMarkupsShapeWidgetPrivate::ParametricCrossSectionRadius,
+                  current.ParametricCrossSectionRadius, last.ParametricCrossSectionRadius, force);
+
   // UVW parameters.
-  // Set the range for the current shape, then the current values.
-  std::pair<double, double> parametricRangeU = d->MarkupsShapeNode->GetParametricRangeU();
-  d->parametricsURangeWidget->setMinimum(parametricRangeU.first);
-  d->parametricsURangeWidget->setMaximum(parametricRangeU.second);
-  d->parametricsURangeWidget->setMinimumValue(d->MarkupsShapeNode->GetParametricMinimumU());
-  d->parametricsURangeWidget->setMaximumValue(d->MarkupsShapeNode->GetParametricMaximumU());
-  
-  std::pair<double, double> parametricRangeV = d->MarkupsShapeNode->GetParametricRangeV();
-  d->parametricsVRangeWidget->setMinimum(parametricRangeV.first);
-  d->parametricsVRangeWidget->setMaximum(parametricRangeV.second);
-  d->parametricsVRangeWidget->setMinimumValue(d->MarkupsShapeNode->GetParametricMinimumV());
-  d->parametricsVRangeWidget->setMaximumValue(d->MarkupsShapeNode->GetParametricMaximumV());
-  
-  std::pair<double, double> parametricRangeW = d->MarkupsShapeNode->GetParametricRangeW();
-  d->parametricsWRangeWidget->setMinimum(parametricRangeW.first);
-  d->parametricsWRangeWidget->setMaximum(parametricRangeW.second);
-  d->parametricsWRangeWidget->setMinimumValue(d->MarkupsShapeNode->GetParametricMinimumW());
-  d->parametricsWRangeWidget->setMaximumValue(d->MarkupsShapeNode->GetParametricMaximumW());
-  
-  d->parametricsClockwiseOrderingToolButton->setChecked(d->MarkupsShapeNode->GetParametricClockwiseOrdering());
-  d->parametricsJoinUToolButton->setChecked(d->MarkupsShapeNode->GetParametricJoinU());
-  d->parametricsJoinVToolButton->setChecked(d->MarkupsShapeNode->GetParametricJoinV());
-  d->parametricsJoinWToolButton->setChecked(d->MarkupsShapeNode->GetParametricJoinW());
-  d->parametricsTwistUToolButton->setChecked(d->MarkupsShapeNode->GetParametricTwistU());
-  d->parametricsTwistVToolButton->setChecked(d->MarkupsShapeNode->GetParametricTwistV());
-  d->parametricsTwistWToolButton->setChecked(d->MarkupsShapeNode->GetParametricTwistW());
+  d->updateRangeWidget(d->parametricsURangeWidget,
+                       qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumU, qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumU,
+                       current.ParametricRangeU, current.ParametricMinimumU, current.ParametricMaximumU,
+                       last.ParametricRangeU, last.ParametricMinimumU, last.ParametricMaximumU, force);
+  d->updateRangeWidget(d->parametricsVRangeWidget,
+                       qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumV, qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumV,
+                       current.ParametricRangeV, current.ParametricMinimumV, current.ParametricMaximumV,
+                       last.ParametricRangeV, last.ParametricMinimumV, last.ParametricMaximumV, force);
+  d->updateRangeWidget(d->parametricsWRangeWidget,
+                       qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumW, qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumW,
+                       current.ParametricRangeW, current.ParametricMinimumW, current.ParametricMaximumW,
+                       last.ParametricRangeW, last.ParametricMinimumW, last.ParametricMaximumW, force);
+
+  d->updateToolButton(d->parametricsClockwiseOrderingToolButton,
+                      current.ParametricClockwiseOrdering, last.ParametricClockwiseOrdering, force);
+  d->updateToolButton(d->parametricsJoinUToolButton, current.ParametricJoinU, last.ParametricJoinU, force);
+  d->updateToolButton(d->parametricsJoinVToolButton, current.ParametricJoinV, last.ParametricJoinV, force);
+  d->updateToolButton(d->parametricsJoinWToolButton, current.ParametricJoinW, last.ParametricJoinW, force);
+  d->updateToolButton(d->parametricsTwistUToolButton, current.ParametricTwistU, last.ParametricTwistU, force);
+  d->updateToolButton(d->parametricsTwistVToolButton, current.ParametricTwistV, last.ParametricTwistV, force);
+  d->updateToolButton(d->parametricsTwistWToolButton, current.ParametricTwistW, last.ParametricTwistW, force);
 }
 
-
 //-----------------------------------------------------------------------------
 bool qMRMLMarkupsShapeWidget::canManageMRMLMarkupsNode(vtkMRMLMarkupsNode *markupsNode) const
 {
@@ -312,7 +688,10 @@ void qMRMLMarkupsShapeWidget::setMRMLMarkupsNode(vtkMRMLMarkupsNode* markupsNode
 {
   Q_D(qMRMLMarkupsShapeWidget);
 
+  // Pending values belong to the previous node.
+  this->applyPendingParameters();
   d->MarkupsShapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(markupsNode);
+  d->SnapshotValid = false;
   this->setEnabled(markupsNode != nullptr);
   if (d->MarkupsShapeNode)
   {
@@ -334,7 +713,22 @@ void qMRMLMarkupsShapeWidget::onShapeChanged(int shapeName)
     shapeName = vtkMRMLMarkupsShapeNode::Sphere;
   }
 
+  // Flush first, the new shape then applies its default parametrics.
+  this->applyPendingParameters();
   d->MarkupsShapeNode->SetShapeName(shapeName);
+  this->updateShapeControlsVisibility();
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidget::updateShapeControlsVisibility()
+{
+  Q_D(qMRMLMarkupsShapeWidget);
+
+  if (!d->MarkupsShapeNode)
+  {
+    return;
+  }
+  const int shapeName = d->MarkupsShapeNode->GetShapeName();
   
   d->radiusModeLabel->setVisible(shapeName != vtkMRMLMarkupsShapeNode::Disk
                                 && shapeName != vtkMRMLMarkupsShapeNode::Tube
@@ -410,7 +804,7 @@ void qMRMLMarkupsShapeWidget::onResolutionChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetResolution(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::Resolution, value);
 }
 
 // --------------------------------------------------------------------------
@@ -470,6 +864,7 @@ void qMRMLMarkupsShapeWidget::onParametricIsotropicScalingButtonClicked()
   {
     return;
   }
+  this->applyPendingParameters();
   d->MarkupsShapeNode->SetParametricXYZToActiveControlPoint();
 }
 
@@ -482,7 +877,7 @@ void qMRMLMarkupsShapeWidget::onParametricNSliderChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricN(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricN, value);
 }
 
 // --------------------------------------------------------------------------
@@ -494,7 +889,7 @@ void qMRMLMarkupsShapeWidget::onParametricN1SliderChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricN1(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricN1, value);
 }
 
 // --------------------------------------------------------------------------
@@ -506,7 +901,7 @@ void qMRMLMarkupsShapeWidget::onParametricN2SliderChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricN2(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricN2, value);
 }
 
 // --------------------------------------------------------------------------
@@ -518,7 +913,7 @@ void qMRMLMarkupsShapeWidget::onParametricRadiusSliderChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricRadius(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricRadius, value);
 }
 
 // --------------------------------------------------------------------------
@@ -530,7 +925,7 @@ void qMRMLMarkupsShapeWidget::onParametricRingRadiusSliderChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricRingRadius(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricRingRadius, value);
 }
 
 // --------------------------------------------------------------------------
@@ -542,7 +937,7 @@ void qMRMLMarkupsShapeWidget::onParametricCrossSectionRadiusSliderChanged(double
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricCrossSectionRadius(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricCrossSectionRadius, value);
 }
 
 // --------------------------------------------------------------------------
@@ -567,7 +962,7 @@ void qMRMLMarkupsShapeWidget::onParametricsMinimumURangeChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricMinimumU(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumU, value);
 }
 
 // --------------------------------------------------------------------------
@@ -579,7 +974,7 @@ void qMRMLMarkupsShapeWidget::onParametricsMaximumURangeChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricMaximumU(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumU, value);
 }
 
 // --------------------------------------------------------------------------
@@ -591,7 +986,7 @@ void qMRMLMarkupsShapeWidget::onParametricsMinimumVRangeChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricMinimumV(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumV, value);
 }
 
 // --------------------------------------------------------------------------
@@ -603,7 +998,7 @@ void qMRMLMarkupsShapeWidget::onParametricsMaximumVRangeChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricMaximumV(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumV, value);
 }
 
 // --------------------------------------------------------------------------
@@ -615,7 +1010,7 @@ void qMRMLMarkupsShapeWidget::onParametricsMinimumWRangeChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricMinimumW(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricMinimumW, value);
 }
 
 // --------------------------------------------------------------------------
@@ -627,7 +1022,7 @@ void qMRMLMarkupsShapeWidget::onParametricsMaximumWRangeChanged(double value)
   {
     return;
   }
-  d->MarkupsShapeNode->SetParametricMaximumW(value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::ParametricMaximumW, value);
 }
 
 // --------------------------------------------------------------------------
@@ -766,6 +1161,36 @@ void qMRMLMarkupsShapeWidget::onTubeMenuOptionButtonClicked()
   splineResolutionMenu->addAction(splineResolutionWidgetAction);
   d->TubeOptionMenu->addMenu(splineResolutionMenu);
 
+  QMenu* splineToleranceMenu = new QMenu("Spline tolerance", d->tubeMenuOptionButton);
+  splineToleranceMenu->setObjectName("SplineToleranceMenu");
+  ctkSliderWidget * splineToleranceSlider = new ctkSliderWidget(splineToleranceMenu);
+  splineToleranceSlider->setDecimals(2);
+  splineToleranceSlider->setRange(d->MarkupsShapeNode->GetSplineToleranceMinValue(),
+                                  d->MarkupsShapeNode->GetSplineToleranceMaxValue());
+  splineToleranceSlider->setSingleStep(0.05);
+  splineToleranceSlider->setSuffix(" mm");
+  splineToleranceSlider->setToolTip("Spline points closer than this to a straight, constant radius segment are not used to build the tube. 0 uses all points.");
+  splineToleranceSlider->setValue(d->MarkupsShapeNode->GetSplineTolerance());
+  QWidgetAction * splineToleranceWidgetAction = new QWidgetAction(splineToleranceMenu);
+  splineToleranceWidgetAction->setDefaultWidget(splineToleranceSlider);
+  splineToleranceMenu->addAction(splineToleranceWidgetAction);
+  d->TubeOptionMenu->addMenu(splineToleranceMenu);
+
+  QMenu* tubeChordErrorMenu = new QMenu("Tube chord error", d->tubeMenuOptionButton);
+  tubeChordErrorMenu->setObjectName("TubeChordErrorMenu");
+  ctkSliderWidget * tubeChordErrorSlider = new ctkSliderWidget(tubeChordErrorMenu);
+  tubeChordErrorSlider->setDecimals(2);
+  tubeChordErrorSlider->setRange(d->MarkupsShapeNode->GetTubeChordErrorMinValue(),
+                                 d->MarkupsShapeNode->GetTubeChordErrorMaxValue());
+  tubeChordErrorSlider->setSingleStep(0.01);
+  tubeChordErrorSlider->setSuffix(" mm");
+  tubeChordErrorSlider->setToolTip("Narrow sections of the tube get fewer sides, keeping facets within this distance of the true surface. 0 uses the resolution everywhere.");
+  tubeChordErrorSlider->setValue(d->MarkupsShapeNode->GetTubeChordError());
+  QWidgetAction * tubeChordErrorWidgetAction = new QWidgetAction(tubeChordErrorMenu);
+  tubeChordErrorWidgetAction->setDefaultWidget(tubeChordErrorSlider);
+  tubeChordErrorMenu->addAction(tubeChordErrorWidgetAction);
+  d->TubeOptionMenu->addMenu(tubeChordErrorMenu);
+
   QAction * actionSnapControlPointsOnTube = d->TubeOptionMenu->addAction("Snap control points on the tube");
 
   actionSnapControlPointsOnTube->setData(d->ActionSnapControlPoints);
@@ -782,6 +1207,16 @@ void qMRMLMarkupsShapeWidget::onTubeMenuOptionButtonClicked()
                    this, SLOT(onSnapControlPoints()));
   QObject::connect(splineResolutionSlider, SIGNAL(valueChanged(double)),
                    this, SLOT(onSplineResolutionChanged(double)));
+  QObject::connect(splineResolutionSlider->slider(), SIGNAL(sliderReleased()),
+                   this, SLOT(applyPendingParameters()));
+  QObject::connect(splineToleranceSlider, SIGNAL(valueChanged(double)),
+                   this, SLOT(onSplineToleranceChanged(double)));
+  QObject::connect(splineToleranceSlider->slider(), SIGNAL(sliderReleased()),
+                   this, SLOT(applyPendingParameters()));
+  QObject::connect(tubeChordErrorSlider, SIGNAL(valueChanged(double)),
+                   this, SLOT(onTubeChordErrorChanged(double)));
+  QObject::connect(tubeChordErrorSlider->slider(), SIGNAL(sliderReleased()),
+                   this, SLOT(applyPendingParameters()));
 
   d->tubeMenuOptionButton->showMenu();
 }
@@ -831,5 +1266,29 @@ void qMRMLMarkupsShapeWidget::onSplineResolutionChanged(double value)
     return;
   }
   
-  d->MarkupsShapeNode->SetSplineResolution((int) value);
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::SplineResolution, value);
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidget::onSplineToleranceChanged(double value)
+{
+  Q_D(qMRMLMarkupsShapeWidget);
+  if (!d->MarkupsShapeNode)
+  {
+    return;
+  }
+  
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::SplineTolerance, value);
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMarkupsShapeWidget::onTubeChordErrorChanged(double value)
+{
+  Q_D(qMRMLMarkupsShapeWidget);
+  if (!d->MarkupsShapeNode)
+  {
+    return;
+  }
+  
+  this->queueParameter(qMRMLMarkupsShapeWidgetPrivate::TubeChordError, value);
 }
@@ -36,6 +36,7 @@ qMRMLMarkupsShapeWidget : public qMRMLMarkupsAbstractOptionsWidget
   Q_OBJECT
 
   Q_PROPERTY(QString className READ className CONSTANT);
+  Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval);
 
 public:
 
@@ -56,6 +57,12 @@ public:
   qMRMLMarkupsAbstractOptionsWidget* createInstance() const override
   { return new qMRMLMarkupsShapeWidget(); }
 
+  /// Minimum time in milliseconds between two node updates while a slider
+  /// is being dragged. Intermediate values are dropped, the last one wins.
+  /// 0 updates the node on every value change.
+  int updateInterval() const;
+  void setUpdateInterval(int msec);
+
 public slots:
 /// Set the MRML node of interest
   void setMRMLMarkupsNode(vtkMRMLMarkupsNode* node) override;
@@ -75,6 +82,8 @@ protected slots:
   void onControlPointCountSpinBoxChanged(int value);
   void onSnapControlPoints();
   void onSplineResolutionChanged(double value);
+  void onSplineToleranceChanged(double value);
+  void onTubeChordErrorChanged(double value);
 
   // Parametric shapes.
   // Object parameters.
@@ -103,8 +112,14 @@ protected slots:
   void onParametricsTwistWToogled(bool value);
   void onParametricsClockwiseOrderingToogled(bool value);
 
+  /// Push the coalesced slider values to the node in a single update.
+  void applyPendingParameters();
+
 protected:
   void setup();
+  void queueParameter(int parameter, double value);
+  /// Show the controls relevant to the current shape and radius mode.
+  void updateShapeControlsVisibility();
 
 protected:
   QScopedPointer<qMRMLMarkupsShapeWidgetPrivate> d_ptr;
@@ -0,0 +1,389 @@
+/*==============================================================================
+
+  Copyright (c) The Intervention Centre
+  Oslo University Hospital, Oslo, Norway. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#include "ShapeMeasurementsCLP.h"
+
+// Shape includes
+#include <vtkMRMLMarkupsShapeJsonStorageNode.h>
+#include <vtkMRMLMarkupsShapeNode.h>
+#include <vtkMRMLMeasurementShape.h>
+#include <vtkSlicerShapeWidget.h>
+
+// MRML includes
+#include <vtkMRMLMarkupsDisplayNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkGenericOpenGLRenderWindow.h>
+#include <vtkNew.h>
+#include <vtkRenderer.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct MeasurementRecord
+{
+  std::string Name;
+  double Value = 0.0;
+  std::string Units;
+};
+
+// One Shape markup of a file.
+struct FileRecord
+{
+  std::string FileName;
+  int MarkupIndex = 0;
+  std::string NodeName;
+  std::string ShapeName;
+  std::string Error;
+  std::vector<MeasurementRecord> Measurements;
+};
+
+//----------------------------------------------------------------------------
+std::string ToString(const char* text)
+{
+  return text ? std::string(text) : std::string();
+}
+
+//----------------------------------------------------------------------------
+std::string ToString(const std::string& text)
+{
+  return text;
+}
+
+//----------------------------------------------------------------------------
+std::string EscapeCsv(const std::string& text)
+{
+  if (text.find_first_of(",\"\n") == std::string::npos)
+  {
+    return text;
+  }
+  std::string escaped = "\"";
+  for (char c : text)
+  {
+    escaped += c;
+    if (c == '"')
+    {
+      escaped += '"';
+    }
+  }
+  return escaped + "\"";
+}
+
+//----------------------------------------------------------------------------
+std::string EscapeJson(const std::string& text)
+{
+  std::string escaped;
+  for (char c : text)
+  {
+    switch (c)
+    {
+      case '"': escaped += "\\\""; break;
+      case '\\': escaped += "\\\\"; break;
+      case '\n': escaped += "\\n"; break;
+      case '\t': escaped += "\\t"; break;
+      default: escaped += c;
+    }
+  }
+  return escaped;
+}
+
+//----------------------------------------------------------------------------
+// One record per Shape markup of each file; other markups are ignored.
+std::vector<FileRecord> ListMarkups(const std::vector<std::string>& fileNames)
+{
+  std::vector<FileRecord> records;
+  vtkNew<vtkMRMLMarkupsShapeJsonStorageNode> storageNode;
+  for (const std::string& fileName : fileNames)
+  {
+    std::vector<std::string> markupsTypes;
+    storageNode->GetMarkupsTypesInFile(fileName.c_str(), markupsTypes);
+    FileRecord record;
+    record.FileName = fileName;
+    const size_t numberOfRecords = records.size();
+    for (size_t i = 0; i < markupsTypes.size(); i++)
+    {
+      if (markupsTypes[i] == "Shape")
+      {
+        record.MarkupIndex = static_cast<int>(i);
+        records.push_back(record);
+      }
+    }
+    if (records.size() == numberOfRecords)
+    {
+      record.Error = markupsTypes.empty() ? "cannot read file" : "no Shape markup in file";
+      records.push_back(record);
+    }
+  }
+  return records;
+}
+
+//----------------------------------------------------------------------------
+/*
+ * Load a batch of markups in a single scene and generate their geometry through
+ * the shape widget representation, without a render window being shown.
+ * MRML events are not thread safe : this is done serially. Only the
+ * measurements are then computed in parallel.
+ */
+void MeasureBatch(std::vector<FileRecord>& records, bool allMeasurements)
+{
+  vtkNew<vtkMRMLScene> scene;
+  // Markups are added by class from their type.
+  scene->RegisterNodeClass(vtkNew<vtkMRMLMarkupsShapeNode>());
+  scene->RegisterNodeClass(vtkNew<vtkMRMLMarkupsDisplayNode>());
+  scene->RegisterNodeClass(vtkNew<vtkMRMLMarkupsShapeJsonStorageNode>());
+  // A single 3D view : every representation is in the first view and sets the world geometry.
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode);
+  vtkNew<vtkGenericOpenGLRenderWindow> renderWindow;
+  vtkNew<vtkRenderer> renderer;
+  renderWindow->AddRenderer(renderer);
+
+  std::vector<vtkMRMLMarkupsShapeNode*> shapeNodes(records.size(), nullptr);
+  std::vector<vtkMRMLMeasurementShape::Input> inputs(records.size());
+  std::vector<vtkSmartPointer<vtkSlicerShapeWidget>> widgets;
+  for (size_t n = 0; n < records.size(); n++)
+  {
+    FileRecord& record = records[n];
+    if (!record.Error.empty())
+    {
+      continue;
+    }
+    vtkNew<vtkMRMLMarkupsShapeJsonStorageNode> storageNode;
+    scene->AddNode(storageNode);
+    vtkMRMLMarkupsShapeNode * shapeNode = vtkMRMLMarkupsShapeNode::SafeDownCast(
+      storageNode->AddNewMarkupsNodeFromFile(record.FileName.c_str(), nullptr, record.MarkupIndex));
+    if (!shapeNode)
+    {
+      record.Error = "cannot read markup " + std::to_string(record.MarkupIndex);
+      continue;
+    }
+    if (!shapeNode->GetDisplayNode())
+    {
+      shapeNode->CreateDefaultDisplayNodes();
+    }
+    vtkMRMLMarkupsDisplayNode * displayNode = vtkMRMLMarkupsDisplayNode::SafeDownCast(shapeNode->GetDisplayNode());
+    if (!displayNode)
+    {
+      record.Error = "cannot display markup " + std::to_string(record.MarkupIndex);
+      continue;
+    }
+    record.NodeName = ToString(shapeNode->GetName());
+    record.ShapeName = ToString(vtkMRMLMarkupsShapeNode::GetShapeNameAsString(shapeNode->GetShapeName()));
+
+    vtkSmartPointer<vtkSlicerShapeWidget> widget = vtkSmartPointer<vtkSlicerShapeWidget>::New();
+    widget->CreateDefaultRepresentation(displayNode, viewNode, renderer);
+    widgets.push_back(widget);
+
+    bool readsGeometry = false;
+    for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+    {
+      vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+      if (!measurement)
+      {
+        continue;
+      }
+      if (allMeasurements)
+      {
+        measurement->SetEnabled(true);
+      }
+      readsGeometry = readsGeometry || (measurement->GetEnabled() && measurement->ReadsGeometry());
+    }
+    // Cached world positions and generated geometry are not thread safe : the workers read copies.
+    inputs[n] = vtkMRMLMeasurementShape::CopyInput(shapeNode, readsGeometry);
+    shapeNodes[n] = shapeNode;
+  }
+
+  vtkSMPTools::For(0, static_cast<vtkIdType>(shapeNodes.size()),
+    [&shapeNodes, &inputs](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType n = begin; n < end; n++)
+      {
+        vtkMRMLMarkupsShapeNode * shapeNode = shapeNodes[n];
+        if (!shapeNode)
+        {
+          continue;
+        }
+        for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+        {
+          vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+          if (measurement && measurement->GetEnabled())
+          {
+            measurement->ComputeDeferred(inputs[n]);
+          }
+        }
+      }
+    });
+
+  for (size_t n = 0; n < records.size(); n++)
+  {
+    vtkMRMLMarkupsShapeNode * shapeNode = shapeNodes[n];
+    if (!shapeNode)
+    {
+      continue;
+    }
+    for (int i = 0; i < shapeNode->GetNumberOfMeasurements(); i++)
+    {
+      vtkMRMLMeasurementShape * measurement = vtkMRMLMeasurementShape::SafeDownCast(shapeNode->GetNthMeasurement(i));
+      if (!measurement || !measurement->GetEnabled())
+      {
+        continue;
+      }
+      measurement->PublishValue();
+      MeasurementRecord measurementRecord;
+      measurementRecord.Name = ToString(measurement->GetName());
+      measurementRecord.Value = measurement->GetValue();
+      measurementRecord.Units = ToString(measurement->GetUnits());
+      records[n].Measurements.push_back(measurementRecord);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void WriteCsv(std::ostream& stream, const std::vector<FileRecord>& records)
+{
+  stream << "file,node,shape,measurement,value,units,error\n";
+  for (const FileRecord& record : records)
+  {
+    const std::string prefix = EscapeCsv(record.FileName) + ","
+      + EscapeCsv(record.NodeName) + "," + EscapeCsv(record.ShapeName) + ",";
+    if (!record.Error.empty())
+    {
+      stream << prefix << ",,," << EscapeCsv(record.Error) << "\n";
+      continue;
+    }
+    for (const MeasurementRecord& measurement : record.Measurements)
+    {
+      stream << prefix << EscapeCsv(measurement.Name) << "," << measurement.Value
+        << "," << EscapeCsv(measurement.Units) << ",\n";
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void WriteJson(std::ostream& stream, const std::vector<FileRecord>& records)
+{
+  stream << "[\n";
+  for (size_t n = 0; n < records.size(); n++)
+  {
+    const FileRecord& record = records[n];
+    stream << "  {\"file\": \"" << EscapeJson(record.FileName)
+      << "\", \"node\": \"" << EscapeJson(record.NodeName)
+      << "\", \"shape\": \"" << EscapeJson(record.ShapeName) << "\"";
+    if (!record.Error.empty())
+    {
+      stream << ", \"error\": \"" << EscapeJson(record.Error) << "\"";
+    }
+    stream << ", \"measurements\": [";
+    for (size_t i = 0; i < record.Measurements.size(); i++)
+    {
+      const MeasurementRecord& measurement = record.Measurements[i];
+      stream << (i ? ", " : "") << "{\"name\": \"" << EscapeJson(measurement.Name) << "\", \"value\": ";
+      // JSON has no NaN nor infinity.
+      if (std::isfinite(measurement.Value))
+      {
+        stream << measurement.Value;
+      }
+      else
+      {
+        stream << "null";
+      }
+      stream << ", \"units\": \"" << EscapeJson(measurement.Units) << "\"}";
+    }
+    stream << "]}" << (n + 1 < records.size() ? "," : "") << "\n";
+  }
+  stream << "]\n";
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+  PARSE_ARGS;
+
+  if (inputFiles.empty())
+  {
+    std::cerr << "No input file." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (numberOfThreads > 0)
+  {
+    vtkSMPTools::Initialize(numberOfThreads);
+  }
+
+  const double startTime = vtkTimerLog::GetUniversalTime();
+  std::vector<FileRecord> records = ListMarkups(inputFiles);
+  const size_t step = static_cast<size_t>(std::max(batchSize, 1));
+  for (size_t first = 0; first < records.size(); first += step)
+  {
+    const size_t last = std::min(first + step, records.size());
+    std::vector<FileRecord> batch(records.begin() + first, records.begin() + last);
+    MeasureBatch(batch, allMeasurements);
+    std::move(batch.begin(), batch.end(), records.begin() + first);
+  }
+  const double elapsed = vtkTimerLog::GetUniversalTime() - startTime;
+
+  std::ofstream file;
+  if (!outputFile.empty())
+  {
+    file.open(outputFile.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "Cannot write " << outputFile << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::ostream& stream = outputFile.empty() ? std::cout : file;
+  stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+  if (outputFormat == "json")
+  {
+    WriteJson(stream, records);
+  }
+  else
+  {
+    WriteCsv(stream, records);
+  }
+
+  const size_t failed = std::count_if(records.begin(), records.end(),
+    [](const FileRecord& record) { return !record.Error.empty(); });
+  // Keep the standard output for the measurements if no output file is given.
+  std::ostream& report = outputFile.empty() ? std::cerr : std::cout;
+  report << "Measured " << records.size() - failed << " of " << records.size()
+    << " markups of " << inputFiles.size() << " files in " << elapsed << " s ("
+    << (elapsed > 0.0 ? records.size() / elapsed : 0.0) << " markups/s, "
+    << vtkSMPTools::GetEstimatedNumberOfThreads() << " threads)." << std::endl;
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}